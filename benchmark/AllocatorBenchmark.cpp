@@ -0,0 +1,94 @@
+/*
+Title: Vector Mathematics
+File Name: AllocatorBenchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <vector>
+
+#include "../header/MemoryResource.h"
+
+// Sizes of the temporary buffers a typical frame creates, in vectors.
+static const size_t FRAME_BUFFER_SIZES[] = { 16, 100, 1000, 4096, 20000, 64, 250, 8 };
+static const size_t BUFFERS_PER_FRAME = 64;
+
+// The cost of one allocate/free pair at our frame sizes: malloc through std::vector against the
+//  pool and the arena through std::pmr. Each buffer is written once so its memory is really used.
+// Times are per allocation; there is no bandwidth to report.
+void BenchAllocators(const BenchmarkOptions& options)
+{
+	const size_t sizeCount = sizeof(FRAME_BUFFER_SIZES) / sizeof(FRAME_BUFFER_SIZES[0]);
+	size_t frames = options.count / 1024 > 0 ? options.count / 1024 : 1;
+	size_t allocations = frames * BUFFERS_PER_FRAME;
+	float sink = 0.0f;
+
+	double t = BestTime(options.repeats, [&]
+	{
+		for (size_t f = 0; f < frames; f++)
+		{
+			std::vector<std::vector<Vector3D>> buffers(BUFFERS_PER_FRAME);
+			for (size_t b = 0; b < BUFFERS_PER_FRAME; b++)
+			{
+				buffers[b].reserve(FRAME_BUFFER_SIZES[b % sizeCount]);
+				buffers[b].push_back(Vector3D(1, 2, 3));
+				sink += buffers[b][0].x;
+			}
+		}
+	});
+	Report("malloc", allocations, 0, t);
+
+	for (int huge = 0; huge < 2; huge++)
+	{
+		SizeClassPool pool(1 << 20, huge != 0);
+		t = BestTime(options.repeats, [&]
+		{
+			for (size_t f = 0; f < frames; f++)
+			{
+				std::pmr::vector<VectorBuffer3D> buffers(BUFFERS_PER_FRAME, &pool);
+				for (size_t b = 0; b < BUFFERS_PER_FRAME; b++)
+				{
+					buffers[b].reserve(FRAME_BUFFER_SIZES[b % sizeCount]);
+					buffers[b].push_back(Vector3D(1, 2, 3));
+					sink += buffers[b][0].x;
+				}
+			}
+		});
+		Report(huge ? "size-class pool, huge pages" : "size-class pool", allocations, 0, t);
+
+		FrameArena arena(4 << 20, huge != 0);
+		t = BestTime(options.repeats, [&]
+		{
+			for (size_t f = 0; f < frames; f++)
+			{
+				{
+					std::pmr::vector<VectorBuffer3D> buffers(BUFFERS_PER_FRAME, &arena);
+					for (size_t b = 0; b < BUFFERS_PER_FRAME; b++)
+					{
+						buffers[b].reserve(FRAME_BUFFER_SIZES[b % sizeCount]);
+						buffers[b].push_back(Vector3D(1, 2, 3));
+						sink += buffers[b][0].x;
+					}
+				}
+				arena.Reset();
+			}
+		});
+		Report(huge ? "frame arena, huge pages" : "frame arena", allocations, 0, t);
+	}
+	DoNotOptimize(&sink);
+}
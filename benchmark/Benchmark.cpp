@@ -0,0 +1,155 @@
+/*
+Title: Vector Mathematics
+File Name: Benchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+struct BenchmarkEntry
+{
+	const char* name;
+	void (*run)(const BenchmarkOptions&);
+};
+
+static const BenchmarkEntry BENCHMARKS[] =
+{
+	{ "half", BenchHalf },
+	{ "fixed", BenchFixed },
+	{ "ring", BenchRing },
+	{ "pipeline", BenchPipeline },
+	{ "stream", BenchStream },
+	{ "bulkio", BenchBulkIO },
+	{ "alloc", BenchAllocators },
+	{ "numa", BenchNuma },
+	{ "hugepages", BenchHugePages },
+	{ "counters", BenchCounters },
+	{ "latency", BenchLatency },
+	{ "scalar", BenchScalar },
+};
+
+static const char* currentBenchmark = "";
+static std::vector<double> samples;
+static std::vector<BenchmarkResult> results;
+
+void RecordSample(double seconds)
+{
+	samples.push_back(seconds);
+}
+
+void Report(const char* name, size_t count, size_t bytesPerVector, double seconds)
+{
+	BenchmarkResult result;
+	result.benchmark = currentBenchmark;
+	result.name = name;
+	result.count = count;
+	result.seconds = samples.empty() ? std::vector<double>(1, seconds) : samples;
+	results.push_back(result);
+	samples.clear();
+
+	double ns = seconds * 1e9 / static_cast<double>(count);
+	double gbs = static_cast<double>(count) * bytesPerVector / seconds / 1e9;
+	printf("%-32s %9.3f ms %8.3f ns/vector %8.2f GB/s\n", name, seconds * 1e3, ns, gbs);
+}
+
+void DoNotOptimize(const void* p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	// Tells the compiler p, and all memory, may be read here.
+	asm volatile("" : : "g"(p) : "memory");
+#else
+	static const void* volatile sink;
+	sink = p;
+#endif
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+	options.count = 1 << 23;
+	options.repeats = 5;
+
+	const char* filter = nullptr;
+	const char* savePath = nullptr;
+	const char* comparePaths[2] = { nullptr, nullptr };
+	double threshold = 0.02;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+		{
+			options.count = static_cast<size_t>(strtoull(argv[++i], nullptr, 10));
+		}
+		else if (strcmp(argv[i], "--repeats") == 0 && i + 1 < argc)
+		{
+			options.repeats = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc)
+		{
+			savePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--compare") == 0 && i + 2 < argc)
+		{
+			comparePaths[0] = argv[++i];
+			comparePaths[1] = argv[++i];
+		}
+		else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+		{
+			threshold = atof(argv[++i]) / 100.0;
+		}
+		else if (argv[i][0] != '-')
+		{
+			filter = argv[i];
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [--count N] [--repeats R] [--save PATH] [benchmark]\n"
+				"       %s --compare BASE NEW [--threshold PERCENT]\n", argv[0], argv[0]);
+			return 1;
+		}
+	}
+	// Exits with 1 if anything got slower, so it can gate a change.
+	if (comparePaths[0])
+	{
+		int regressions = CompareBenchmarkResults(comparePaths[0], comparePaths[1], threshold);
+		return regressions == 0 ? 0 : 1;
+	}
+	if (options.count == 0 || options.repeats <= 0)
+	{
+		fprintf(stderr, "count and repeats must be positive\n");
+		return 1;
+	}
+
+	for (const BenchmarkEntry& entry : BENCHMARKS)
+	{
+		if (!filter || strstr(entry.name, filter))
+		{
+			printf("== %s (%zu vectors, best of %d)\n", entry.name, options.count, options.repeats);
+			currentBenchmark = entry.name;
+			samples.clear();
+			entry.run(options);
+		}
+	}
+	if (savePath && !WriteBenchmarkResults(savePath, results))
+	{
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,103 @@
+/*
+Title: Vector Mathematics
+File Name: Benchmark.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Shared pieces of the benchmark program.
+// Each benchmark is a function that runs one family of kernels over large arrays and prints
+//  one line per kernel. Run the program with a name to run only the benchmarks containing it.
+
+struct BenchmarkOptions
+{
+	// Number of vectors per array. The default is large enough that arrays do not fit in cache.
+	size_t count;
+	// Each kernel is run this many times and the fastest run is reported.
+	int repeats;
+};
+
+// Every timed run of one kernel, as saved with --save and read back by --compare.
+struct BenchmarkResult
+{
+	// The benchmark's entry name, e.g. "fixed", and the kernel's Report name.
+	std::string benchmark;
+	std::string name;
+	size_t count;
+	std::vector<double> seconds;
+};
+
+// Adds one run's time to those the next Report saves. BestTime calls it for every run.
+void RecordSample(double seconds);
+
+inline double NowSeconds()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Runs f repeats times and returns the fastest time, in seconds.
+template <typename F>
+double BestTime(int repeats, F f)
+{
+	double best = 1e30;
+	for (int r = 0; r < repeats; r++)
+	{
+		double start = NowSeconds();
+		f();
+		double elapsed = NowSeconds() - start;
+		RecordSample(elapsed);
+		best = elapsed < best ? elapsed : best;
+	}
+	return best;
+}
+
+// Prints one result line: time per vector, and memory bandwidth given the bytes read and written per vector.
+// Also keeps the runs recorded since the last Report, or just seconds if there were none, for --save.
+void Report(const char* name, size_t count, size_t bytesPerVector, double seconds);
+
+// Result files are text: a header line, then one line per kernel holding the benchmark, name, count,
+//  and the seconds of every run, separated by tabs. Both return false, having printed why, on failure.
+bool WriteBenchmarkResults(const char* path, const std::vector<BenchmarkResult>& results);
+bool ReadBenchmarkResults(const char* path, std::vector<BenchmarkResult>& results);
+
+// Compares the kernels found in both files, matched by benchmark, name and count, and prints one line each.
+// A kernel has regressed if a Mann-Whitney U test finds the runs differ (p < 0.05) and the bootstrap
+//  95% interval of the change in median time lies wholly above threshold (0.02 for 2%).
+// Returns the number of regressions, or -1 if a file could not be read.
+int CompareBenchmarkResults(const char* basePath, const char* newPath, double threshold);
+
+// Keeps the compiler from optimizing away a result that is never otherwise used.
+void DoNotOptimize(const void* p);
+
+void BenchHalf(const BenchmarkOptions& options);
+void BenchFixed(const BenchmarkOptions& options);
+void BenchRing(const BenchmarkOptions& options);
+void BenchPipeline(const BenchmarkOptions& options);
+void BenchStream(const BenchmarkOptions& options);
+void BenchBulkIO(const BenchmarkOptions& options);
+void BenchAllocators(const BenchmarkOptions& options);
+void BenchNuma(const BenchmarkOptions& options);
+void BenchHugePages(const BenchmarkOptions& options);
+void BenchCounters(const BenchmarkOptions& options);
+void BenchLatency(const BenchmarkOptions& options);
+void BenchScalar(const BenchmarkOptions& options);
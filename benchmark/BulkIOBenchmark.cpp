@@ -0,0 +1,94 @@
+/*
+Title: Vector Mathematics
+File Name: BulkIOBenchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../header/BulkIO.h"
+#include "../header/VectorFile.h"
+
+// WriteVectorFile and a mapped VectorFile against the chunked io_uring and thread engines in BulkIO.h.
+// Reading sums every component, so each path has to touch all of the data.
+// O_DIRECT bypasses the page cache, while the buffered paths may be served from it.
+void BenchBulkIO(const BenchmarkOptions& options)
+{
+	std::string path = (std::filesystem::temp_directory_path() / "vector-bulk-bench.vecf").string();
+	std::vector<Vector3D> v(options.count);
+	for (size_t i = 0; i < options.count; i++)
+	{
+		float f = static_cast<float>(i);
+		v[i] = Vector3D(f, f * 0.5f, 1.0f);
+	}
+	size_t bytes = sizeof(Vector3D);
+
+	double t = BestTime(options.repeats, [&] { WriteVectorFile(path.c_str(), v.data(), v.size()); });
+	Report("write, stdio", options.count, bytes, t);
+
+	double sum = 0.0;
+	t = BestTime(options.repeats, [&]
+	{
+		VectorFile file;
+		file.Open(path.c_str());
+		const Vector3D* p = AsVector3D(file.view);
+		for (size_t i = 0; p != nullptr && i < file.view.count; i++)
+		{
+			sum += p[i].x + p[i].y + p[i].z;
+		}
+	});
+	Report("read, mapped", options.count, bytes, t);
+
+	BulkChunkFunction<Vector3D> consume = [&](const Vector3D* p, size_t, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			sum += p[i].x + p[i].y + p[i].z;
+		}
+	};
+	for (int engine = 0; engine < 2; engine++)
+	{
+		for (int direct = 1; direct >= 0; direct--)
+		{
+			BulkIOOptions bulk;
+			bulk.useIoUring = engine == 0;
+			bulk.direct = direct != 0;
+			BulkIOStats stats;
+			char label[64];
+
+			bool ok = true;
+			t = BestTime(options.repeats, [&] { ok = WriteVectorFileBulk(path.c_str(), v.data(), v.size(), bulk, &stats) && ok; });
+			snprintf(label, sizeof(label), "write, %s%s", stats.engine == BulkIOEngine::IoUring ? "io_uring" : "threads", stats.direct ? " direct" : "");
+			Report(label, options.count, bytes, t);
+
+			t = BestTime(options.repeats, [&] { ok = ReadVectorFileBulk(path.c_str(), consume, bulk, &stats) && ok; });
+			snprintf(label, sizeof(label), "read, %s%s", stats.engine == BulkIOEngine::IoUring ? "io_uring" : "threads", stats.direct ? " direct" : "");
+			Report(label, options.count, bytes, t);
+			if (!ok)
+			{
+				fprintf(stderr, "bulk I/O failed\n");
+			}
+		}
+	}
+	DoNotOptimize(&sum);
+	std::filesystem::remove(path);
+}
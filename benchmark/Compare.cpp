@@ -0,0 +1,320 @@
+/*
+Title: Vector Mathematics
+File Name: Compare.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+static const char* RESULTS_HEADER = "# math-vectors-introduction benchmark results 1";
+
+// Significance level of the Mann-Whitney test, and the number of bootstrap resamples.
+static const double ALPHA = 0.05;
+static const int BOOTSTRAP_RESAMPLES = 2000;
+
+// Above this many runs on either side, p is taken from the normal approximation rather than counted exactly.
+static const size_t EXACT_MAX_RUNS = 20;
+
+bool WriteBenchmarkResults(const char* path, const std::vector<BenchmarkResult>& results)
+{
+	FILE* out = fopen(path, "w");
+	if (!out)
+	{
+		fprintf(stderr, "could not create %s\n", path);
+		return false;
+	}
+	fprintf(out, "%s\n", RESULTS_HEADER);
+	for (const BenchmarkResult& r : results)
+	{
+		fprintf(out, "%s\t%s\t%zu\t", r.benchmark.c_str(), r.name.c_str(), r.count);
+		for (size_t i = 0; i < r.seconds.size(); i++)
+		{
+			fprintf(out, i == 0 ? "%.9g" : " %.9g", r.seconds[i]);
+		}
+		fprintf(out, "\n");
+	}
+	bool ok = !ferror(out);
+	ok = fclose(out) == 0 && ok;
+	if (!ok)
+	{
+		fprintf(stderr, "could not write %s\n", path);
+	}
+	return ok;
+}
+
+// Parses "benchmark<TAB>name<TAB>count<TAB>seconds seconds ...".
+static bool ParseResult(const std::string& line, BenchmarkResult& r)
+{
+	size_t tab1 = line.find('\t');
+	size_t tab2 = tab1 == std::string::npos ? tab1 : line.find('\t', tab1 + 1);
+	size_t tab3 = tab2 == std::string::npos ? tab2 : line.find('\t', tab2 + 1);
+	if (tab3 == std::string::npos)
+	{
+		return false;
+	}
+	r.benchmark = line.substr(0, tab1);
+	r.name = line.substr(tab1 + 1, tab2 - tab1 - 1);
+	char* end;
+	r.count = static_cast<size_t>(strtoull(line.c_str() + tab2 + 1, &end, 10));
+	if (end != line.c_str() + tab3)
+	{
+		return false;
+	}
+	r.seconds.clear();
+	const char* p = line.c_str() + tab3 + 1;
+	for (;;)
+	{
+		double s = strtod(p, &end);
+		if (end == p)
+		{
+			break;
+		}
+		r.seconds.push_back(s);
+		p = end;
+	}
+	return *p == '\0' && !r.seconds.empty();
+}
+
+static bool SameKernel(const BenchmarkResult& a, const BenchmarkResult& b)
+{
+	return a.benchmark == b.benchmark && a.name == b.name && a.count == b.count;
+}
+
+bool ReadBenchmarkResults(const char* path, std::vector<BenchmarkResult>& results)
+{
+	results.clear();
+	FILE* in = fopen(path, "r");
+	if (!in)
+	{
+		fprintf(stderr, "could not open %s\n", path);
+		return false;
+	}
+	std::string text;
+	char buffer[4096];
+	size_t n;
+	while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+	{
+		text.append(buffer, n);
+	}
+	fclose(in);
+
+	size_t lineNumber = 0;
+	for (size_t begin = 0; begin < text.size(); lineNumber++)
+	{
+		size_t end = text.find('\n', begin);
+		end = end == std::string::npos ? text.size() : end;
+		std::string line = text.substr(begin, end - begin);
+		begin = end + 1;
+		if (lineNumber == 0)
+		{
+			if (line != RESULTS_HEADER)
+			{
+				fprintf(stderr, "%s is not a benchmark results file\n", path);
+				return false;
+			}
+			continue;
+		}
+		BenchmarkResult r;
+		if (!ParseResult(line, r))
+		{
+			fprintf(stderr, "%s:%zu: malformed result\n", path, lineNumber + 1);
+			return false;
+		}
+		// Compare pairs each kernel with the one base run of the same key, so keys must be unique.
+		if (std::find_if(results.begin(), results.end(), [&](const BenchmarkResult& b) { return SameKernel(b, r); }) != results.end())
+		{
+			fprintf(stderr, "%s:%zu: duplicate result for %s/%s\n", path, lineNumber + 1, r.benchmark.c_str(), r.name.c_str());
+			return false;
+		}
+		results.push_back(r);
+	}
+	if (lineNumber == 0)
+	{
+		fprintf(stderr, "%s is not a benchmark results file\n", path);
+		return false;
+	}
+	return true;
+}
+
+static double Median(std::vector<double> v)
+{
+	std::sort(v.begin(), v.end());
+	size_t n = v.size();
+	return n % 2 == 1 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+// Two-sided p-value of the Mann-Whitney U test that a and b come from the same distribution.
+// Without ties and with few runs the distribution of U is counted exactly; otherwise it is
+//  approximated by a normal distribution, corrected for ties and continuity.
+static double MannWhitneyP(const std::vector<double>& a, const std::vector<double>& b)
+{
+	size_t n1 = a.size();
+	size_t n2 = b.size();
+
+	// U counts the pairs in which a's value is the larger, ties counting half.
+	double u = 0.0;
+	for (double x : a)
+	{
+		for (double y : b)
+		{
+			u += x > y ? 1.0 : x == y ? 0.5 : 0.0;
+		}
+	}
+
+	std::vector<double> all(a);
+	all.insert(all.end(), b.begin(), b.end());
+	std::sort(all.begin(), all.end());
+	double tieTerm = 0.0;
+	for (size_t i = 0; i < all.size();)
+	{
+		size_t j = i;
+		while (j < all.size() && all[j] == all[i])
+		{
+			j++;
+		}
+		double t = static_cast<double>(j - i);
+		tieTerm += t * t * t - t;
+		i = j;
+	}
+
+	if (tieTerm == 0.0 && n1 <= EXACT_MAX_RUNS && n2 <= EXACT_MAX_RUNS)
+	{
+		// ways[i][j][k]: orderings of i values from a and j from b in which U = k.
+		std::vector<std::vector<std::vector<double>>> ways(n1 + 1, std::vector<std::vector<double>>(n2 + 1));
+		for (size_t i = 0; i <= n1; i++)
+		{
+			for (size_t j = 0; j <= n2; j++)
+			{
+				std::vector<double>& w = ways[i][j];
+				w.assign(i * j + 1, 0.0);
+				if (i == 0 || j == 0)
+				{
+					w[0] = 1.0;
+					continue;
+				}
+				// The largest value comes either from a, beating all j of b's, or from b.
+				for (size_t k = 0; k <= i * j; k++)
+				{
+					w[k] = (k >= j ? ways[i - 1][j][k - j] : 0.0) + (k <= i * (j - 1) ? ways[i][j - 1][k] : 0.0);
+				}
+			}
+		}
+		const std::vector<double>& w = ways[n1][n2];
+		double total = 0.0, below = 0.0, above = 0.0;
+		size_t observed = static_cast<size_t>(u);
+		for (size_t k = 0; k < w.size(); k++)
+		{
+			total += w[k];
+			below += k <= observed ? w[k] : 0.0;
+			above += k >= observed ? w[k] : 0.0;
+		}
+		return std::min(1.0, 2.0 * std::min(below, above) / total);
+	}
+
+	double n = static_cast<double>(n1 + n2);
+	double mean = 0.5 * n1 * n2;
+	double variance = n1 * n2 / 12.0 * ((n + 1.0) - tieTerm / (n * (n - 1.0)));
+	if (variance <= 0.0)
+	{
+		return 1.0;
+	}
+	double z = std::max(0.0, std::fabs(u - mean) - 0.5) / std::sqrt(variance);
+	return std::erfc(z / std::sqrt(2.0));
+}
+
+// 95% bootstrap interval of median(b) / median(a) - 1, resampling both sets of runs.
+// The generator is seeded the same every time so that a comparison always prints the same thing.
+static void BootstrapChange(const std::vector<double>& a, const std::vector<double>& b, double& low, double& high)
+{
+	std::mt19937 random(12345);
+	std::uniform_int_distribution<size_t> pickA(0, a.size() - 1);
+	std::uniform_int_distribution<size_t> pickB(0, b.size() - 1);
+	std::vector<double> resampleA(a.size());
+	std::vector<double> resampleB(b.size());
+	std::vector<double> changes(BOOTSTRAP_RESAMPLES);
+	for (double& change : changes)
+	{
+		for (double& x : resampleA)
+		{
+			x = a[pickA(random)];
+		}
+		for (double& x : resampleB)
+		{
+			x = b[pickB(random)];
+		}
+		change = Median(resampleB) / Median(resampleA) - 1.0;
+	}
+	std::sort(changes.begin(), changes.end());
+	low = changes[static_cast<size_t>(0.025 * BOOTSTRAP_RESAMPLES)];
+	high = changes[static_cast<size_t>(0.975 * BOOTSTRAP_RESAMPLES) - 1];
+}
+
+int CompareBenchmarkResults(const char* basePath, const char* newPath, double threshold)
+{
+	std::vector<BenchmarkResult> base, current;
+	if (!ReadBenchmarkResults(basePath, base) || !ReadBenchmarkResults(newPath, current))
+	{
+		return -1;
+	}
+
+	int regressions = 0;
+	printf("%-44s %10s %10s %10s %8s %20s %8s\n", "kernel", "count", "base ms", "new ms", "change", "95% interval", "p");
+	for (const BenchmarkResult& r : current)
+	{
+		std::string label = r.benchmark + "/" + r.name;
+		auto match = std::find_if(base.begin(), base.end(), [&](const BenchmarkResult& b) { return SameKernel(b, r); });
+		if (match == base.end())
+		{
+			printf("%-44s %10zu  only in %s\n", label.c_str(), r.count, newPath);
+			continue;
+		}
+		double baseMedian = Median(match->seconds);
+		double newMedian = Median(r.seconds);
+		double low, high;
+		BootstrapChange(match->seconds, r.seconds, low, high);
+		double p = MannWhitneyP(r.seconds, match->seconds);
+
+		const char* verdict = "";
+		if (p < ALPHA && low > threshold)
+		{
+			verdict = "  SLOWER";
+			regressions++;
+		}
+		else if (p < ALPHA && high < -threshold)
+		{
+			verdict = "  faster";
+		}
+		printf("%-44s %10zu %10.3f %10.3f %+7.1f%%   [%+6.1f%%, %+6.1f%%] %8.4f%s\n", label.c_str(), r.count,
+			baseMedian * 1e3, newMedian * 1e3, (newMedian / baseMedian - 1.0) * 100.0, low * 100.0, high * 100.0, p, verdict);
+	}
+	for (const BenchmarkResult& b : base)
+	{
+		if (std::none_of(current.begin(), current.end(), [&](const BenchmarkResult& r) { return SameKernel(b, r); }))
+		{
+			printf("%-44s %10zu  only in %s\n", (b.benchmark + "/" + b.name).c_str(), b.count, basePath);
+		}
+	}
+	printf("%d regression%s beyond %.1f%%\n", regressions, regressions == 1 ? "" : "s", threshold * 100.0);
+	return regressions;
+}
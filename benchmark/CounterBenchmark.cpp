@@ -0,0 +1,53 @@
+/*
+Title: Vector Mathematics
+File Name: CounterBenchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "../header/PerfCounters.h"
+#include "../header/VectorBatch.h"
+
+// Hardware counters for each Vector3D batch kernel, over arrays that do not fit in cache.
+void BenchCounters(const BenchmarkOptions& options)
+{
+	size_t n = options.count;
+	std::vector<Vector3D> a(n, Vector3D(1, 2, 3));
+	std::vector<Vector3D> b(n, Vector3D(3, 2, 1));
+	std::vector<Vector3D> out(n);
+	std::vector<float> scalars(n);
+	const float rotation[9] = { 0, -1, 0, 1, 0, 0, 0, 0, 1 };
+	size_t v = sizeof(Vector3D);
+
+	KernelProfiler profiler;
+	for (int r = 0; r < options.repeats; r++)
+	{
+		profiler.Measure("NormalizeBatch", n * 2 * v, [&] { NormalizeBatch(a.data(), out.data(), n); });
+		profiler.Measure("MagnitudeBatch", n * (v + sizeof(float)), [&] { MagnitudeBatch(a.data(), scalars.data(), n); });
+		profiler.Measure("DotBatch", n * (2 * v + sizeof(float)), [&] { DotBatch(a.data(), b.data(), scalars.data(), n); });
+		profiler.Measure("CrossBatch", n * 3 * v, [&] { CrossBatch(a.data(), b.data(), out.data(), n); });
+		profiler.Measure("ProjectBatch", n * 3 * v, [&] { ProjectBatch(a.data(), b.data(), out.data(), n); });
+		profiler.Measure("TransformBatch", n * 2 * v, [&] { TransformBatch(a.data(), out.data(), n, rotation, Vector3D(0, 0, 1)); });
+	}
+	profiler.Print(stdout);
+	DoNotOptimize(out.data());
+	DoNotOptimize(scalars.data());
+}
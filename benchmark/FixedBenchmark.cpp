@@ -0,0 +1,84 @@
+/*
+Title: Vector Mathematics
+File Name: FixedBenchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <vector>
+
+#include "../header/helpers.h"
+#include "../header/FixedVector.h"
+#include "../header/VectorBatch.h"
+
+// The cost of determinism: the same kernels in float, Q16.16 and Q32.32.
+void BenchFixed(const BenchmarkOptions& options)
+{
+	size_t n = options.count;
+	std::vector<Vector3D> a(n), b(n), out(n);
+	std::vector<FixedVector3D> fa(n), fb(n), fout(n);
+	std::vector<Fixed64Vector3D> da(n), db(n), dout(n);
+	std::vector<float> scalars(n);
+	std::vector<Fixed> fscalars(n);
+	std::vector<Fixed64> dscalars(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		// Small enough that every intermediate fits in Q16.16.
+		a[i] = Vector3D(randFloat(-10, 10), randFloat(-10, 10), randFloat(-10, 10));
+		b[i] = Vector3D(randFloat(-10, 10), randFloat(-10, 10), randFloat(-10, 10));
+		fa[i] = ToFixed(a[i]);
+		fb[i] = ToFixed(b[i]);
+		da[i] = ToFixed64(ToDouble(a[i]));
+		db[i] = ToFixed64(ToDouble(b[i]));
+	}
+
+	double t = BestTime(options.repeats, [&] { DotBatch(a.data(), b.data(), scalars.data(), n); });
+	Report("dot float", n, 28, t);
+	t = BestTime(options.repeats, [&] { DotBatch(fa.data(), fb.data(), fscalars.data(), n); });
+	Report("dot Q16.16", n, 28, t);
+	t = BestTime(options.repeats, [&] { DotBatch(da.data(), db.data(), dscalars.data(), n); });
+	Report("dot Q32.32", n, 56, t);
+
+	t = BestTime(options.repeats, [&] { CrossBatch(a.data(), b.data(), out.data(), n); });
+	Report("cross float", n, 36, t);
+	t = BestTime(options.repeats, [&] { CrossBatch(fa.data(), fb.data(), fout.data(), n); });
+	Report("cross Q16.16", n, 36, t);
+	t = BestTime(options.repeats, [&] { CrossBatch(da.data(), db.data(), dout.data(), n); });
+	Report("cross Q32.32", n, 72, t);
+
+	t = BestTime(options.repeats, [&] { MagnitudeBatch(a.data(), scalars.data(), n); });
+	Report("magnitude float", n, 16, t);
+	t = BestTime(options.repeats, [&] { MagnitudeBatch(fa.data(), fscalars.data(), n); });
+	Report("magnitude Q16.16", n, 16, t);
+	t = BestTime(options.repeats, [&] { MagnitudeBatch(da.data(), dscalars.data(), n); });
+	Report("magnitude Q32.32", n, 32, t);
+
+	t = BestTime(options.repeats, [&] { ProjectBatch(a.data(), b.data(), out.data(), n); });
+	Report("project float", n, 36, t);
+	t = BestTime(options.repeats, [&] { ProjectBatch(fa.data(), fb.data(), fout.data(), n); });
+	Report("project Q16.16", n, 36, t);
+	t = BestTime(options.repeats, [&] { ProjectBatch(da.data(), db.data(), dout.data(), n); });
+	Report("project Q32.32", n, 72, t);
+
+	DoNotOptimize(out.data());
+	DoNotOptimize(fout.data());
+	DoNotOptimize(dout.data());
+	DoNotOptimize(scalars.data());
+	DoNotOptimize(fscalars.data());
+	DoNotOptimize(dscalars.data());
+}
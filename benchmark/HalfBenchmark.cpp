@@ -0,0 +1,81 @@
+/*
+Title: Vector Mathematics
+File Name: HalfBenchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <vector>
+
+#include "../header/helpers.h"
+#include "../header/HalfVector.h"
+#include "../header/VectorBatch.h"
+
+// Compares the same kernels over float, half and bfloat16 arrays.
+// Once the arrays are much larger than the caches, the 16-bit versions should approach
+//  twice the speed of float, since they move half as many bytes.
+void BenchHalf(const BenchmarkOptions& options)
+{
+	size_t n = options.count;
+	std::vector<Vector3D> a3(n), b3(n), out3(n);
+	std::vector<Vector4D> a4(n), out4(n);
+	std::vector<float> dots(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		a3[i] = Vector3D(randFloat(-10, 10), randFloat(-10, 10), randFloat(-10, 10));
+		b3[i] = Vector3D(randFloat(-10, 10), randFloat(-10, 10), randFloat(-10, 10));
+		a4[i] = Vector4D(a3[i].x, a3[i].y, a3[i].z, 1.0f);
+	}
+
+	std::vector<HalfVector3D> ha3(n), hb3(n), hout3(n);
+	std::vector<HalfVector4D> ha4(n), hout4(n);
+	std::vector<BFloat16Vector3D> ba3(n), bb3(n), bout3(n);
+	EncodeHalf(a3.data(), n, ha3.data());
+	EncodeHalf(b3.data(), n, hb3.data());
+	EncodeHalf(a4.data(), n, ha4.data());
+	EncodeBFloat16(a3.data(), n, ba3.data());
+	EncodeBFloat16(b3.data(), n, bb3.data());
+
+	printf("F16C conversion: %s\n", HalfHardwareConversion() ? "yes" : "no");
+
+	double t = BestTime(options.repeats, [&] { NormalizeBatch(a3.data(), out3.data(), n); });
+	Report("normalize Vector3D float", n, 24, t);
+	t = BestTime(options.repeats, [&] { NormalizeBatch(ha3.data(), hout3.data(), n); });
+	Report("normalize Vector3D half", n, 12, t);
+	t = BestTime(options.repeats, [&] { NormalizeBatch(ba3.data(), bout3.data(), n); });
+	Report("normalize Vector3D bfloat16", n, 12, t);
+
+	t = BestTime(options.repeats, [&] { NormalizeBatch(a4.data(), out4.data(), n); });
+	Report("normalize Vector4D float", n, 32, t);
+	t = BestTime(options.repeats, [&] { NormalizeBatch(ha4.data(), hout4.data(), n); });
+	Report("normalize Vector4D half", n, 16, t);
+
+	t = BestTime(options.repeats, [&] { DotBatch(a3.data(), b3.data(), dots.data(), n); });
+	Report("dot Vector3D float", n, 28, t);
+	t = BestTime(options.repeats, [&] { DotBatch(ha3.data(), hb3.data(), dots.data(), n); });
+	Report("dot Vector3D half", n, 16, t);
+	t = BestTime(options.repeats, [&] { DotBatch(ba3.data(), bb3.data(), dots.data(), n); });
+	Report("dot Vector3D bfloat16", n, 16, t);
+
+	DoNotOptimize(out3.data());
+	DoNotOptimize(out4.data());
+	DoNotOptimize(hout3.data());
+	DoNotOptimize(hout4.data());
+	DoNotOptimize(bout3.data());
+	DoNotOptimize(dots.data());
+}
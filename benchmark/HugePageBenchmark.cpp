@@ -0,0 +1,50 @@
+/*
+Title: Vector Mathematics
+File Name: HugePageBenchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <cstdio>
+
+#include "../header/HugePages.h"
+#include "../header/MemoryResource.h"
+#include "../header/VectorBatch.h"
+
+// An in-place normalize sweep over one large Vector4D array, on ordinary pages and on huge pages,
+//  with how much of the array the kernel really backed with huge pages.
+void BenchHugePages(const BenchmarkOptions& options)
+{
+	HugePageResource hugePages;
+	std::pmr::memory_resource* resources[] = { std::pmr::new_delete_resource(), &hugePages };
+	const char* names[] = { "normal pages", "huge pages" };
+	for (int r = 0; r < 2; r++)
+	{
+		VectorBuffer4D v(options.count, Vector4D(1, 2, 3, 4), resources[r]);
+		size_t bytes = v.size() * sizeof(Vector4D);
+		double t = BestTime(options.repeats, [&] { NormalizeBatch(v.data(), v.data(), v.size()); });
+		Report(names[r], options.count, 2 * sizeof(Vector4D), t);
+
+		const char* kind = "";
+		if (r == 1)
+		{
+			kind = hugePages.LastKind() == PageKind::Explicit ? ", explicit" : hugePages.LastKind() == PageKind::Transparent ? ", transparent" : ", unavailable";
+		}
+		printf("  %.1f of %.1f MB on huge pages%s\n", HugePageBytes(v.data(), bytes) / 1048576.0, bytes / 1048576.0, kind);
+	}
+}
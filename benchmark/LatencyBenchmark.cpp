@@ -0,0 +1,62 @@
+/*
+Title: Vector Mathematics
+File Name: LatencyBenchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "../header/LatencyHistogram.h"
+#include "../header/ThreadPool.h"
+#include "../header/VectorBatch.h"
+
+// Vectors per timed kernel call: small enough that a page fault or a preempted thread stands out.
+static const size_t LATENCY_BATCH = 1024;
+
+// Per-call latency of each Vector3D batch kernel, with the calls spread over the thread pool.
+void BenchLatency(const BenchmarkOptions& options)
+{
+	size_t n = options.count;
+	std::vector<Vector3D> a(n, Vector3D(1, 2, 3));
+	std::vector<Vector3D> b(n, Vector3D(3, 2, 1));
+	std::vector<Vector3D> out(n);
+	std::vector<float> scalars(n);
+	const float rotation[9] = { 0, -1, 0, 1, 0, 0, 0, 0, 1 };
+
+	ThreadPool pool;
+	LatencyRecorder recorder;
+	auto run = [&](const char* name, auto kernel)
+	{
+		recorder.Clear();
+		for (int r = 0; r < options.repeats; r++)
+		{
+			pool.ParallelFor(n, LATENCY_BATCH, [&](size_t begin, size_t end) { recorder.Measure([&] { kernel(begin, end - begin); }); });
+		}
+		recorder.Snapshot().Print(stdout, name);
+	};
+	run("NormalizeBatch", [&](size_t i, size_t count) { NormalizeBatch(a.data() + i, out.data() + i, count); });
+	run("MagnitudeBatch", [&](size_t i, size_t count) { MagnitudeBatch(a.data() + i, scalars.data() + i, count); });
+	run("DotBatch", [&](size_t i, size_t count) { DotBatch(a.data() + i, b.data() + i, scalars.data() + i, count); });
+	run("CrossBatch", [&](size_t i, size_t count) { CrossBatch(a.data() + i, b.data() + i, out.data() + i, count); });
+	run("ProjectBatch", [&](size_t i, size_t count) { ProjectBatch(a.data() + i, b.data() + i, out.data() + i, count); });
+	run("TransformBatch", [&](size_t i, size_t count) { TransformBatch(a.data() + i, out.data() + i, count, rotation, Vector3D(0, 0, 1)); });
+	DoNotOptimize(out.data());
+	DoNotOptimize(scalars.data());
+}
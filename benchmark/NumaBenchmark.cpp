@@ -0,0 +1,82 @@
+/*
+Title: Vector Mathematics
+File Name: NumaBenchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "../header/Numa.h"
+#include "../header/ThreadPool.h"
+#include "../header/VectorBatch.h"
+
+// Bandwidth of an in-place normalize over one large array for each NumaPlacement, against a plain
+//  std::vector driven by the ordinary unpinned ThreadPool.
+// On a single-node machine all of these should match; on several nodes Local falls behind.
+void BenchNuma(const BenchmarkOptions& options)
+{
+	NumaThreadPool numaPool;
+	const NumaTopology& topology = numaPool.Topology();
+	printf("%u node(s), %u pinned worker(s)%s\n", topology.NodeCount(), numaPool.Size(), numaPool.Pinned() ? "" : " (pinning failed)");
+	size_t bytes = 2 * sizeof(Vector3D);
+
+	{
+		std::vector<Vector3D> v(options.count, Vector3D(1, 2, 3));
+		ThreadPool pool;
+		double t = BestTime(options.repeats, [&]
+		{
+			pool.ParallelFor(v.size(), 1 << 16, [&](size_t begin, size_t end)
+			{
+				NormalizeBatch(&v[begin], &v[begin], end - begin);
+			});
+		});
+		Report("std::vector, ThreadPool", options.count, bytes, t);
+	}
+
+	const NumaPlacement placements[] = { NumaPlacement::Local, NumaPlacement::FirstTouch, NumaPlacement::Partitioned };
+	const char* names[] = { "local", "first touch", "partitioned" };
+	for (int p = 0; p < 3; p++)
+	{
+		NumaArray<Vector3D> v(options.count, numaPool, placements[p]);
+		if (!v.Valid())
+		{
+			fprintf(stderr, "could not allocate %zu vectors\n", options.count);
+			return;
+		}
+		numaPool.ParallelFor(v.Count(), [&](size_t begin, size_t end, unsigned)
+		{
+			Vector3D* span = v.Span(begin);
+			for (size_t i = 0; i < end - begin; i++)
+			{
+				span[i] = Vector3D(1, 2, 3);
+			}
+		});
+		double t = BestTime(options.repeats, [&]
+		{
+			numaPool.ParallelFor(v.Count(), [&](size_t begin, size_t end, unsigned)
+			{
+				NormalizeBatch(v.Span(begin), v.Span(begin), end - begin);
+			});
+		});
+		char label[64];
+		snprintf(label, sizeof(label), "%s%s", names[p], placements[p] == NumaPlacement::Partitioned && !v.Bound() ? " (unbound)" : "");
+		Report(label, options.count, bytes, t);
+	}
+}
@@ -0,0 +1,78 @@
+/*
+Title: Vector Mathematics
+File Name: PipelineBenchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <cstdio>
+
+#include "../header/BatchPipeline.h"
+#include "../header/VectorBatch.h"
+
+// load -> transform -> normalize -> reduce on separate threads, at a few batch sizes.
+// The per-stage lines, from the last run, show which stage limits the whole pipeline.
+void BenchPipeline(const BenchmarkOptions& options)
+{
+	const float rotation[9] = { 0, -1, 0, 1, 0, 0, 0, 0, 1 };
+	const size_t batchSizes[] = { 256, 4096, 65536 };
+	for (size_t batchSize : batchSizes)
+	{
+		size_t produced = 0;
+		double sum = 0.0;
+		BatchPipeline<Vector3D> pipeline(batchSize, 32);
+		pipeline.Source("load", [&](BatchSlot<Vector3D>& batch)
+		{
+			size_t n = options.count - produced < batch.capacity ? options.count - produced : batch.capacity;
+			for (size_t i = 0; i < n; i++)
+			{
+				float f = static_cast<float>(produced + i);
+				batch.vectors[i] = Vector3D(f, f * 0.5f, 1.0f);
+			}
+			batch.count = n;
+			produced += n;
+			return produced < options.count;
+		})
+		.Stage("transform", [&](BatchSlot<Vector3D>& batch)
+		{
+			TransformBatch(batch.vectors, batch.vectors, batch.count, rotation, Vector3D(0, 0, 0));
+		})
+		.Stage("normalize", [&](BatchSlot<Vector3D>& batch)
+		{
+			NormalizeBatch(batch.vectors, batch.vectors, batch.count);
+		})
+		.Sink("reduce", [&](const BatchSlot<Vector3D>& batch)
+		{
+			for (size_t i = 0; i < batch.count; i++)
+			{
+				sum += batch.vectors[i].z;
+			}
+		});
+
+		double t = BestTime(options.repeats, [&]
+		{
+			produced = 0;
+			pipeline.Run();
+		});
+		char label[64];
+		snprintf(label, sizeof(label), "pipeline, batch %zu", batchSize);
+		Report(label, options.count, sizeof(Vector3D), t);
+		pipeline.PrintStats(stdout);
+		DoNotOptimize(&sum);
+	}
+}
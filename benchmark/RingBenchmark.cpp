@@ -0,0 +1,166 @@
+/*
+Title: Vector Mathematics
+File Name: RingBenchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "../header/SharedRing.h"
+#include "../header/Vector3D.h"
+
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Streams options.count vectors to a child process through a ring, filling them in place.
+static double StreamOnce(const char* name, size_t count, size_t batch)
+{
+	SharedRing ring;
+	if (!ring.Create(name, 3, 1 << 16))
+	{
+		return 0.0;
+	}
+	double start = NowSeconds();
+	pid_t child = fork();
+	if (child == 0)
+	{
+		SharedRing reader;
+		float sum = 0.0f;
+		if (reader.Open(name))
+		{
+			for (;;)
+			{
+				RingSpan span = reader.BeginRead(batch);
+				if (span.count == 0)
+				{
+					break;
+				}
+				const Vector3D* v = RingVectors<Vector3D>(span);
+				for (size_t i = 0; i < span.count; i++)
+				{
+					sum += v[i].x;
+				}
+				reader.EndRead(span);
+			}
+		}
+		DoNotOptimize(&sum);
+		_exit(0);
+	}
+
+	for (size_t sent = 0; sent < count;)
+	{
+		RingSpan span = ring.BeginWrite(std::min(batch, count - sent));
+		Vector3D* v = RingVectors<Vector3D>(span);
+		for (size_t i = 0; i < span.count; i++)
+		{
+			v[i] = Vector3D(static_cast<float>(sent + i), 1.0f, 2.0f);
+		}
+		ring.EndWrite(span);
+		sent += span.count;
+	}
+	ring.Shutdown();
+	int status;
+	waitpid(child, &status, 0);
+	return NowSeconds() - start;
+}
+
+// Bounces a single vector between two processes and records each round trip.
+static void PingPong(const char* pingName, const char* pongName, size_t trips, std::vector<double>& roundTrips)
+{
+	SharedRing ping, pong;
+	if (!ping.Create(pingName, 3, 64) || !pong.Create(pongName, 3, 64))
+	{
+		return;
+	}
+	pid_t child = fork();
+	if (child == 0)
+	{
+		SharedRing in, out;
+		if (in.Open(pingName) && out.Open(pongName))
+		{
+			for (;;)
+			{
+				RingSpan span = in.BeginRead(1);
+				if (span.count == 0)
+				{
+					break;
+				}
+				out.Write(span.data, 1);
+				in.EndRead(span);
+			}
+		}
+		_exit(0);
+	}
+
+	Vector3D v(1.0f, 2.0f, 3.0f);
+	roundTrips.clear();
+	for (size_t i = 0; i < trips; i++)
+	{
+		double start = NowSeconds();
+		ping.Write(&v.x, 1);
+		RingSpan span = pong.BeginRead(1);
+		pong.EndRead(span);
+		roundTrips.push_back(NowSeconds() - start);
+	}
+	ping.Shutdown();
+	int status;
+	waitpid(child, &status, 0);
+}
+
+// Cross-process streaming through SharedRing: bulk throughput, and the latency of one vector
+//  when the other side is asleep on the futex.
+void BenchRing(const BenchmarkOptions& options)
+{
+	char name[64], pongName[64];
+	snprintf(name, sizeof(name), "/vector-bench-%d", static_cast<int>(getpid()));
+	snprintf(pongName, sizeof(pongName), "/vector-bench-%d-pong", static_cast<int>(getpid()));
+
+	const size_t batches[] = { 64, 4096 };
+	for (size_t batch : batches)
+	{
+		double t = BestTime(options.repeats, [&] { StreamOnce(name, options.count, batch); });
+		char label[64];
+		snprintf(label, sizeof(label), "stream Vector3D, batch %zu", batch);
+		Report(label, options.count, sizeof(Vector3D), t);
+	}
+
+	std::vector<double> roundTrips;
+	PingPong(name, pongName, std::min<size_t>(options.count, 20000), roundTrips);
+	if (roundTrips.empty())
+	{
+		printf("ping-pong: could not create rings\n");
+		return;
+	}
+	std::sort(roundTrips.begin(), roundTrips.end());
+	size_t n = roundTrips.size();
+	printf("%-32s p50 %8.3f us  p99 %8.3f us  max %8.3f us\n", "one-way latency (round trip / 2)",
+		roundTrips[n / 2] * 0.5e6, roundTrips[n * 99 / 100] * 0.5e6, roundTrips[n - 1] * 0.5e6);
+}
+
+#else
+
+void BenchRing(const BenchmarkOptions&)
+{
+	printf("SharedRing needs Linux\n");
+}
+
+#endif
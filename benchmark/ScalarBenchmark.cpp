@@ -0,0 +1,111 @@
+/*
+Title: Vector Mathematics
+File Name: ScalarBenchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "../header/helpers.h"
+#include "../header/Vector3D.h"
+
+// Times the out-of-line scalar functions in Vector3D.cpp, one call per vector, so --save and --compare
+//  catch a change that slows them down, such as building with VECTOR_MATH_PROBES.
+// Each kernel runs at a size that fits in L1, one that fits in L2, and the full count; the smaller
+//  arrays are swept repeatedly so every run covers about count vectors.
+void BenchScalar(const BenchmarkOptions& options)
+{
+	const size_t sizes[] = { 1 << 10, 1 << 16, options.count };
+	std::vector<Vector3D> a(options.count), b(options.count), out(options.count);
+	std::vector<float> scalars(options.count);
+	for (size_t i = 0; i < options.count; i++)
+	{
+		a[i] = Vector3D(randFloat(-10, 10), randFloat(-10, 10), randFloat(-10, 10));
+		b[i] = Vector3D(randFloat(-10, 10), randFloat(-10, 10), randFloat(-10, 10));
+	}
+
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+		// A count equal to a smaller size would report the same kernels twice under one key.
+		size_t n = sizes[s];
+		if (n > options.count || (s > 0 && n == sizes[s - 1]))
+		{
+			continue;
+		}
+		size_t passes = options.count / n;
+		size_t total = n * passes;
+		char name[64];
+
+		double t = BestTime(options.repeats, [&]
+		{
+			for (size_t p = 0; p < passes; p++)
+			{
+				for (size_t i = 0; i < n; i++)
+				{
+					scalars[i] = Dot(a[i], b[i]);
+				}
+			}
+		});
+		snprintf(name, sizeof(name), "Dot %zu", n);
+		Report(name, total, 28, t);
+
+		t = BestTime(options.repeats, [&]
+		{
+			for (size_t p = 0; p < passes; p++)
+			{
+				for (size_t i = 0; i < n; i++)
+				{
+					out[i] = Cross(a[i], b[i]);
+				}
+			}
+		});
+		snprintf(name, sizeof(name), "Cross %zu", n);
+		Report(name, total, 36, t);
+
+		t = BestTime(options.repeats, [&]
+		{
+			for (size_t p = 0; p < passes; p++)
+			{
+				for (size_t i = 0; i < n; i++)
+				{
+					scalars[i] = Magnitude(a[i]);
+				}
+			}
+		});
+		snprintf(name, sizeof(name), "Magnitude %zu", n);
+		Report(name, total, 16, t);
+
+		t = BestTime(options.repeats, [&]
+		{
+			for (size_t p = 0; p < passes; p++)
+			{
+				for (size_t i = 0; i < n; i++)
+				{
+					scalars[i] = MagInverse(a[i]);
+				}
+			}
+		});
+		snprintf(name, sizeof(name), "MagInverse %zu", n);
+		Report(name, total, 16, t);
+	}
+
+	DoNotOptimize(out.data());
+	DoNotOptimize(scalars.data());
+}
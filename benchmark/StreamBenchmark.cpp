@@ -0,0 +1,103 @@
+/*
+Title: Vector Mathematics
+File Name: StreamBenchmark.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../header/AsyncStream.h"
+#include "../header/MappedFile.h"
+#include "../header/VectorBatch.h"
+#include "../header/VectorFile.h"
+#include "../header/VectorParser.h"
+
+// Loading everything, normalizing, then writing, against the coroutine pipeline in AsyncStream.h
+//  doing the same work chunk by chunk with disk and compute overlapped.
+// Both read a temporary file and write to the null device, so only the input side touches the disk.
+void BenchStream(const BenchmarkOptions& options)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path();
+	std::string textPath = (directory / "vector-stream-bench.txt").string();
+	std::string binaryPath = (directory / "vector-stream-bench.vecf").string();
+
+	{
+		std::vector<Vector3D> v(options.count);
+		for (size_t i = 0; i < options.count; i++)
+		{
+			float f = static_cast<float>(i);
+			v[i] = Vector3D(f, f * 0.5f, 1.0f);
+		}
+		FILE* text = fopen(textPath.c_str(), "wb");
+		if (text == nullptr || !WriteVectorFile(binaryPath.c_str(), v.data(), v.size()))
+		{
+			fprintf(stderr, "could not write temporary files in %s\n", directory.string().c_str());
+			return;
+		}
+		VectorWriter writer(text);
+		writer.Write(v.data(), v.size());
+		writer.Flush();
+		fclose(text);
+	}
+
+	FILE* null = fopen("/dev/null", "wb");
+	if (null == nullptr)
+	{
+		null = fopen("NUL", "wb");
+	}
+
+	double t = BestTime(options.repeats, [&]
+	{
+		MappedFile file;
+		file.Open(textPath.c_str());
+		std::vector<Vector3D> v(CountVectorLines(file.data, file.size));
+		ParseResult parsed = ParseVectors(file.data, file.size, v.data(), v.size());
+		NormalizeBatch(v.data(), v.data(), parsed.count);
+		VectorWriter writer(null);
+		writer.Write(v.data(), parsed.count);
+	});
+	Report("blocking, text", options.count, sizeof(Vector3D), t);
+
+	ThreadPool pool;
+	StreamKernel<Vector3D> normalize = [](const Vector3D* in, Vector3D* out, size_t count)
+	{
+		NormalizeBatch(in, out, count);
+	};
+	const std::string* paths[] = { &textPath, &binaryPath };
+	for (const std::string* path : paths)
+	{
+		StreamResult result = {};
+		t = BestTime(options.repeats, [&]
+		{
+			result = StreamVectors(path->c_str(), null, normalize, pool);
+		});
+		Report(path == &textPath ? "streaming, text" : "streaming, vecf", options.count, sizeof(Vector3D), t);
+		if (!result.ok || result.vectors != options.count)
+		{
+			fprintf(stderr, "streaming run failed\n");
+		}
+	}
+
+	fclose(null);
+	std::filesystem::remove(textPath);
+	std::filesystem::remove(binaryPath);
+}
@@ -0,0 +1,69 @@
+/*
+Title: Vector Mathematics
+File Name: ArrowIPC.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "MappedFile.h"
+#include "Vector2D.h"
+#include "Vector3D.h"
+#include "Vector4D.h"
+#include "VectorFile.h"
+
+// Reading and writing vector arrays as Apache Arrow IPC files (the .arrow "Feather V2" format),
+//  so analytics tools can load them directly instead of parsing text.
+// Arrow's metadata is stored as FlatBuffers; this file contains just enough of a FlatBuffers
+//  encoder and decoder for the few metadata tables involved, so no Arrow or FlatBuffers library is needed.
+// Only uncompressed files without nulls, whose columns have float components, are supported.
+
+enum class ArrowLayout
+{
+	// A single column "vectors" of type FixedSizeList<float, dimension>. The data is stored AoS.
+	FixedSizeList,
+	// One float column per component, named "x", "y", "z", "w". The data is stored SoA.
+	Columns,
+};
+
+// Writes count vectors to path. The data is split into record batches of at most batchRows
+//  vectors each; 0 writes a single batch. Returns false on any I/O error.
+bool WriteArrowFile(const char* path, const Vector2D* v, size_t count, ArrowLayout layout = ArrowLayout::FixedSizeList, size_t batchRows = 0);
+bool WriteArrowFile(const char* path, const Vector3D* v, size_t count, ArrowLayout layout = ArrowLayout::FixedSizeList, size_t batchRows = 0);
+bool WriteArrowFile(const char* path, const Vector4D* v, size_t count, ArrowLayout layout = ArrowLayout::FixedSizeList, size_t batchRows = 0);
+
+// A memory-mapped Arrow IPC file of vectors.
+// Each record batch is exposed as a VectorArrayView pointing straight into the mapped file.
+struct ArrowVectorFile
+{
+	MappedFile file;
+	ArrowLayout layout;
+	int dimension;
+	std::vector<VectorArrayView> batches;
+
+	ArrowVectorFile();
+
+	// Maps the file and checks that its schema is one of the two layouts above.
+	bool Open(const char* path);
+	void Close();
+
+	// Total number of vectors in all batches.
+	size_t Count() const;
+};
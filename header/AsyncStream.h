@@ -0,0 +1,127 @@
+/*
+Title: Vector Mathematics
+File Name: AsyncStream.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "Coroutine.h"
+#include "ThreadPool.h"
+#include "Vector2D.h"
+#include "Vector3D.h"
+#include "Vector4D.h"
+#include "VectorWriter.h"
+
+// Streaming vector workloads built from coroutines.
+// Loading a whole file, then computing, then writing leaves the disk idle while the CPU works and
+//  the CPU idle while the disk works. Here reading, parsing and computing, and writing are stages
+//  that suspend instead of blocking, so while one chunk is being computed on the pool the next is
+//  being read and the previous one written, all in bounded memory.
+
+// A thread that runs blocking calls, such as reading and writing files, on behalf of coroutines.
+class IoThread
+{
+public:
+	// Coroutines waiting on an operation are resumed on pool once it completes.
+	explicit IoThread(ThreadPool& pool);
+	// Finishes any queued operations first.
+	~IoThread();
+
+	template <typename F>
+	struct Operation
+	{
+		IoThread& io;
+		F call;
+		size_t result;
+
+		bool await_ready() const { return false; }
+		void await_suspend(std::coroutine_handle<> h)
+		{
+			io.Post([this, h] {
+				result = call();
+				// h may finish and free this operation as soon as it is posted, so touch nothing after.
+				io.pool.Post([h] { h.resume(); });
+			});
+		}
+		size_t await_resume() const { return result; }
+	};
+
+	// co_await io.Run(call) runs call() on the I/O thread and resumes with the size_t it returns.
+	template <typename F>
+	Operation<F> Run(F call)
+	{
+		return Operation<F>{*this, std::move(call), 0};
+	}
+
+private:
+	ThreadPool& pool;
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::deque<std::function<void()>> jobs;
+	bool stopping;
+
+	void Post(std::function<void()> job);
+	void Loop();
+
+	IoThread(const IoThread&);
+	IoThread& operator=(const IoThread&);
+};
+
+struct StreamOptions
+{
+	// Bytes of text read per chunk. Chunks of .vecf input hold as many vectors as fit in this many bytes.
+	size_t chunkBytes;
+	// Chunks being read, computed, or written at once. 0 uses two per pool thread.
+	unsigned chunksInFlight;
+	NumberFormat format;
+	int precision;
+
+	// 4 MB chunks, Shortest format.
+	StreamOptions();
+};
+
+struct StreamResult
+{
+	// False if the input could not be read or parsed, or the output could not be written.
+	bool ok;
+	// Vectors written.
+	size_t vectors;
+	// 1-based line number of the first bad input line, or 0.
+	size_t errorLine;
+};
+
+// The work applied to each chunk. out may be the same array as in.
+template <typename V>
+using StreamKernel = std::function<void(const V* in, V* out, size_t count)>;
+
+// Reads vectors from inPath, either text in any form ParseVectors accepts or a .vecf file, runs
+//  kernel over them chunk by chunk on pool, and writes the results to out as text in input order.
+// Blocks until the whole file has been processed. Must not be called from one of pool's threads.
+StreamResult StreamVectors(const char* inPath, FILE* out, const StreamKernel<Vector2D>& kernel, ThreadPool& pool, const StreamOptions& options = StreamOptions());
+StreamResult StreamVectors(const char* inPath, FILE* out, const StreamKernel<Vector3D>& kernel, ThreadPool& pool, const StreamOptions& options = StreamOptions());
+StreamResult StreamVectors(const char* inPath, FILE* out, const StreamKernel<Vector4D>& kernel, ThreadPool& pool, const StreamOptions& options = StreamOptions());
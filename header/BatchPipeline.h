@@ -0,0 +1,94 @@
+/*
+Title: Vector Mathematics
+File Name: BatchPipeline.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "BatchQueue.h"
+
+// Chains processing stages on their own threads, e.g. load -> transform -> normalize -> reduce,
+//  with batches of vectors flowing between them through BoundedQueues.
+// The number of batches in flight is fixed by the pool, so a slow stage makes the source wait
+//  for a free batch instead of letting queues grow without bound.
+// Each stage records how busy it was and how deep its input queue ran, which shows at a glance
+//  where the bottleneck is.
+// Instantiated for Vector3D and Vector4D in BatchPipeline.cpp.
+
+struct StageStats
+{
+	std::string name;
+	unsigned threads;
+	unsigned long long batches;
+	unsigned long long vectors;
+	// Time spent inside the stage's function, summed over its threads.
+	double busySeconds;
+	// From the start of the run until the stage's last thread finished.
+	double seconds;
+	// Depth of the stage's input queue, sampled each time it takes a batch. Zero for the source.
+	double meanQueueDepth;
+	size_t maxQueueDepth;
+};
+
+template <typename V>
+class BatchPipeline
+{
+public:
+	// Fills a batch, setting its count. Returns false once there is nothing more to produce.
+	typedef std::function<bool(BatchSlot<V>&)> SourceFunction;
+	// Processes a batch in place.
+	typedef std::function<void(BatchSlot<V>&)> StageFunction;
+	// Consumes a batch at the end of the pipeline.
+	typedef std::function<void(const BatchSlot<V>&)> SinkFunction;
+
+	BatchPipeline(size_t batchCapacity = 4096, size_t batchCount = 64);
+
+	// Stages run in the order they are added: one source, any number of stages, one sink.
+	// A stage with several threads may pass batches on out of order; BatchSlot::sequence gives the original order.
+	BatchPipeline& Source(const char* name, SourceFunction function);
+	BatchPipeline& Stage(const char* name, StageFunction function, unsigned threads = 1);
+	BatchPipeline& Sink(const char* name, SinkFunction function);
+
+	// Runs every stage until the source is exhausted and the sink has seen every batch.
+	// Returns false if the pipeline is missing its source or sink.
+	bool Run();
+
+	// One entry per stage, from the last Run.
+	const std::vector<StageStats>& Stats() const;
+	void PrintStats(FILE* out) const;
+
+private:
+	struct StageDefinition
+	{
+		std::string name;
+		SourceFunction source;
+		StageFunction stage;
+		SinkFunction sink;
+		unsigned threads;
+	};
+
+	size_t batchCapacity;
+	size_t batchCount;
+	std::vector<StageDefinition> stages;
+	std::vector<StageStats> stats;
+};
@@ -0,0 +1,111 @@
+/*
+Title: Vector Mathematics
+File Name: BatchQueue.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "Vector3D.h"
+#include "Vector4D.h"
+
+// Moving batches of vectors between threads without locks or allocation.
+// Batches are allocated once, up front, by a BatchPool, and only pointers to them pass through
+//  the queues, so the steady state of a pipeline never touches the allocator.
+// The templates are instantiated for Vector3D and Vector4D in BatchQueue.cpp.
+
+// A run of up to capacity vectors, of which the first count are in use.
+template <typename V>
+struct BatchSlot
+{
+	V* vectors;
+	size_t count;
+	size_t capacity;
+	// Position in the stream, set by the pipeline's source. Stages with several threads may
+	//  reorder batches, and this is how to restore the order.
+	unsigned long long sequence;
+};
+
+// A bounded multi-producer, multi-consumer queue of pointers, after Dmitry Vyukov's design.
+// Each cell carries a sequence number saying whether it is ready to be written or read in the
+//  current lap, so producers and consumers each claim a cell with one CAS on their own counter
+//  and never contend on a lock.
+template <typename T>
+class BoundedQueue
+{
+public:
+	// capacity is rounded up to a power of two.
+	explicit BoundedQueue(size_t capacity);
+	~BoundedQueue();
+
+	// Return false at once if the queue is full or empty.
+	bool TryPush(T* item);
+	bool TryPop(T*& item);
+
+	// Wait, spinning and then sleeping briefly, while the queue is full or empty.
+	// Push returns false if the queue was closed; Pop returns false once it is closed and empty.
+	bool Push(T* item);
+	bool Pop(T*& item);
+
+	// No more items will be pushed. Waiting consumers drain the queue, then stop.
+	void Close();
+	bool Closed() const;
+
+	// Approximate number of items waiting, for statistics.
+	size_t Depth() const;
+	size_t Capacity() const;
+
+private:
+	struct alignas(64) Cell
+	{
+		std::atomic<size_t> sequence;
+		T* item;
+	};
+
+	Cell* cells;
+	size_t mask;
+	alignas(64) std::atomic<size_t> enqueuePosition;
+	alignas(64) std::atomic<size_t> dequeuePosition;
+	alignas(64) std::atomic<bool> closed;
+
+	BoundedQueue(const BoundedQueue&);
+	BoundedQueue& operator=(const BoundedQueue&);
+};
+
+// A fixed set of batches, all allocated by the constructor, handed out and taken back through a queue.
+template <typename V>
+class BatchPool
+{
+public:
+	BatchPool(size_t batchCount, size_t batchCapacity);
+
+	// Waits for a free batch. Its count is reset to 0.
+	BatchSlot<V>* Acquire();
+	void Release(BatchSlot<V>* batch);
+
+	size_t BatchCount() const;
+	size_t BatchCapacity() const;
+
+private:
+	std::vector<V> storage;
+	std::vector<BatchSlot<V>> slots;
+	BoundedQueue<BatchSlot<V>> free;
+};
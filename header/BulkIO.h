@@ -0,0 +1,89 @@
+/*
+Title: Vector Mathematics
+File Name: BulkIO.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "Vector2D.h"
+#include "Vector3D.h"
+#include "Vector4D.h"
+
+// Bulk reading and writing of AoS .vecf files, for files far larger than the page cache.
+// A memory-mapped file only reads ahead a little at a time, and fwrite blocks on every buffer,
+//  so a single thread working through a multi-GB file spends much of its time waiting.
+// Here the file is split into large chunks with several in flight at once, and each chunk is
+//  handed to the caller as soon as it arrives, so computing on one chunk overlaps reading the next.
+// On Linux the chunks go through io_uring, with the chunk buffers registered with the kernel once
+//  up front; where io_uring is unavailable (old kernels, or blocked by a sandbox) a few threads
+//  doing pread and pwrite take its place. Chunks are aligned for O_DIRECT, which bypasses the
+//  page cache entirely; filesystems that refuse O_DIRECT are read and written through the cache.
+// Not available on Windows, where every call fails.
+
+enum class BulkIOEngine
+{
+	IoUring,
+	Threads,
+};
+
+struct BulkIOOptions
+{
+	// Bytes per chunk, rounded to whole vectors and whole 4 KB blocks.
+	size_t chunkBytes;
+	// Chunks in flight at once.
+	unsigned queueDepth;
+	// Try O_DIRECT.
+	bool direct;
+	// Try io_uring before falling back to threads.
+	bool useIoUring;
+
+	// 4 MB chunks, 8 in flight, O_DIRECT and io_uring where available.
+	BulkIOOptions();
+};
+
+// What a call actually ended up doing.
+struct BulkIOStats
+{
+	BulkIOEngine engine;
+	bool direct;
+	// Whether the chunk buffers were registered with io_uring; fails when RLIMIT_MEMLOCK is small.
+	bool registeredBuffers;
+	size_t chunks;
+	uint64_t bytes;
+};
+
+// Called with each chunk of vectors as it arrives. first is the index of vectors[0] in the file.
+// Chunks arrive in whatever order the reads complete, always on the thread that called ReadVectorFileBulk.
+// The vectors are only valid until the call returns.
+template <typename V>
+using BulkChunkFunction = std::function<void(const V* vectors, size_t first, size_t count)>;
+
+// Reads every vector of an AoS .vecf file of matching dimension at path, passing them to consume a chunk at a time.
+// Returns false on an I/O error, or if the file is not an AoS file of that dimension. The checksum is not verified.
+bool ReadVectorFileBulk(const char* path, const BulkChunkFunction<Vector2D>& consume, const BulkIOOptions& options = BulkIOOptions(), BulkIOStats* stats = nullptr);
+bool ReadVectorFileBulk(const char* path, const BulkChunkFunction<Vector3D>& consume, const BulkIOOptions& options = BulkIOOptions(), BulkIOStats* stats = nullptr);
+bool ReadVectorFileBulk(const char* path, const BulkChunkFunction<Vector4D>& consume, const BulkIOOptions& options = BulkIOOptions(), BulkIOStats* stats = nullptr);
+
+// Writes the same file as WriteVectorFile with the AoS layout. Returns false on any I/O error.
+bool WriteVectorFileBulk(const char* path, const Vector2D* v, size_t count, const BulkIOOptions& options = BulkIOOptions(), BulkIOStats* stats = nullptr);
+bool WriteVectorFileBulk(const char* path, const Vector3D* v, size_t count, const BulkIOOptions& options = BulkIOOptions(), BulkIOStats* stats = nullptr);
+bool WriteVectorFileBulk(const char* path, const Vector4D* v, size_t count, const BulkIOOptions& options = BulkIOOptions(), BulkIOStats* stats = nullptr);
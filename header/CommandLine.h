@@ -0,0 +1,31 @@
+/*
+Title: Vector Mathematics
+File Name: CommandLine.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+// The batch processing side of the program, used when it is run with arguments.
+// Each subcommand reads whole arrays of vectors, applies one of the batch kernels across all
+//  cores, and writes the results, so the program can sit in a shell pipeline:
+//   math-vectors-introduction normalize --dim 3 < in.txt > out.txt
+// Run it with --help for the list of commands and options.
+
+// Runs the subcommand named by argv[1]. Returns the process exit code:
+//  0 on success, 1 if the command failed, 2 if the arguments were invalid.
+int RunCommandLine(int argc, char* argv[]);
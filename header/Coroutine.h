@@ -0,0 +1,331 @@
+/*
+Title: Vector Mathematics
+File Name: Coroutine.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "ThreadPool.h"
+
+// Minimal C++20 coroutine types for streaming work through a ThreadPool.
+// A Task<T> is a computation that may suspend, e.g. while waiting on I/O, without holding a thread.
+// A Generator<T> lazily produces a sequence of values for a range-based for loop.
+// Nothing here throws; an exception escaping a coroutine terminates the program, like anywhere else in this library.
+
+template <typename T>
+class Task;
+
+// State shared by every Task promise.
+// waiter is null while the task runs with nobody waiting on it, the awaiting coroutine once one
+//  suspends on it, and TaskDone() once the task has finished. Whoever gets there second resumes the waiter.
+struct TaskPromiseBase
+{
+	std::atomic<void*> waiter{nullptr};
+
+	static void* TaskDone()
+	{
+		static char done;
+		return &done;
+	}
+
+	struct FinalAwaiter
+	{
+		bool await_ready() noexcept { return false; }
+
+		template <typename Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) noexcept
+		{
+			void* waiting = finished.promise().waiter.exchange(TaskDone(), std::memory_order_acq_rel);
+			if (waiting != nullptr)
+			{
+				return std::coroutine_handle<>::from_address(waiting);
+			}
+			return std::noop_coroutine();
+		}
+
+		void await_resume() noexcept {}
+	};
+
+	// Tasks are lazy: nothing runs until the task is started or awaited.
+	std::suspend_always initial_suspend() noexcept { return {}; }
+	// The frame stays alive after finishing so the result can be read; ~Task frees it.
+	FinalAwaiter final_suspend() noexcept { return {}; }
+	void unhandled_exception() noexcept { std::terminate(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase
+{
+	std::optional<T> result;
+
+	Task<T> get_return_object();
+	void return_value(T value) { result.emplace(std::move(value)); }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase
+{
+	Task<void> get_return_object();
+	void return_void() {}
+};
+
+// A lazily started coroutine producing a T.
+// co_await on a task starts it if needed and resumes the awaiting coroutine with its result once it
+//  finishes, on whichever thread finished it. Start() runs it up to its first suspension instead, so
+//  several tasks can be in flight before the first one is awaited.
+// A task that has been started must be awaited before it is destroyed.
+template <typename T>
+class Task
+{
+public:
+	using promise_type = TaskPromise<T>;
+
+	Task() : handle(nullptr), started(false) {}
+	explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle), started(false) {}
+	Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)), started(other.started) {}
+	Task& operator=(Task&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (handle)
+			{
+				handle.destroy();
+			}
+			handle = std::exchange(other.handle, nullptr);
+			started = other.started;
+		}
+		return *this;
+	}
+	~Task()
+	{
+		if (handle)
+		{
+			handle.destroy();
+		}
+	}
+
+	// Runs the task until it first suspends. Does nothing if it has already been started.
+	void Start()
+	{
+		if (!started)
+		{
+			started = true;
+			handle.resume();
+		}
+	}
+
+	bool Done() const
+	{
+		return handle.promise().waiter.load(std::memory_order_acquire) == TaskPromiseBase::TaskDone();
+	}
+
+	struct Awaiter
+	{
+		Task& task;
+
+		bool await_ready() const { return task.started && task.Done(); }
+
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+		{
+			std::atomic<void*>& waiter = task.handle.promise().waiter;
+			if (!task.started)
+			{
+				// Nothing else can see an unstarted task, so run it now and let it resume us when it finishes.
+				task.started = true;
+				waiter.store(awaiting.address(), std::memory_order_relaxed);
+				return task.handle;
+			}
+			void* expected = nullptr;
+			if (waiter.compare_exchange_strong(expected, awaiting.address(), std::memory_order_acq_rel))
+			{
+				return std::noop_coroutine();
+			}
+			// Finished in the meantime.
+			return awaiting;
+		}
+
+		T await_resume()
+		{
+			if constexpr (!std::is_void_v<T>)
+			{
+				return std::move(*task.handle.promise().result);
+			}
+		}
+	};
+
+	Awaiter operator co_await() & { return Awaiter{*this}; }
+	Awaiter operator co_await() && { return Awaiter{*this}; }
+
+private:
+	std::coroutine_handle<promise_type> handle;
+	bool started;
+
+	Task(const Task&);
+	Task& operator=(const Task&);
+};
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object()
+{
+	return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object()
+{
+	return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// co_await Schedule(pool) moves the rest of the coroutine onto one of pool's workers.
+struct ScheduleAwaiter
+{
+	ThreadPool& pool;
+
+	bool await_ready() const { return false; }
+	void await_suspend(std::coroutine_handle<> h) { pool.Post([h] { h.resume(); }); }
+	void await_resume() const {}
+};
+
+inline ScheduleAwaiter Schedule(ThreadPool& pool)
+{
+	return ScheduleAwaiter{pool};
+}
+
+// A coroutine that starts at once and frees itself when it finishes; used by SyncWait.
+struct DetachedTask
+{
+	struct promise_type
+	{
+		DetachedTask get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() noexcept { std::terminate(); }
+	};
+};
+
+struct SyncWaitState
+{
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool done = false;
+};
+
+template <typename T>
+DetachedTask SignalWhenDone(Task<T>& task, SyncWaitState& state)
+{
+	co_await task;
+	std::lock_guard<std::mutex> lock(state.mutex);
+	state.done = true;
+	state.cv.notify_all();
+}
+
+// Runs task and blocks the calling thread until it finishes. For use from ordinary code, never
+//  from a coroutine or a pool job.
+template <typename T>
+T SyncWait(Task<T>& task)
+{
+	SyncWaitState state;
+	SignalWhenDone(task, state);
+	{
+		std::unique_lock<std::mutex> lock(state.mutex);
+		state.cv.wait(lock, [&] { return state.done; });
+	}
+	return typename Task<T>::Awaiter{task}.await_resume();
+}
+
+template <typename T>
+T SyncWait(Task<T>&& task)
+{
+	return SyncWait(task);
+}
+
+// A lazily evaluated sequence: each step of the loop resumes the coroutine up to its next co_yield.
+// Runs entirely on the thread iterating it.
+template <typename T>
+class Generator
+{
+public:
+	struct promise_type
+	{
+		const T* current = nullptr;
+
+		Generator get_return_object() { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		// The yielded value lives in the suspended frame until the next step, so keeping its address is safe.
+		std::suspend_always yield_value(const T& value)
+		{
+			current = &value;
+			return {};
+		}
+		void return_void() {}
+		void unhandled_exception() noexcept { std::terminate(); }
+	};
+
+	struct End {};
+
+	class Iterator
+	{
+	public:
+		explicit Iterator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+		const T& operator*() const { return *handle.promise().current; }
+		Iterator& operator++()
+		{
+			handle.resume();
+			return *this;
+		}
+		bool operator!=(End) const { return !handle.done(); }
+
+	private:
+		std::coroutine_handle<promise_type> handle;
+	};
+
+	explicit Generator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+	Generator(Generator&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+	~Generator()
+	{
+		if (handle)
+		{
+			handle.destroy();
+		}
+	}
+
+	Iterator begin()
+	{
+		handle.resume();
+		return Iterator(handle);
+	}
+	End end() { return End(); }
+
+private:
+	std::coroutine_handle<promise_type> handle;
+
+	Generator(const Generator&);
+	Generator& operator=(const Generator&);
+};
@@ -0,0 +1,61 @@
+/*
+Title: Vector Mathematics
+File Name: DVector2D.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <iostream>
+#include <math.h>
+
+#include "helpers.h"
+#include "Vector2D.h"
+
+struct DVector2D
+{
+	double x, y;
+
+	DVector2D();
+	DVector2D(double x, double y);
+};
+
+DVector2D operator-(DVector2D v);
+
+DVector2D operator+(DVector2D l, DVector2D r);
+DVector2D operator-(DVector2D l, DVector2D r);
+
+DVector2D operator*(double s, DVector2D v);
+DVector2D operator*(DVector2D v, double s);
+DVector2D operator/(DVector2D v, double s);
+
+bool operator==(DVector2D l, DVector2D r);
+bool operator!=(DVector2D l, DVector2D r);
+
+double Dot(DVector2D l, DVector2D r);
+
+DVector2D Project(DVector2D a, DVector2D b);
+DVector2D Reject(DVector2D a, DVector2D b);
+
+double Magnitude(DVector2D v);
+double MagInverse(DVector2D v);
+double MagSquared(DVector2D v);
+
+DVector2D ToDouble(Vector2D v);
+Vector2D ToFloat(DVector2D v);
+
+std::ostream& operator<<(std::ostream& os, DVector2D v);
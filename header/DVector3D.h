@@ -0,0 +1,73 @@
+/*
+Title: Vector Mathematics
+File Name: DVector3D.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <iostream>
+#include <math.h>
+
+#include "helpers.h"
+#include "Vector3D.h"
+
+// A double-precision Vector3D.
+// A float has 24 bits of mantissa, so a float coordinate 100 km from the origin can only be placed
+//  to within about a centimeter, which shows up as jitter in rendering and physics.
+// Doubles keep sub-micrometer precision out to the size of a planet. Use them to store positions in
+//  a large world, and WorldOrigin.h to turn them into float positions for the per-frame math.
+struct DVector3D
+{
+	double x, y, z;
+
+	DVector3D();
+	DVector3D(double x, double y, double z);
+};
+
+DVector3D operator-(DVector3D v);
+
+DVector3D operator+(DVector3D l, DVector3D r);
+DVector3D operator-(DVector3D l, DVector3D r);
+
+DVector3D operator*(double s, DVector3D v);
+DVector3D operator*(DVector3D v, double s);
+DVector3D operator/(DVector3D v, double s);
+
+bool operator==(DVector3D l, DVector3D r);
+bool operator!=(DVector3D l, DVector3D r);
+
+double Dot(DVector3D l, DVector3D r);
+
+DVector3D Project(DVector3D a, DVector3D b);
+DVector3D Reject(DVector3D a, DVector3D b);
+
+// Calculates the cross product of a and b according to the right-hand rule.
+DVector3D Cross(DVector3D a, DVector3D b);
+
+double Magnitude(DVector3D v);
+double MagInverse(DVector3D v);
+double MagSquared(DVector3D v);
+
+// Calculates the volume of the parallelepiped defined by a, b, and c.
+double ScalarTriple(DVector3D a, DVector3D b, DVector3D c);
+
+// Converts between single and double precision. ToFloat rounds each component to the nearest float.
+DVector3D ToDouble(Vector3D v);
+Vector3D ToFloat(DVector3D v);
+
+std::ostream& operator<<(std::ostream& os, DVector3D v);
@@ -0,0 +1,61 @@
+/*
+Title: Vector Mathematics
+File Name: DVector4D.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <iostream>
+#include <math.h>
+
+#include "helpers.h"
+#include "Vector4D.h"
+
+struct DVector4D
+{
+	double x, y, z, w;
+
+	DVector4D();
+	DVector4D(double x, double y, double z, double w);
+};
+
+DVector4D operator-(DVector4D v);
+
+DVector4D operator+(DVector4D l, DVector4D r);
+DVector4D operator-(DVector4D l, DVector4D r);
+
+DVector4D operator*(double s, DVector4D v);
+DVector4D operator*(DVector4D v, double s);
+DVector4D operator/(DVector4D v, double s);
+
+bool operator==(DVector4D l, DVector4D r);
+bool operator!=(DVector4D l, DVector4D r);
+
+double Dot(DVector4D l, DVector4D r);
+
+DVector4D Project(DVector4D a, DVector4D b);
+DVector4D Reject(DVector4D a, DVector4D b);
+
+double Magnitude(DVector4D v);
+double MagInverse(DVector4D v);
+double MagSquared(DVector4D v);
+
+DVector4D ToDouble(Vector4D v);
+Vector4D ToFloat(DVector4D v);
+
+std::ostream& operator<<(std::ostream& os, DVector4D v);
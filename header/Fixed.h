@@ -0,0 +1,194 @@
+/*
+Title: Vector Mathematics
+File Name: Fixed.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+
+// Fixed-point numbers for deterministic simulation.
+// Floating-point results can differ between compilers, optimization settings and CPUs (fused
+//  multiply-adds, x87 vs SSE, library sqrt), which breaks lockstep networking, where every machine
+//  must compute bit-identical states. Fixed-point math is plain integer math, which gives the same
+//  answer everywhere.
+// A fixed-point number is an integer raw standing for raw / 2^fractionBits.
+// Arithmetic rounds toward negative infinity, and division by zero saturates.
+
+// Q16.16: 16 integer bits and 16 fractional bits. Range about +-32768, resolution about 1.5e-5.
+struct Fixed
+{
+	int32_t raw;
+};
+
+// Q32.32: 32 integer bits and 32 fractional bits. Range about +-2.1e9, resolution about 2.3e-10.
+struct Fixed64
+{
+	int64_t raw;
+};
+
+// A signed 128-bit integer, the intermediate type for Fixed64 products.
+struct Int128
+{
+	uint64_t lo;
+	int64_t hi;
+};
+
+// Conversions round to the nearest representable value and saturate out of range. NaN becomes 0.
+// Convert inputs once, up front; converting back is only for display.
+Fixed ToFixed(float f);
+float ToFloat(Fixed f);
+Fixed64 ToFixed64(double d);
+double ToDouble(Fixed64 f);
+
+// The cheap operations are defined here in the header so that batch loops over them can be
+//  inlined. The Q16.16 dot and cross batches in FixedVector.cpp then vectorize on CPUs with AVX2.
+
+inline Fixed operator+(Fixed l, Fixed r) { Fixed f = { static_cast<int32_t>(static_cast<uint32_t>(l.raw) + static_cast<uint32_t>(r.raw)) }; return f; }
+inline Fixed operator-(Fixed l, Fixed r) { Fixed f = { static_cast<int32_t>(static_cast<uint32_t>(l.raw) - static_cast<uint32_t>(r.raw)) }; return f; }
+inline Fixed operator-(Fixed v) { Fixed f = { static_cast<int32_t>(0u - static_cast<uint32_t>(v.raw)) }; return f; }
+inline bool operator==(Fixed l, Fixed r) { return l.raw == r.raw; }
+inline bool operator!=(Fixed l, Fixed r) { return l.raw != r.raw; }
+inline bool operator<(Fixed l, Fixed r) { return l.raw < r.raw; }
+
+inline Fixed64 operator+(Fixed64 l, Fixed64 r) { Fixed64 f = { static_cast<int64_t>(static_cast<uint64_t>(l.raw) + static_cast<uint64_t>(r.raw)) }; return f; }
+inline Fixed64 operator-(Fixed64 l, Fixed64 r) { Fixed64 f = { static_cast<int64_t>(static_cast<uint64_t>(l.raw) - static_cast<uint64_t>(r.raw)) }; return f; }
+inline Fixed64 operator-(Fixed64 v) { Fixed64 f = { static_cast<int64_t>(0u - static_cast<uint64_t>(v.raw)) }; return f; }
+inline bool operator==(Fixed64 l, Fixed64 r) { return l.raw == r.raw; }
+inline bool operator!=(Fixed64 l, Fixed64 r) { return l.raw != r.raw; }
+inline bool operator<(Fixed64 l, Fixed64 r) { return l.raw < r.raw; }
+
+inline Int128 operator+(Int128 l, Int128 r)
+{
+	Int128 s;
+	s.lo = l.lo + r.lo;
+	s.hi = static_cast<int64_t>(static_cast<uint64_t>(l.hi) + static_cast<uint64_t>(r.hi) + (s.lo < l.lo ? 1 : 0));
+	return s;
+}
+
+inline Int128 operator-(Int128 l, Int128 r)
+{
+	Int128 s;
+	s.lo = l.lo - r.lo;
+	s.hi = static_cast<int64_t>(static_cast<uint64_t>(l.hi) - static_cast<uint64_t>(r.hi) - (l.lo < r.lo ? 1 : 0));
+	return s;
+}
+
+// Products are formed at double width, with all the fractional bits kept.
+// Sums of wide products, as in a dot product, lose nothing until they are narrowed with FromWide.
+
+// Q16.16 * Q16.16 = Q32.32
+inline int64_t MulWide(Fixed l, Fixed r)
+{
+	return static_cast<int64_t>(l.raw) * r.raw;
+}
+
+// Q16.16 * Q16.16 = Q32.32, for a square, which is never negative. Each is at most 2^62, so up to
+//  three of them sum without overflowing uint64_t.
+inline uint64_t SquareWide(Fixed f)
+{
+	return static_cast<uint64_t>(MulWide(f, f));
+}
+
+// Sums of wide products wrap on overflow like the narrow operator+, rather than overflowing int64_t,
+//  so the bits FromWide keeps are those of the exact sum.
+inline int64_t AddWide(int64_t l, int64_t r)
+{
+	return static_cast<int64_t>(static_cast<uint64_t>(l) + static_cast<uint64_t>(r));
+}
+
+// Narrows a Q32.32 product back to Q16.16.
+inline Fixed FromWide(int64_t w)
+{
+	Fixed f = { static_cast<int32_t>(w >> 16) };
+	return f;
+}
+
+// Q32.32 * Q32.32 = Q64.64
+inline Int128 MulWide(Fixed64 l, Fixed64 r)
+{
+	bool negative = (l.raw < 0) != (r.raw < 0);
+	uint64_t a = l.raw < 0 ? 0 - static_cast<uint64_t>(l.raw) : static_cast<uint64_t>(l.raw);
+	uint64_t b = r.raw < 0 ? 0 - static_cast<uint64_t>(r.raw) : static_cast<uint64_t>(r.raw);
+	uint64_t hi, lo;
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+	hi = static_cast<uint64_t>(product >> 64);
+	lo = static_cast<uint64_t>(product);
+#else
+	// Built from 32-bit halves for compilers without a 128-bit type.
+	uint64_t ll = (a & 0xffffffff) * (b & 0xffffffff);
+	uint64_t lh = (a & 0xffffffff) * (b >> 32);
+	uint64_t hl = (a >> 32) * (b & 0xffffffff);
+	uint64_t hh = (a >> 32) * (b >> 32);
+	uint64_t middle = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+	lo = (middle << 32) | (ll & 0xffffffff);
+	hi = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+#endif
+	Int128 p = { lo, static_cast<int64_t>(hi) };
+	if (negative)
+	{
+		Int128 zero = { 0, 0 };
+		p = zero - p;
+	}
+	return p;
+}
+
+// Q32.32 * Q32.32 = Q64.64, for a square. Sums of squares fit while their root fits in Q32.32.
+inline Int128 SquareWide(Fixed64 f)
+{
+	return MulWide(f, f);
+}
+
+inline Int128 AddWide(Int128 l, Int128 r)
+{
+	return l + r;
+}
+
+// Narrows a Q64.64 product back to Q32.32.
+inline Fixed64 FromWide(Int128 w)
+{
+	Fixed64 f = { static_cast<int64_t>((w.lo >> 32) | (static_cast<uint64_t>(w.hi) << 32)) };
+	return f;
+}
+
+inline Fixed operator*(Fixed l, Fixed r)
+{
+	return FromWide(MulWide(l, r));
+}
+
+inline Fixed64 operator*(Fixed64 l, Fixed64 r)
+{
+	return FromWide(MulWide(l, r));
+}
+
+Fixed operator/(Fixed l, Fixed r);
+Fixed64 operator/(Fixed64 l, Fixed64 r);
+
+// Square roots, computed exactly with integer arithmetic and rounded down. Negative inputs give 0.
+Fixed Sqrt(Fixed f);
+Fixed64 Sqrt(Fixed64 f);
+
+// The square root of a wide value, e.g. a sum of squares, returned at normal width.
+// Taking the root before narrowing keeps full precision and avoids overflowing on large vectors.
+Fixed SqrtWide(int64_t w);
+Fixed SqrtWide(uint64_t w);
+Fixed64 SqrtWide(Int128 w);
+
+// Integer square root: the largest r with r * r <= n.
+uint32_t IntSqrt(uint64_t n);
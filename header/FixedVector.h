@@ -0,0 +1,151 @@
+/*
+Title: Vector Mathematics
+File Name: FixedVector.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+
+#include "DVector2D.h"
+#include "DVector3D.h"
+#include "Fixed.h"
+#include "Vector2D.h"
+#include "Vector3D.h"
+
+// Fixed-point vectors for deterministic simulation. See Fixed.h for why.
+// The vector types are templates over the scalar type so that Q16.16 and Q32.32 vectors share one
+//  definition of each operation. Use the typedefs below rather than the templates directly.
+// Dot products, lengths and cross products sum the full-width products before narrowing, so they
+//  round only once. A dot product too large for the format wraps like operator+; lengths are summed
+//  unsigned and saturate.
+
+template <typename Scalar>
+struct FixedVector2T
+{
+	Scalar x, y;
+
+	FixedVector2T() : x(), y() {}
+	FixedVector2T(Scalar x, Scalar y) : x(x), y(y) {}
+};
+
+template <typename Scalar>
+struct FixedVector3T
+{
+	Scalar x, y, z;
+
+	FixedVector3T() : x(), y(), z() {}
+	FixedVector3T(Scalar x, Scalar y, Scalar z) : x(x), y(y), z(z) {}
+};
+
+// Q16.16 vectors
+typedef FixedVector2T<Fixed> FixedVector2D;
+typedef FixedVector3T<Fixed> FixedVector3D;
+// Q32.32 vectors
+typedef FixedVector2T<Fixed64> Fixed64Vector2D;
+typedef FixedVector3T<Fixed64> Fixed64Vector3D;
+
+template <typename S> FixedVector2T<S> operator-(FixedVector2T<S> v) { return FixedVector2T<S>(-v.x, -v.y); }
+template <typename S> FixedVector3T<S> operator-(FixedVector3T<S> v) { return FixedVector3T<S>(-v.x, -v.y, -v.z); }
+
+template <typename S> FixedVector2T<S> operator+(FixedVector2T<S> l, FixedVector2T<S> r) { return FixedVector2T<S>(l.x + r.x, l.y + r.y); }
+template <typename S> FixedVector3T<S> operator+(FixedVector3T<S> l, FixedVector3T<S> r) { return FixedVector3T<S>(l.x + r.x, l.y + r.y, l.z + r.z); }
+template <typename S> FixedVector2T<S> operator-(FixedVector2T<S> l, FixedVector2T<S> r) { return FixedVector2T<S>(l.x - r.x, l.y - r.y); }
+template <typename S> FixedVector3T<S> operator-(FixedVector3T<S> l, FixedVector3T<S> r) { return FixedVector3T<S>(l.x - r.x, l.y - r.y, l.z - r.z); }
+
+template <typename S> FixedVector2T<S> operator*(S s, FixedVector2T<S> v) { return FixedVector2T<S>(s * v.x, s * v.y); }
+template <typename S> FixedVector3T<S> operator*(S s, FixedVector3T<S> v) { return FixedVector3T<S>(s * v.x, s * v.y, s * v.z); }
+template <typename S> FixedVector2T<S> operator*(FixedVector2T<S> v, S s) { return s * v; }
+template <typename S> FixedVector3T<S> operator*(FixedVector3T<S> v, S s) { return s * v; }
+
+template <typename S> bool operator==(FixedVector2T<S> l, FixedVector2T<S> r) { return l.x == r.x && l.y == r.y; }
+template <typename S> bool operator==(FixedVector3T<S> l, FixedVector3T<S> r) { return l.x == r.x && l.y == r.y && l.z == r.z; }
+template <typename S> bool operator!=(FixedVector2T<S> l, FixedVector2T<S> r) { return !(l == r); }
+template <typename S> bool operator!=(FixedVector3T<S> l, FixedVector3T<S> r) { return !(l == r); }
+
+template <typename S> S Dot(FixedVector2T<S> l, FixedVector2T<S> r)
+{
+	return FromWide(AddWide(MulWide(l.x, r.x), MulWide(l.y, r.y)));
+}
+
+template <typename S> S Dot(FixedVector3T<S> l, FixedVector3T<S> r)
+{
+	return FromWide(AddWide(AddWide(MulWide(l.x, r.x), MulWide(l.y, r.y)), MulWide(l.z, r.z)));
+}
+
+template <typename S> FixedVector3T<S> Cross(FixedVector3T<S> a, FixedVector3T<S> b)
+{
+	return FixedVector3T<S>(FromWide(MulWide(a.y, b.z) - MulWide(a.z, b.y)),
+							FromWide(MulWide(a.z, b.x) - MulWide(a.x, b.z)),
+							FromWide(MulWide(a.x, b.y) - MulWide(a.y, b.x)));
+}
+
+// |v|, from the exact sum of squares. Q16.16 lengths too large for the format saturate; Q32.32
+//  lengths must fit in the format.
+template <typename S> S Magnitude(FixedVector2T<S> v)
+{
+	return SqrtWide(SquareWide(v.x) + SquareWide(v.y));
+}
+
+template <typename S> S Magnitude(FixedVector3T<S> v)
+{
+	return SqrtWide(SquareWide(v.x) + SquareWide(v.y) + SquareWide(v.z));
+}
+
+// Projection of a onto b. a . b and |b|^2 must fit in the format, so keep |a| and |b| below about
+//  180 for Q16.16, or about 46000 for Q32.32.
+template <typename S> FixedVector2T<S> Project(FixedVector2T<S> a, FixedVector2T<S> b)
+{
+	return (Dot(a, b) / Dot(b, b)) * b;
+}
+
+template <typename S> FixedVector3T<S> Project(FixedVector3T<S> a, FixedVector3T<S> b)
+{
+	return (Dot(a, b) / Dot(b, b)) * b;
+}
+
+template <typename S> FixedVector2T<S> Reject(FixedVector2T<S> a, FixedVector2T<S> b) { return a - Project(a, b); }
+template <typename S> FixedVector3T<S> Reject(FixedVector3T<S> a, FixedVector3T<S> b) { return a - Project(a, b); }
+
+// Conversions to and from the floating-point vector types.
+FixedVector2D ToFixed(Vector2D v);
+FixedVector3D ToFixed(Vector3D v);
+Vector2D ToFloat(FixedVector2D v);
+Vector3D ToFloat(FixedVector3D v);
+Fixed64Vector2D ToFixed64(DVector2D v);
+Fixed64Vector3D ToFixed64(DVector3D v);
+DVector2D ToDouble(Fixed64Vector2D v);
+DVector3D ToDouble(Fixed64Vector3D v);
+
+// Batch operations over arrays, out[i] = op(a[i], b[i]).
+void DotBatch(const FixedVector3D* a, const FixedVector3D* b, Fixed* out, size_t count);
+void CrossBatch(const FixedVector3D* a, const FixedVector3D* b, FixedVector3D* out, size_t count);
+void MagnitudeBatch(const FixedVector3D* in, Fixed* out, size_t count);
+void ProjectBatch(const FixedVector3D* a, const FixedVector3D* b, FixedVector3D* out, size_t count);
+
+void DotBatch(const Fixed64Vector3D* a, const Fixed64Vector3D* b, Fixed64* out, size_t count);
+void CrossBatch(const Fixed64Vector3D* a, const Fixed64Vector3D* b, Fixed64Vector3D* out, size_t count);
+void MagnitudeBatch(const Fixed64Vector3D* in, Fixed64* out, size_t count);
+void ProjectBatch(const Fixed64Vector3D* a, const Fixed64Vector3D* b, Fixed64Vector3D* out, size_t count);
+
+// Prints the vector converted to floating point.
+std::ostream& operator<<(std::ostream& os, FixedVector2D v);
+std::ostream& operator<<(std::ostream& os, FixedVector3D v);
+std::ostream& operator<<(std::ostream& os, Fixed64Vector2D v);
+std::ostream& operator<<(std::ostream& os, Fixed64Vector3D v);
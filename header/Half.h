@@ -0,0 +1,51 @@
+/*
+Title: Vector Mathematics
+File Name: Half.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// IEEE 754 half precision (binary16) floats, stored as raw uint16_t bits.
+// A half has a 10-bit mantissa, so it keeps about 3 decimal digits, and its largest finite
+//  value is 65504. It is a storage format only; all math is done after converting back to float.
+// bfloat16 is the other common 16-bit format: the top half of a float. It keeps float's range
+//  but only 8 bits of mantissa, about 2 decimal digits.
+
+// Converts f to the nearest half, rounding ties to even. Values too large become infinity.
+uint16_t FloatToHalf(float f);
+// Converts h to float. Every half is exactly representable as a float.
+float HalfToFloat(uint16_t h);
+
+// Converts count values at a time.
+// On x86 CPUs with the F16C extension these use its hardware conversion instructions.
+void FloatToHalf(const float* in, uint16_t* out, size_t count);
+void HalfToFloat(const uint16_t* in, float* out, size_t count);
+
+// True if the batch conversions above are using F16C.
+bool HalfHardwareConversion();
+
+// Converts f to the nearest bfloat16, rounding ties to even. NaNs stay NaN.
+uint16_t FloatToBFloat16(float f);
+// Converts b to float, exactly.
+float BFloat16ToFloat(uint16_t b);
+
+void FloatToBFloat16(const float* in, uint16_t* out, size_t count);
+void BFloat16ToFloat(const uint16_t* in, float* out, size_t count);
@@ -0,0 +1,79 @@
+/*
+Title: Vector Mathematics
+File Name: HalfVector.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Half.h"
+#include "Vector3D.h"
+#include "Vector4D.h"
+
+// Vectors stored with 16-bit components, at half the size of Vector3D and Vector4D.
+// Kernels over very large arrays are limited by how fast memory can deliver the data, not by
+//  the math, so halving the bytes per vector can nearly double their speed.
+// These types are for storage only. The kernels below load a block, convert it to float,
+//  compute on it with the ordinary float kernels, and convert the results back.
+
+// Vectors with IEEE half components. See Half.h for the range and precision.
+struct HalfVector3D
+{
+	uint16_t x, y, z;
+};
+
+struct HalfVector4D
+{
+	uint16_t x, y, z, w;
+};
+
+// Vectors with bfloat16 components: float's range, with less precision than half.
+struct BFloat16Vector3D
+{
+	uint16_t x, y, z;
+};
+
+struct BFloat16Vector4D
+{
+	uint16_t x, y, z, w;
+};
+
+// Whole-array conversions.
+void EncodeHalf(const Vector3D* in, size_t count, HalfVector3D* out);
+void EncodeHalf(const Vector4D* in, size_t count, HalfVector4D* out);
+void DecodeHalf(const HalfVector3D* in, size_t count, Vector3D* out);
+void DecodeHalf(const HalfVector4D* in, size_t count, Vector4D* out);
+
+void EncodeBFloat16(const Vector3D* in, size_t count, BFloat16Vector3D* out);
+void EncodeBFloat16(const Vector4D* in, size_t count, BFloat16Vector4D* out);
+void DecodeBFloat16(const BFloat16Vector3D* in, size_t count, Vector3D* out);
+void DecodeBFloat16(const BFloat16Vector4D* in, size_t count, Vector4D* out);
+
+// out[i] = in[i] / |in[i]|, computed in float.
+void NormalizeBatch(const HalfVector3D* in, HalfVector3D* out, size_t count);
+void NormalizeBatch(const HalfVector4D* in, HalfVector4D* out, size_t count);
+void NormalizeBatch(const BFloat16Vector3D* in, BFloat16Vector3D* out, size_t count);
+void NormalizeBatch(const BFloat16Vector4D* in, BFloat16Vector4D* out, size_t count);
+
+// out[i] = Dot(a[i], b[i]), computed and stored in float.
+void DotBatch(const HalfVector3D* a, const HalfVector3D* b, float* out, size_t count);
+void DotBatch(const HalfVector4D* a, const HalfVector4D* b, float* out, size_t count);
+void DotBatch(const BFloat16Vector3D* a, const BFloat16Vector3D* b, float* out, size_t count);
+void DotBatch(const BFloat16Vector4D* a, const BFloat16Vector4D* b, float* out, size_t count);
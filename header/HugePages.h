@@ -0,0 +1,90 @@
+/*
+Title: Vector Mathematics
+File Name: HugePages.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+// Memory for very large vector arrays, backed by 2 MB huge pages where the system allows.
+// With 4 KB pages, sweeping an array of hundreds of millions of Vector4D needs a new TLB entry every
+//  256 vectors, and the TLB holds only a few thousand; much of the sweep goes to page walks. One
+//  2 MB page covers 131072 vectors instead.
+// Linux offers two kinds: explicit huge pages (MAP_HUGETLB) come from a pool reserved by the
+//  administrator in /proc/sys/vm/nr_hugepages and are guaranteed, but the pool is usually empty;
+//  transparent huge pages are requested with madvise and backed as the kernel finds free 2 MB runs.
+// Everything falls back to ordinary pages, and reports what it actually got.
+
+const size_t HUGE_PAGE_SIZE = 2 << 20;
+
+enum class PageKind
+{
+	// Ordinary pages; huge pages were not asked for or not available.
+	Normal,
+	// Marked for transparent huge pages. How much is really backed by them shows in HugePageBytes.
+	Transparent,
+	// Explicit huge pages from the reserved pool.
+	Explicit,
+};
+
+struct PageBlock
+{
+	void* data;
+	size_t size;
+	PageKind kind;
+};
+
+// Maps zeroed memory for bytes, aligned to at least 64 bytes, trying explicit then transparent huge
+//  pages when hugePages is set. data is nullptr if even ordinary pages could not be had.
+PageBlock AllocatePages(size_t bytes, bool hugePages);
+void FreePages(const PageBlock& block);
+
+// The size AllocatePages maps for bytes. It never depends on which kind of page was obtained, so a
+//  block can be freed knowing only its address and the size that was asked for.
+size_t PageBlockSize(size_t bytes, bool hugePages);
+
+// Bytes of [p, p + bytes) currently backed by huge pages of either kind, from /proc/self/smaps.
+// Pages are only allocated when first touched, so fill the memory before asking. 0 where unsupported.
+size_t HugePageBytes(const void* p, size_t bytes);
+
+// A memory_resource giving every allocation its own huge-page mapping, for a few very large
+//  containers rather than many small ones:
+//   HugePageResource hugePages;
+//   VectorBuffer4D points(count, &hugePages);
+// Thread safe. Running out of memory throws std::bad_alloc, as std::pmr requires.
+class HugePageResource : public std::pmr::memory_resource
+{
+public:
+	HugePageResource();
+
+	// What backed the most recent allocation.
+	PageKind LastKind() const;
+
+private:
+	std::atomic<PageKind> lastKind;
+
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	HugePageResource(const HugePageResource&);
+	HugePageResource& operator=(const HugePageResource&);
+};
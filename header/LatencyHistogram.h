@@ -0,0 +1,108 @@
+/*
+Title: Vector Mathematics
+File Name: LatencyHistogram.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// Distributions of per-call times, for the tail latency a mean hides: page faults, a thread
+//  losing its core, or the clock dropping under thermal load.
+// Values are bucketed log-linearly, as in HdrHistogram: exact below 128, and within 1/64 of the
+//  true value above that, up to 2^40 (about 18 minutes in nanoseconds). Larger values land in the
+//  last bucket, though Max still reports them exactly.
+
+inline uint64_t LatencyNanoseconds()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// A histogram for one thread. Histograms recorded on different threads combine with Merge.
+class LatencyHistogram
+{
+public:
+	LatencyHistogram();
+
+	void Record(uint64_t value);
+	void Merge(const LatencyHistogram& other);
+	void Clear();
+
+	uint64_t Count() const;
+	uint64_t Min() const;
+	uint64_t Max() const;
+	double Mean() const;
+
+	// The value at or below which the given fraction of values fall, e.g. 0.999 for p99.9.
+	// Reported as the top of its bucket, but never above Max. Returns 0 if nothing was recorded.
+	uint64_t Percentile(double fraction) const;
+
+	// Prints one line: name, count, mean, p50, p99, p99.9 and max, taking values as nanoseconds.
+	void Print(FILE* out, const char* name) const;
+
+private:
+	std::vector<uint64_t> counts;
+	uint64_t count;
+	uint64_t min;
+	uint64_t max;
+	double sum;
+
+	friend class LatencyRecorder;
+};
+
+// Records from any number of threads at once without locks. Each thread adds to one of several
+//  stripes of atomic counters, picked once per thread, so threads rarely touch the same counters.
+class LatencyRecorder
+{
+public:
+	// stripes = 0 uses one per hardware thread.
+	explicit LatencyRecorder(unsigned stripes = 0);
+	~LatencyRecorder();
+
+	void Record(uint64_t nanoseconds);
+
+	// Runs f and records how long it took, e.g. around one batch kernel call.
+	template <typename F>
+	void Measure(F f)
+	{
+		uint64_t start = LatencyNanoseconds();
+		f();
+		Record(LatencyNanoseconds() - start);
+	}
+
+	// Merges the stripes. Values recorded while it runs may or may not be included.
+	LatencyHistogram Snapshot() const;
+
+	// Must not run at the same time as Record.
+	void Clear();
+
+private:
+	struct Stripe;
+
+	std::unique_ptr<Stripe[]> stripes;
+	unsigned stripeCount;
+
+	LatencyRecorder(const LatencyRecorder&);
+	LatencyRecorder& operator=(const LatencyRecorder&);
+};
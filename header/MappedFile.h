@@ -0,0 +1,48 @@
+/*
+Title: Vector Mathematics
+File Name: MappedFile.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+
+// A read-only view of a whole file, mapped into memory.
+// On POSIX systems the file is memory-mapped, so opening even a very large file is nearly free;
+//  pages are only read from disk when they are first touched.
+// On Windows the file is simply read into memory.
+struct MappedFile
+{
+	const char* data;
+	size_t size;
+
+	MappedFile();
+	~MappedFile();
+
+	// Maps the file at path. Returns false if the file could not be opened.
+	bool Open(const char* path);
+	// Unmaps the file. Safe to call on a file that was never opened.
+	void Close();
+
+private:
+	bool mapped;
+
+	// A mapping owns its memory, so it cannot be copied.
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+};
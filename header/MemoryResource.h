@@ -0,0 +1,117 @@
+/*
+Title: Vector Mathematics
+File Name: MemoryResource.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+#include "Vector2D.h"
+#include "Vector3D.h"
+#include "Vector4D.h"
+
+// Allocators for the many short-lived vector buffers a frame of simulation creates.
+// Each std::vector<Vector3D> temporary costs a malloc and a free, which take locks, walk free
+//  lists, and hand back memory with no particular alignment. Both resources here plug into
+//  std::pmr, so any VectorBuffer3D (or other std::pmr container) can draw from them:
+//   FrameArena arena;
+//   VectorBuffer3D velocities(count, &arena);
+// Every allocation is aligned to at least VECTOR_ALLOCATION_ALIGNMENT bytes, and the memory they
+//  get from the system can be backed by 2 MB huge pages where available.
+// Neither resource is thread safe; give each thread its own, as with std::pmr::unsynchronized_pool_resource.
+// As std::pmr requires, running out of memory throws std::bad_alloc rather than returning nullptr.
+
+// A cache line, and enough for any SIMD load.
+const size_t VECTOR_ALLOCATION_ALIGNMENT = 64;
+
+using VectorBuffer2D = std::pmr::vector<Vector2D>;
+using VectorBuffer3D = std::pmr::vector<Vector3D>;
+using VectorBuffer4D = std::pmr::vector<Vector4D>;
+
+// Hands out memory by bumping a pointer and frees it all at once with Reset, at the end of a frame.
+// Deallocating a single allocation does nothing; containers using the arena must not outlive the frame.
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+	// blockSize is how much to reserve from the system at a time.
+	explicit FrameArena(size_t blockSize = 1 << 20, bool hugePages = false);
+	~FrameArena();
+
+	// Frees everything allocated since the last reset. The largest block is kept, so once frames reach
+	//  a steady size the arena stops going to the system at all.
+	void Reset();
+
+	size_t BytesUsed() const;
+	size_t BytesReserved() const;
+
+private:
+	struct Block;
+
+	Block* blocks;
+	char* cursor;
+	char* limit;
+	size_t blockSize;
+	size_t used;
+	size_t reserved;
+	bool hugePages;
+
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	FrameArena(const FrameArena&);
+	FrameArena& operator=(const FrameArena&);
+};
+
+// Keeps freed allocations on per-size free lists for reuse, for buffers that do not share a lifetime.
+// Requests are rounded up to a power of two from 64 bytes to maxClassBytes, and each size is carved
+//  out of slabs taken from the system. Larger requests go straight to the system.
+// Memory is only returned to the system when the pool is destroyed.
+class SizeClassPool : public std::pmr::memory_resource
+{
+public:
+	explicit SizeClassPool(size_t maxClassBytes = 1 << 20, bool hugePages = false);
+	~SizeClassPool();
+
+	size_t BytesReserved() const;
+
+private:
+	struct FreeBlock;
+	struct Slab;
+
+	static const int CLASS_COUNT = 48;
+
+	FreeBlock* freeLists[CLASS_COUNT];
+	// Unused space at the end of each class's newest slab.
+	char* cursor[CLASS_COUNT];
+	char* limit[CLASS_COUNT];
+	Slab* slabs;
+	size_t maxClassBytes;
+	size_t reserved;
+	bool hugePages;
+
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	SizeClassPool(const SizeClassPool&);
+	SizeClassPool& operator=(const SizeClassPool&);
+};
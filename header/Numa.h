@@ -0,0 +1,172 @@
+/*
+Title: Vector Mathematics
+File Name: Numa.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Placement of large vector arrays on machines with several NUMA nodes (usually one per socket).
+// Linux puts each page on the node of the thread that first writes to it. An array filled by one
+//  thread therefore lives entirely on one node, and threads on the other sockets reach it over the
+//  interconnect at a fraction of the bandwidth. The fix is to have every thread first touch exactly
+//  the part of the array it will process later, and to keep each thread on one node so that part
+//  stays local. NumaThreadPool pins its workers and always splits a loop the same way, and NumaArray
+//  places pages to match.
+// Topology comes from /sys/devices/system/node; elsewhere, or on a single-node machine, everything
+//  still works as one node.
+
+struct NumaTopology
+{
+	// CPUs of each node that this process may run on. Nodes without any are left out.
+	std::vector<std::vector<int>> nodeCpus;
+	// The kernel's node number for each entry of nodeCpus.
+	std::vector<int> nodeIds;
+
+	static NumaTopology Detect();
+
+	unsigned NodeCount() const;
+};
+
+// Pins the calling thread to cpus. Returns false if that is not possible here.
+bool PinCurrentThread(const std::vector<int>& cpus);
+
+// A pool whose workers are pinned to CPUs, spread evenly over the nodes.
+// Unlike ThreadPool, loops are split statically: worker w always gets the same slice of [0, count),
+//  with node 0's workers taking the first slices, node 1's the next, and so on. That fixed split is
+//  what lets the pages a worker touched first stay on its node for every later pass.
+// The calling thread only waits; it is not pinned, so it does no part of the loop.
+class NumaThreadPool
+{
+public:
+	// threads = 0 starts one worker per available CPU.
+	explicit NumaThreadPool(unsigned threads = 0);
+	~NumaThreadPool();
+
+	const NumaTopology& Topology() const;
+	unsigned Size() const;
+	// False if any worker could not be pinned, in which case placement is only a hint.
+	bool Pinned() const;
+
+	// Calls body(begin, end, node) once per worker with its slice of [0, count), and returns when all are done.
+	// Only one thread may call ParallelFor at a time.
+	void ParallelFor(size_t count, const std::function<void(size_t, size_t, unsigned)>& body);
+
+	// The part of [0, count) that ParallelFor gives to node's workers.
+	void NodeRange(unsigned node, size_t count, size_t& begin, size_t& end) const;
+
+private:
+	struct Worker
+	{
+		std::thread thread;
+		int cpu;
+		unsigned node;
+	};
+
+	NumaTopology topology;
+	std::vector<Worker> workers;
+	// Index of node n's first worker, and one past its last.
+	std::vector<unsigned> nodeFirst;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	const std::function<void(size_t, size_t, unsigned)>* body;
+	size_t count;
+	unsigned busy;
+	unsigned pinFailures;
+	unsigned long long generation;
+	bool stopping;
+
+	void WorkerLoop(unsigned index);
+
+	NumaThreadPool(const NumaThreadPool&);
+	NumaThreadPool& operator=(const NumaThreadPool&);
+};
+
+enum class NumaPlacement
+{
+	// Zeroed by the calling thread, so every page lands on its node: what a plain std::vector gives.
+	Local,
+	// One contiguous array, with each pool worker zeroing its own slice first.
+	FirstTouch,
+	// A separate allocation per node, bound to that node with mbind, then zeroed by its workers.
+	Partitioned,
+};
+
+// Zeroed storage for count elements of elementSize bytes, placed for a NumaThreadPool's loops.
+// Element i is at Span(i); the pointer stays valid for contiguous access up to the end of the node
+//  range holding i, which always covers the slice a ParallelFor body is given.
+class NumaBuffer
+{
+public:
+	// Check Data() for nullptr: allocation fails rather than throwing.
+	NumaBuffer(size_t count, size_t elementSize, NumaThreadPool& pool, NumaPlacement placement);
+	~NumaBuffer();
+
+	void* Span(size_t index) const;
+	// First element, or nullptr if allocation failed. Only the whole array for Local and FirstTouch.
+	void* Data() const;
+	size_t Count() const;
+	NumaPlacement Placement() const;
+	// Whether every Partitioned segment was bound to its node; false where mbind is unavailable.
+	bool Bound() const;
+
+private:
+	struct Segment
+	{
+		char* data;
+		size_t bytes;
+		size_t begin;
+		size_t end;
+	};
+
+	std::vector<Segment> segments;
+	size_t count;
+	size_t elementSize;
+	NumaPlacement placement;
+	bool bound;
+
+	NumaBuffer(const NumaBuffer&);
+	NumaBuffer& operator=(const NumaBuffer&);
+};
+
+// A NumaBuffer of vectors.
+template <typename V>
+class NumaArray
+{
+public:
+	NumaArray(size_t count, NumaThreadPool& pool, NumaPlacement placement)
+		: buffer(count, sizeof(V), pool, placement)
+	{
+	}
+
+	V* Span(size_t index) const { return static_cast<V*>(buffer.Span(index)); }
+	bool Valid() const { return buffer.Data() != nullptr || buffer.Count() == 0; }
+	size_t Count() const { return buffer.Count(); }
+	NumaPlacement Placement() const { return buffer.Placement(); }
+	bool Bound() const { return buffer.Bound(); }
+
+private:
+	NumaBuffer buffer;
+};
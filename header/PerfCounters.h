@@ -0,0 +1,116 @@
+/*
+Title: Vector Mathematics
+File Name: PerfCounters.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Hardware performance counters around kernel calls, to tell why a kernel got slower.
+// Time alone cannot separate cache misses from branch misses from the clock dropping; the counters
+//  can. Cycles over time gives the real clock rate, instructions over cycles (IPC) shows whether
+//  the core is stalling, and misses per kilobyte point at the cache level that is.
+// Counters come from perf_event_open on Linux and count only the calling thread, in user mode.
+// Any counter the machine, virtual machine or perf_event_paranoid setting refuses is simply
+//  reported as unavailable; without any, only times are reported.
+
+enum class PerfEvent
+{
+	Cycles,
+	Instructions,
+	L1DataMisses,
+	LastLevelMisses,
+	BranchMisses,
+	// CPU time in nanoseconds, a software counter that works even where the hardware ones do not.
+	TaskClock,
+	Count,
+};
+
+const int PERF_EVENT_COUNT = static_cast<int>(PerfEvent::Count);
+
+struct PerfSample
+{
+	uint64_t values[PERF_EVENT_COUNT];
+	bool valid[PERF_EVENT_COUNT];
+	double seconds;
+};
+
+// A group of counters for the calling thread. Create and use it on the same thread.
+class PerfCounters
+{
+public:
+	PerfCounters();
+	~PerfCounters();
+
+	// Whether the given counter could be opened.
+	bool Has(PerfEvent event) const;
+
+	void Start();
+	// Stops counting and returns the counts since Start, scaled up if the kernel had to multiplex them.
+	PerfSample Stop();
+
+private:
+	int fds[PERF_EVENT_COUNT];
+	// Counters in the order the group reports them; the first open one leads the group.
+	int order[PERF_EVENT_COUNT];
+	int opened;
+	int leader;
+	double startTime;
+
+	PerfCounters(const PerfCounters&);
+	PerfCounters& operator=(const PerfCounters&);
+};
+
+// Accumulates counters per kernel name and prints a table of derived rates.
+// Measure runs f once between Start and Stop; bytes is how much memory f reads and writes.
+class KernelProfiler
+{
+public:
+	template <typename F>
+	void Measure(const char* name, size_t bytes, F f)
+	{
+		counters.Start();
+		f();
+		Add(name, bytes, counters.Stop());
+	}
+
+	// One line per kernel: calls, wall and CPU time, GHz, IPC, bytes per cycle, L1 and LLC misses per KB,
+	//  and branch misses per thousand instructions. Rates needing an unavailable counter print as "-".
+	void Print(FILE* out) const;
+
+	void Clear();
+
+private:
+	struct Entry
+	{
+		std::string name;
+		size_t calls;
+		uint64_t bytes;
+		PerfSample total;
+	};
+
+	PerfCounters counters;
+	std::vector<Entry> entries;
+
+	void Add(const char* name, size_t bytes, const PerfSample& sample);
+};
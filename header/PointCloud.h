@@ -0,0 +1,125 @@
+/*
+Title: Vector Mathematics
+File Name: PointCloud.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Vector3D.h"
+
+// Streaming readers for point clouds stored as PLY (ASCII or binary), OBJ, or plain XYZ text.
+// Scans can hold hundreds of millions of points, far more than we want in memory at once, so
+//  the reader hands out points a fixed-size chunk at a time. A background thread reads the file
+//  ahead of the parser, so the disk and the parser work at the same time, and the caller can
+//  start processing the first chunk long before the last one has been read.
+
+enum class PointCloudFormat
+{
+	Unknown,
+	// One point per line, "x y z" or "x,y,z"; anything after the third number is ignored.
+	XYZ,
+	// Wavefront OBJ; only the "v x y z" lines are read.
+	OBJ,
+	PLY,
+};
+
+// A chunk of points in SoA layout: point i is (x[i], y[i], z[i]).
+struct PointChunk
+{
+	std::vector<float> x, y, z;
+	size_t count;
+
+	PointChunk();
+
+	Vector3D Get(size_t i) const;
+};
+
+class PointCloudReader
+{
+public:
+	PointCloudReader();
+	~PointCloudReader();
+
+	// Opens path and reads its header. The format is detected from the file contents and extension.
+	// At most chunkPoints points are returned by each call to Next.
+	bool Open(const char* path, size_t chunkPoints = 1 << 16);
+	void Close();
+
+	// Reads the next chunk of points into chunk.
+	// Returns false once the file is exhausted or an error occurs; check Failed() to tell which.
+	bool Next(PointChunk& chunk);
+
+	bool Failed() const;
+	PointCloudFormat Format() const;
+	// The number of points declared in a PLY header, or 0 if the format does not say.
+	size_t DeclaredCount() const;
+
+private:
+	// Types a PLY property can have.
+	enum class PropertyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+	FILE* file;
+	PointCloudFormat format;
+	size_t chunkPoints;
+	bool failed;
+
+	// PLY vertex layout.
+	bool binary;
+	bool bigEndian;
+	size_t vertexCount;
+	size_t verticesRead;
+	size_t vertexStride;
+	int xyzProperty[3];
+	size_t xyzOffset[3];
+	PropertyType xyzType[3];
+	std::vector<PropertyType> properties;
+
+	// Bytes received from the reader thread and not yet parsed are window[pos, end).
+	std::vector<char> window;
+	size_t pos, end;
+	bool eof;
+
+	// Reader thread state: full blocks wait in filled, empty ones are recycled through spare.
+	std::thread reader;
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::deque<std::vector<char> > filled;
+	std::vector<std::vector<char> > spare;
+	bool readerDone;
+	bool stopping;
+
+	void ReaderLoop();
+	bool Pull();
+	bool NextLine(const char*& line, const char*& lineEnd);
+	const char* NextBytes(size_t n);
+	bool ReadPlyHeader();
+	bool ParseTextPoint(const char* line, const char* lineEnd, float* xyz);
+	bool ParsePlyAsciiPoint(const char* line, const char* lineEnd, float* xyz);
+	float DecodeProperty(const char* p, PropertyType type) const;
+
+	PointCloudReader(const PointCloudReader&);
+	PointCloudReader& operator=(const PointCloudReader&);
+};
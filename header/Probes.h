@@ -0,0 +1,109 @@
+/*
+Title: Vector Mathematics
+File Name: Probes.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+// Per-operation probes for the scalar vector functions.
+// Configure with -DVECTOR_MATH_PROBES=ON to count every call and time one call in PROBE_SAMPLE_PERIOD;
+// the totals are printed to stderr when the process exits. Without it VECTOR_PROBE expands to nothing.
+
+#ifdef VECTOR_MATH_PROBES
+
+#include <atomic>
+#include <cstdio>
+
+const unsigned PROBE_MAX_SITES = 256;
+const unsigned PROBE_SAMPLE_PERIOD = 64;
+
+// A named probe point. Ids are handed out as sites are first reached; sites past PROBE_MAX_SITES share the last slot.
+struct ProbeSite
+{
+	const char* name;
+	unsigned id;
+
+	explicit ProbeSite(const char* name);
+};
+
+// One thread's counters. Only the owning thread writes them, so the atomics are only there to make the report's reads well defined.
+struct ProbeCounters
+{
+	std::atomic<unsigned long long> calls[PROBE_MAX_SITES];
+	std::atomic<unsigned long long> samples[PROBE_MAX_SITES];
+	std::atomic<unsigned long long> sampleNanos[PROBE_MAX_SITES];
+
+	ProbeCounters();
+	// Folds the counts into the process totals when the thread exits.
+	~ProbeCounters();
+
+private:
+	ProbeCounters(const ProbeCounters&);
+	ProbeCounters& operator=(const ProbeCounters&);
+};
+
+extern thread_local ProbeCounters threadProbes;
+
+unsigned long long ProbeNanoseconds();
+
+// Counts the call on construction; sampled calls are timed until destruction, including any probed calls they make.
+class ProbeScope
+{
+public:
+	explicit ProbeScope(const ProbeSite& site)
+		: counters(&threadProbes), id(site.id), start(0)
+	{
+		unsigned long long n = counters->calls[id].load(std::memory_order_relaxed);
+		counters->calls[id].store(n + 1, std::memory_order_relaxed);
+		sampled = n % PROBE_SAMPLE_PERIOD == 0;
+		if (sampled)
+		{
+			start = ProbeNanoseconds();
+		}
+	}
+
+	~ProbeScope()
+	{
+		if (sampled)
+		{
+			unsigned long long elapsed = ProbeNanoseconds() - start;
+			counters->samples[id].store(counters->samples[id].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			counters->sampleNanos[id].store(counters->sampleNanos[id].load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+		}
+	}
+
+private:
+	ProbeCounters* counters;
+	unsigned id;
+	bool sampled;
+	unsigned long long start;
+
+	ProbeScope(const ProbeScope&);
+	ProbeScope& operator=(const ProbeScope&);
+};
+
+// Prints calls, sampled mean time and estimated total time per site, busiest first, summed over every thread so far.
+void PrintProbeReport(FILE* out);
+
+#define VECTOR_PROBE(name) static const ProbeSite probeSite(name); ProbeScope probeScope(probeSite)
+
+#else
+
+#define VECTOR_PROBE(name)
+
+#endif
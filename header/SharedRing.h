@@ -0,0 +1,106 @@
+/*
+Title: Vector Mathematics
+File Name: SharedRing.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// A ring buffer of vectors in POSIX shared memory, for streaming vectors from one process to
+//  another without a pipe in between.
+// Writers reserve space directly in the ring, fill it in place, and commit it; the reader gets
+//  pointers straight into the same memory. Nothing is copied and no system call is made while
+//  data is flowing. Only when the ring is full or empty does a thread block, on a futex in the
+//  shared memory, and it is woken as soon as the other side makes progress.
+// There is always a single reader. There may be one writer, or several when the ring is
+//  created as MultiProducer; their batches are read in the order space was reserved.
+// Only available on Linux; elsewhere Create and Open fail.
+
+enum class RingMode : uint32_t
+{
+	SingleProducer,
+	MultiProducer,
+};
+
+// A contiguous run of vectors in the ring, stored AoS: vector i starts at data + i * dimension.
+// An empty span (count 0) means a timeout, or that the ring was shut down.
+struct RingSpan
+{
+	float* data;
+	size_t count;
+	// Position of the first vector in the stream; used to commit and release spans in order.
+	uint64_t position;
+};
+
+// The span's vectors as a Vector2D, Vector3D or Vector4D array. The ring's dimension must match.
+template <typename V>
+V* RingVectors(const RingSpan& span)
+{
+	return reinterpret_cast<V*>(span.data);
+}
+
+struct SharedRingHeader;
+
+class SharedRing
+{
+public:
+	SharedRing();
+	// Closes the ring, removing its name if this object created it.
+	~SharedRing();
+
+	// Creates a ring named name (which must start with '/') holding up to capacity vectors.
+	// capacity is rounded up to a power of two.
+	bool Create(const char* name, int dimension, size_t capacity, RingMode mode = RingMode::SingleProducer);
+	// Opens a ring created by another process. Fails if it is not yet fully set up.
+	bool Open(const char* name);
+	void Close();
+
+	int Dimension() const;
+	size_t Capacity() const;
+
+	// Reserves space for up to count vectors, waiting up to timeoutMilliseconds (-1 for ever)
+	//  while the ring is full. The span may be shorter than count, but never empty unless it timed out.
+	RingSpan BeginWrite(size_t count, int timeoutMilliseconds = -1);
+	// Makes a span from BeginWrite visible to the reader.
+	void EndWrite(const RingSpan& span);
+
+	// Waits for at least one vector and returns up to maxCount of them.
+	RingSpan BeginRead(size_t maxCount, int timeoutMilliseconds = -1);
+	// Hands a span from BeginRead back to the writers.
+	void EndRead(const RingSpan& span);
+
+	// Copies count vectors in, in as many spans as it takes. Returns false if the ring was shut down or timed out.
+	bool Write(const float* vectors, size_t count, int timeoutMilliseconds = -1);
+
+	// Marks the stream as finished. The reader still gets everything already committed,
+	//  then an empty span without waiting; writers get empty spans at once.
+	void Shutdown();
+	bool IsShutdown() const;
+
+private:
+	SharedRingHeader* header;
+	float* data;
+	size_t mappedSize;
+	// Set on the object that created the ring, which removes the name on Close.
+	char* ownedName;
+
+	SharedRing(const SharedRing&);
+	SharedRing& operator=(const SharedRing&);
+};
@@ -0,0 +1,97 @@
+/*
+Title: Vector Mathematics
+File Name: SnapshotCodec.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "Vector3D.h"
+
+// Compressed checkpoints of a simulation's vectors, one frame after another.
+// Between two checkpoints most vectors barely move, so a frame is stored as the difference from the
+//  one before it:
+//  1) Each component's bits are XORed with the same component's bits in the previous frame.
+//     Nearby floats share their sign, exponent and top mantissa bits, so those bits XOR to zero.
+//  2) The bytes are shuffled into four planes, one per byte position, which gathers the mostly-zero
+//     high bytes of every component into long runs.
+//  3) The planes are run-length coded: zero runs become a length, everything else is copied.
+// Every keyframeInterval frames a keyframe is stored against zero instead, so replay can restart
+//  from it and a corrupt frame cannot poison the rest of the stream.
+
+struct SnapshotFrameHeader
+{
+	char magic[4];          // "VSNP"
+	uint32_t flags;         // SNAPSHOT_KEYFRAME
+	uint64_t frameIndex;
+	uint64_t count;         // Number of vectors in the frame
+	uint64_t encodedSize;   // Bytes of run-length coded data following the header
+};
+
+const uint32_t SNAPSHOT_KEYFRAME = 1;
+
+// The most vectors a frame may hold, 768 MB of planes. Larger frames are refused by the writer and
+//  treated as corrupt by the reader, so a forged count cannot make it allocate without bound.
+const uint64_t SNAPSHOT_MAX_VECTORS = uint64_t(1) << 26;
+
+class SnapshotWriter
+{
+public:
+	// Writes frames to out, which must stay open for the writer's lifetime.
+	SnapshotWriter(FILE* out, unsigned keyframeInterval = 64);
+
+	// Appends a frame. A frame with a different count from the last one is always a keyframe.
+	// Returns false, writing nothing, if count is over SNAPSHOT_MAX_VECTORS.
+	bool WriteFrame(const Vector3D* v, size_t count);
+
+	// Total bytes written so far, headers included.
+	uint64_t BytesWritten() const;
+
+private:
+	FILE* out;
+	unsigned keyframeInterval;
+	uint64_t frameIndex;
+	uint64_t bytesWritten;
+	std::vector<uint32_t> previous;
+	std::vector<uint8_t> planes;
+	std::vector<uint8_t> encoded;
+};
+
+class SnapshotReader
+{
+public:
+	SnapshotReader(FILE* in);
+
+	// Decodes the next frame into frame, resizing it to the frame's count.
+	// Returns false at the end of the stream or if the stream is corrupt.
+	bool ReadFrame(std::vector<Vector3D>& frame);
+
+	// The index of the frame last returned by ReadFrame.
+	uint64_t FrameIndex() const;
+
+private:
+	FILE* in;
+	uint64_t frameIndex;
+	std::vector<uint32_t> previous;
+	std::vector<uint8_t> planes;
+	std::vector<uint8_t> encoded;
+};
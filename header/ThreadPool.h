@@ -0,0 +1,83 @@
+/*
+Title: Vector Mathematics
+File Name: ThreadPool.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads for splitting loops over large arrays.
+// Starting threads costs tens of microseconds each, so a pool started once and reused for
+//  every batch is much cheaper than starting new threads for each call.
+class ThreadPool
+{
+public:
+	// threads = 0 uses one thread per hardware core.
+	// The thread calling ParallelFor also does work, so the pool starts threads - 1 workers.
+	explicit ThreadPool(unsigned threads = 0);
+	~ThreadPool();
+
+	// Number of threads that take part in ParallelFor, including the caller.
+	unsigned Size() const;
+
+	// Calls body(begin, end) for consecutive chunks of grain items covering [0, count), spread
+	//  over all threads, and returns once every chunk has finished.
+	// Chunk k always covers [k * grain, (k + 1) * grain), so body can use begin / grain to index per-chunk results.
+	// Only one thread may call ParallelFor at a time. Neither body nor a posted job may call it,
+	//  since the loop waits for every worker, including the one that would be calling.
+	void ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+	// Queues job to run on a worker thread and returns at once. Used to resume coroutines; see Coroutine.h.
+	// Jobs never run on the calling thread, so a pool without workers starts one for them.
+	// Jobs still queued when the pool is destroyed are run first.
+	void Post(std::function<void()> job);
+
+private:
+	std::vector<std::thread> workers;
+	// Workers started by the constructor, which take part in ParallelFor. Fixed once constructed, so
+	//  ParallelFor and Size can read it while Post adds the worker a pool without any starts for jobs.
+	unsigned loopWorkers;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+
+	// The current loop. Workers pick it up when generation changes.
+	const std::function<void(size_t, size_t)>* body;
+	size_t count;
+	size_t grain;
+	std::atomic<size_t> next;
+	unsigned busy;
+	unsigned long long generation;
+	bool stopping;
+
+	std::deque<std::function<void()>> jobs;
+
+	void RunChunks();
+	void WorkerLoop(unsigned long long seen);
+
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+};
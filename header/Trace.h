@@ -0,0 +1,90 @@
+/*
+Title: Vector Mathematics
+File Name: Trace.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+
+// Scoped trace events for seeing how work spreads over threads, exported as Chrome trace JSON
+//  for chrome://tracing or ui.perfetto.dev.
+// Each thread records into its own buffer, so recording takes no locks; a relaxed load is all a
+//  TraceScope costs while tracing is stopped.
+
+extern std::atomic<bool> traceRecording;
+
+inline bool TraceRecording()
+{
+	return traceRecording.load(std::memory_order_relaxed);
+}
+
+// Starts or stops recording. Events already recorded are kept until ClearTrace.
+void StartTrace();
+void StopTrace();
+
+// Discards every recorded event. Nothing may be recording while it runs.
+void ClearTrace();
+
+// Names the calling thread in the exported trace. name must outlive the trace.
+void SetTraceThreadName(const char* name);
+
+// Nanoseconds since the trace clock's origin.
+unsigned long long TraceNanoseconds();
+
+// Records one complete event for the calling thread. The strings must outlive the trace; argName may be null.
+void RecordTraceEvent(const char* name, const char* category, unsigned long long start, unsigned long long duration, const char* argName, unsigned long long argValue);
+
+// Writes every event recorded so far, on all threads, as a Chrome trace JSON object.
+// Safe to call while other threads are still recording; their newest events may be left out.
+// Returns false if writing failed.
+bool WriteChromeTrace(FILE* out);
+
+// Records an event covering its own lifetime, if tracing was on when it was created.
+// It must end on the thread it started on, so in a coroutine it must not span a co_await.
+class TraceScope
+{
+public:
+	TraceScope(const char* name, const char* category, const char* argName = nullptr, unsigned long long argValue = 0)
+		: name(TraceRecording() ? name : nullptr), category(category), argName(argName), argValue(argValue), start(0)
+	{
+		if (this->name != nullptr)
+		{
+			start = TraceNanoseconds();
+		}
+	}
+
+	~TraceScope()
+	{
+		if (name != nullptr)
+		{
+			RecordTraceEvent(name, category, start, TraceNanoseconds() - start, argName, argValue);
+		}
+	}
+
+private:
+	const char* name;
+	const char* category;
+	const char* argName;
+	unsigned long long argValue;
+	unsigned long long start;
+
+	TraceScope(const TraceScope&);
+	TraceScope& operator=(const TraceScope&);
+};
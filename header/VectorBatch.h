@@ -0,0 +1,61 @@
+/*
+Title: Vector Mathematics
+File Name: VectorBatch.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+
+#include "Vector2D.h"
+#include "Vector3D.h"
+#include "Vector4D.h"
+
+// Batch versions of the vector operations, applied to whole arrays at once.
+// Calling Dot or MagInverse once per vector costs a function call each time, because they are
+//  defined in their own source files. These loops do the same math written out component by
+//  component, so the compiler can vectorize them.
+// Output arrays may be the same as input arrays, but must not otherwise overlap them.
+
+// out[i] = in[i] / |in[i]|
+void NormalizeBatch(const Vector2D* in, Vector2D* out, size_t count);
+void NormalizeBatch(const Vector3D* in, Vector3D* out, size_t count);
+void NormalizeBatch(const Vector4D* in, Vector4D* out, size_t count);
+
+// out[i] = Dot(a[i], b[i])
+void DotBatch(const Vector2D* a, const Vector2D* b, float* out, size_t count);
+void DotBatch(const Vector3D* a, const Vector3D* b, float* out, size_t count);
+void DotBatch(const Vector4D* a, const Vector4D* b, float* out, size_t count);
+
+// out[i] = Cross(a[i], b[i])
+void CrossBatch(const Vector3D* a, const Vector3D* b, Vector3D* out, size_t count);
+
+// out[i] = |in[i]|
+void MagnitudeBatch(const Vector2D* in, float* out, size_t count);
+void MagnitudeBatch(const Vector3D* in, float* out, size_t count);
+void MagnitudeBatch(const Vector4D* in, float* out, size_t count);
+
+// out[i] = Project(a[i], b[i])
+void ProjectBatch(const Vector2D* a, const Vector2D* b, Vector2D* out, size_t count);
+void ProjectBatch(const Vector3D* a, const Vector3D* b, Vector3D* out, size_t count);
+void ProjectBatch(const Vector4D* a, const Vector4D* b, Vector4D* out, size_t count);
+
+// out[i] = M * in[i] + t, where matrix holds M in row-major order (4, 9 or 16 floats).
+void TransformBatch(const Vector2D* in, Vector2D* out, size_t count, const float* matrix, Vector2D t);
+void TransformBatch(const Vector3D* in, Vector3D* out, size_t count, const float* matrix, Vector3D t);
+void TransformBatch(const Vector4D* in, Vector4D* out, size_t count, const float* matrix, Vector4D t);
@@ -0,0 +1,87 @@
+/*
+Title: Vector Mathematics
+File Name: VectorCodecs.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "HalfVector.h"
+#include "Vector3D.h"
+
+// Compact storage for large arrays of positions and unit normals.
+// A Vector3D takes 12 bytes, and kernels that sweep big arrays spend most of their time waiting
+//  on memory rather than doing math. These codecs trade a small, bounded amount of precision for
+//  4 to 6 bytes per vector, and decoding is cheap enough to do right before the math.
+
+// An axis-aligned bounding box.
+struct Bounds3D
+{
+	Vector3D min, max;
+};
+
+// The smallest box containing all count vectors. An empty array gives an all-zero box.
+Bounds3D ComputeBounds(const Vector3D* v, size_t count);
+
+/////////////////////////
+// 16-bit positions    //
+/////////////////////////
+
+// A position stored as 16-bit fractions of the way across a bounding box on each axis.
+struct QuantizedPosition
+{
+	uint16_t x, y, z;
+};
+
+// Positions outside bounds are clamped to it.
+void EncodePositions16(const Vector3D* in, size_t count, Bounds3D bounds, QuantizedPosition* out);
+void DecodePositions16(const QuantizedPosition* in, size_t count, Bounds3D bounds, Vector3D* out);
+
+// The largest error DecodePositions16 can have on each axis: half of one quantization step,
+//  plus a little for float rounding.
+Vector3D PositionError16(Bounds3D bounds);
+
+/////////////////////////
+// Octahedral normals  //
+/////////////////////////
+
+// Octahedral encoding maps a unit vector onto the octahedron |x| + |y| + |z| = 1, then unfolds
+//  the octahedron into a square, giving two coordinates in [-1, 1] that are stored with bits bits
+//  each. Precision is spread far more evenly over the sphere than by storing x, y, z directly.
+// bits may be 2 through 16. The code holds u in its upper bits and v in its lower bits.
+uint32_t EncodeOctahedral(Vector3D n, int bits);
+Vector3D DecodeOctahedral(uint32_t code, int bits);
+
+// An upper bound, in radians, on the angle between a unit vector and its decoded encoding.
+float OctahedralMaxError(int bits);
+
+// 32-bit normals: 16 bits per coordinate.
+void EncodeNormals32(const Vector3D* in, size_t count, uint32_t* out);
+void DecodeNormals32(const uint32_t* in, size_t count, Vector3D* out);
+
+// 24-bit normals: 12 bits per coordinate, packed into 3 bytes each.
+void EncodeNormals24(const Vector3D* in, size_t count, uint8_t* out);
+void DecodeNormals24(const uint8_t* in, size_t count, Vector3D* out);
+
+// 16-bit normals: 8 bits per coordinate.
+void EncodeNormals16(const Vector3D* in, size_t count, uint16_t* out);
+void DecodeNormals16(const uint16_t* in, size_t count, Vector3D* out);
+
+// Half-float and bfloat16 components are in HalfVector.h.
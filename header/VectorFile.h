@@ -0,0 +1,117 @@
+/*
+Title: Vector Mathematics
+File Name: VectorFile.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "MappedFile.h"
+#include "Vector2D.h"
+#include "Vector3D.h"
+#include "Vector4D.h"
+
+// A compact binary container for large arrays of vectors.
+// Text output through operator<< is fine for a handful of vectors, but parsing and printing
+//  hundreds of millions of them takes far longer than the math we want to do with them.
+// A .vecf file is a fixed 64-byte header followed by the raw components, aligned so that the file
+//  can be memory-mapped and the components used in place, without copying or parsing anything.
+
+enum class VectorElementType : uint8_t
+{
+	Float32 = 0,
+};
+
+// AoS (array of structures) stores x y z x y z ..., exactly like an array of Vector3D.
+// SoA (structure of arrays) stores all x, then all y, then all z, each plane aligned on its own.
+enum class VectorLayout : uint8_t
+{
+	AoS = 0,
+	SoA = 1,
+};
+
+const uint16_t VECTOR_FILE_VERSION = 1;
+const uint32_t VECTOR_FILE_ALIGNMENT = 64;
+
+struct VectorFileHeader
+{
+	char magic[4];          // "VECF"
+	uint16_t version;       // VECTOR_FILE_VERSION
+	uint16_t headerSize;    // sizeof(VectorFileHeader)
+	uint8_t dimension;      // 2, 3, or 4
+	uint8_t elementType;    // VectorElementType
+	uint8_t layout;         // VectorLayout
+	uint8_t reserved0;
+	uint32_t alignment;     // Alignment of dataOffset and of each SoA plane
+	uint64_t count;         // Number of vectors
+	uint64_t dataOffset;    // Offset of the first component from the start of the file
+	uint64_t dataSize;      // Size of the data region in bytes, including SoA plane padding
+	uint64_t planeStride;   // SoA only: distance in bytes between component planes
+	uint64_t checksum;      // VectorFileChecksum of the data region
+	uint64_t reserved1;
+};
+
+static_assert(sizeof(VectorFileHeader) == 64, "VectorFileHeader must stay 64 bytes");
+
+// A strided, read-only view of an array of vectors in either layout.
+// Component c of vector i is components[c][i * stride].
+// For AoS data stride is the dimension; for SoA data it is 1.
+struct VectorArrayView
+{
+	const float* components[4];
+	size_t stride;
+	size_t count;
+	int dimension;
+};
+
+// Writes count vectors to path. Returns false on any I/O error.
+bool WriteVectorFile(const char* path, const Vector2D* v, size_t count, VectorLayout layout = VectorLayout::AoS);
+bool WriteVectorFile(const char* path, const Vector3D* v, size_t count, VectorLayout layout = VectorLayout::AoS);
+bool WriteVectorFile(const char* path, const Vector4D* v, size_t count, VectorLayout layout = VectorLayout::AoS);
+
+// A memory-mapped .vecf file.
+struct VectorFile
+{
+	MappedFile file;
+	const VectorFileHeader* header;
+	VectorArrayView view;
+
+	VectorFile();
+
+	// Maps the file and validates its header. Verifying the checksum touches every page of the
+	//  file, so it is off by default; turn it on when the file came from somewhere untrusted.
+	bool Open(const char* path, bool verifyChecksum = false);
+	void Close();
+};
+
+// Reinterprets a view as a plain array, or returns nullptr if the view is not AoS data of that dimension.
+// The pointer aliases the mapped file, so it is only valid while the file stays open.
+const Vector2D* AsVector2D(const VectorArrayView& view);
+const Vector3D* AsVector3D(const VectorArrayView& view);
+const Vector4D* AsVector4D(const VectorArrayView& view);
+
+// The header for count vectors of the given dimension and layout, with everything but the checksum filled in.
+VectorFileHeader MakeVectorFileHeader(int dimension, size_t count, VectorLayout layout);
+
+// Checks that h is a header this version can read, describing data that fits in a file of fileSize bytes.
+bool ValidVectorFileHeader(const VectorFileHeader& h, uint64_t fileSize);
+
+// A fast 64-bit checksum over size bytes. Not cryptographic, just enough to catch truncation and corruption.
+uint64_t VectorFileChecksum(const void* data, size_t size);
@@ -0,0 +1,88 @@
+/*
+Title: Vector Mathematics
+File Name: VectorMathC.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <stddef.h>
+
+/*
+ A C interface to the batch kernels in VectorBatch.h, for programs that want to link the shared
+  library without depending on the C++ types or name mangling.
+ Every array is passed as a pointer to its first float plus a stride: the distance in bytes from
+  one vector to the next. Strides must be multiples of 4. Tightly packed arrays, whose stride is
+  the size of the vector itself (8, 12 or 16 bytes), are processed in place with no copying; any
+  other stride is gathered and scattered through a small buffer, and a stride of 0 reuses the
+  same vector for every element.
+ Outputs may be the same as inputs, but must not otherwise overlap them.
+*/
+
+#if defined(_WIN32)
+	#if defined(VECTOR_MATH_EXPORTS)
+		#define VECTOR_MATH_API __declspec(dllexport)
+	#elif defined(VECTOR_MATH_SHARED)
+		#define VECTOR_MATH_API __declspec(dllimport)
+	#else
+		#define VECTOR_MATH_API
+	#endif
+#else
+	#define VECTOR_MATH_API __attribute__((visibility("default")))
+#endif
+
+/* Bumped whenever a function's signature or behavior changes. Functions are only ever added. */
+#define VECTOR_MATH_ABI_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The VECTOR_MATH_ABI_VERSION the library was built with, to check against the header. */
+VECTOR_MATH_API int vmAbiVersion(void);
+
+/* out[i] = in[i] / |in[i]| */
+VECTOR_MATH_API void vmNormalize2D(const float* in, size_t inStride, float* out, size_t outStride, size_t count);
+VECTOR_MATH_API void vmNormalize3D(const float* in, size_t inStride, float* out, size_t outStride, size_t count);
+VECTOR_MATH_API void vmNormalize4D(const float* in, size_t inStride, float* out, size_t outStride, size_t count);
+
+/* out[i] = |in[i]|, where out is a scalar array with its own stride */
+VECTOR_MATH_API void vmMagnitude2D(const float* in, size_t inStride, float* out, size_t outStride, size_t count);
+VECTOR_MATH_API void vmMagnitude3D(const float* in, size_t inStride, float* out, size_t outStride, size_t count);
+VECTOR_MATH_API void vmMagnitude4D(const float* in, size_t inStride, float* out, size_t outStride, size_t count);
+
+/* out[i] = Dot(a[i], b[i]), where out is a scalar array with its own stride */
+VECTOR_MATH_API void vmDot2D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count);
+VECTOR_MATH_API void vmDot3D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count);
+VECTOR_MATH_API void vmDot4D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count);
+
+/* out[i] = Cross(a[i], b[i]) */
+VECTOR_MATH_API void vmCross3D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count);
+
+/* out[i] = Project(a[i], b[i]) */
+VECTOR_MATH_API void vmProject2D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count);
+VECTOR_MATH_API void vmProject3D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count);
+VECTOR_MATH_API void vmProject4D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count);
+
+/* out[i] = M * in[i] + t, with M an N x N row-major matrix and t N floats, or NULL for no translation */
+VECTOR_MATH_API void vmTransform2D(const float* in, size_t inStride, float* out, size_t outStride, size_t count, const float* matrix, const float* translation);
+VECTOR_MATH_API void vmTransform3D(const float* in, size_t inStride, float* out, size_t outStride, size_t count, const float* matrix, const float* translation);
+VECTOR_MATH_API void vmTransform4D(const float* in, size_t inStride, float* out, size_t outStride, size_t count, const float* matrix, const float* translation);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,57 @@
+/*
+Title: Vector Mathematics
+File Name: VectorParser.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+
+#include "Vector2D.h"
+#include "Vector3D.h"
+#include "Vector4D.h"
+
+// Fast parsing of vectors written as text, one vector per line.
+// Each line may be in operator<<'s "(x, y, z)" form, comma separated "x,y,z", or whitespace
+//  separated "x y z"; blank lines are skipped.
+// The parser works directly on a buffer, such as a MappedFile, never allocates, and converts
+//  numbers with std::from_chars, which avoids iostream's locale handling entirely.
+
+struct ParseResult
+{
+	// False if a line could not be parsed, or there was not enough room in the output.
+	bool ok;
+	// Number of vectors written to the output.
+	size_t count;
+	// 1-based line number of the first bad line, or 0.
+	size_t errorLine;
+};
+
+// Counts the non-blank lines in text, i.e. how many vectors parsing it will produce.
+size_t CountVectorLines(const char* text, size_t size);
+
+// Parses up to capacity vectors from text into out.
+ParseResult ParseVectors(const char* text, size_t size, Vector2D* out, size_t capacity);
+ParseResult ParseVectors(const char* text, size_t size, Vector3D* out, size_t capacity);
+ParseResult ParseVectors(const char* text, size_t size, Vector4D* out, size_t capacity);
+
+// As above, but splits text into chunks on line boundaries and parses them on separate threads.
+// threads = 0 uses one thread per hardware core.
+ParseResult ParseVectorsParallel(const char* text, size_t size, Vector2D* out, size_t capacity, unsigned threads = 0);
+ParseResult ParseVectorsParallel(const char* text, size_t size, Vector3D* out, size_t capacity, unsigned threads = 0);
+ParseResult ParseVectorsParallel(const char* text, size_t size, Vector4D* out, size_t capacity, unsigned threads = 0);
@@ -0,0 +1,157 @@
+/*
+Title: Vector Mathematics
+File Name: VectorService.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "ThreadPool.h"
+
+// A local service that runs the batch kernels for other processes, so a machine needs one
+//  thread pool instead of one per process.
+// Clients talk to the server over a Unix-domain socket, but vectors never pass through it:
+//  each client creates a shared memory file, hands its descriptor to the server once, and from
+//  then on requests only name offsets into that memory. Results are written back in place.
+// Small requests that arrive close together are coalesced into a single parallel dispatch,
+//  which keeps the cost of waking the pool from dominating small batches.
+// The service is only available on Linux; elsewhere starting it or connecting to it fails.
+
+enum class ServiceOp : uint32_t
+{
+	// Hands the server the client's shared memory. Sent once, by Connect.
+	Attach = 0,
+	// out[i] = in[i] / |in[i]|
+	Normalize,
+	// out[i] = |in[i]|, as floats
+	Magnitude,
+	// out[i] = Dot(a[i], b[i]), as floats
+	Dot,
+	// out[i] = Cross(a[i], b[i]), 3D only
+	Cross,
+	// out[i] = Project(a[i], b[i])
+	Project,
+	// out[i] = M * a[i] + t, with M and t taken from the request
+	Transform,
+	// Replies with the server's statistics; touches no memory.
+	Stats,
+};
+
+enum class ServiceStatus : int32_t
+{
+	Ok = 0,
+	// Unknown operation or unsupported dimension.
+	BadRequest,
+	// A request arrived before the client's shared memory.
+	NotAttached,
+	// An array reaches outside the shared memory, or is not 4-byte aligned.
+	OutOfRange,
+};
+
+// A request for one batch operation. Arrays are AoS, tightly packed, and given as byte offsets
+//  into the client's shared memory.
+struct ServiceRequest
+{
+	ServiceOp op;
+	uint32_t dimension;
+	// Chosen by the client and echoed in the reply.
+	uint64_t id;
+	uint64_t count;
+	uint64_t a;
+	uint64_t b;
+	uint64_t out;
+	// Row-major dimension x dimension matrix and translation, for Transform.
+	float matrix[16];
+	float translation[4];
+};
+
+struct ServiceStats
+{
+	uint64_t uptimeNanoseconds;
+	uint64_t clients;
+	uint64_t requests;
+	uint64_t vectors;
+	uint64_t errors;
+	// Parallel dispatches. requests / batches is how much coalescing is happening.
+	uint64_t batches;
+	// Time from a request arriving to its reply being sent.
+	uint64_t totalLatencyNanoseconds;
+	uint64_t maxLatencyNanoseconds;
+};
+
+struct ServiceReply
+{
+	uint64_t id;
+	ServiceStatus status;
+	uint32_t reserved;
+	// Only filled in for Stats.
+	ServiceStats stats;
+};
+
+struct VectorServiceOptions
+{
+	const char* socketPath;
+	// How long to hold a request while waiting for others to batch it with.
+	unsigned windowMicroseconds;
+	// Dispatch at once when this many vectors are waiting, whatever the window.
+	size_t batchVectors;
+};
+
+// Serves requests on options.socketPath using pool until stop is set, then removes the socket.
+// Returns false, having printed why to stderr, if the service could not start.
+bool RunVectorService(const VectorServiceOptions& options, ThreadPool& pool, const std::atomic<bool>& stop, ServiceStats& finalStats);
+
+// Prints stats in a readable form, one value per line.
+void PrintServiceStats(FILE* out, const ServiceStats& stats);
+
+// A connection to a running service.
+class VectorServiceClient
+{
+public:
+	VectorServiceClient();
+	~VectorServiceClient();
+
+	// Connects to the service and creates sharedBytes of shared memory for requests to use.
+	bool Connect(const char* socketPath, size_t sharedBytes);
+	void Close();
+
+	// The shared memory. Arrays passed in requests live here.
+	char* Shared() const;
+	size_t SharedSize() const;
+
+	// Sends a request without waiting for it to finish, so several can be in flight.
+	bool Submit(const ServiceRequest& request);
+	// Waits for the next reply. Replies come back in the order the requests were sent.
+	bool Receive(ServiceReply& reply);
+	// Submit then Receive.
+	bool Call(const ServiceRequest& request, ServiceReply& reply);
+
+	bool QueryStats(ServiceStats& stats);
+
+private:
+	int socket;
+	char* shared;
+	size_t sharedSize;
+
+	VectorServiceClient(const VectorServiceClient&);
+	VectorServiceClient& operator=(const VectorServiceClient&);
+};
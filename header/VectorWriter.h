@@ -0,0 +1,118 @@
+/*
+Title: Vector Mathematics
+File Name: VectorWriter.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Vector2D.h"
+#include "Vector3D.h"
+#include "Vector4D.h"
+
+// How VectorWriter prints each component.
+enum class NumberFormat
+{
+	// The shortest text that reads back as exactly the same float.
+	Shortest,
+	// printf's %g with the given precision. With precision 6 this matches operator<<.
+	General,
+	// printf's %f with the given number of digits after the decimal point.
+	Fixed,
+};
+
+// A fast replacement for printing vectors with operator<<.
+// operator<< goes through iostream's locale machinery one component at a time, which is fine for a
+//  tutorial but far too slow for dumping millions of vectors.
+// VectorWriter formats each component with std::to_chars straight into a large buffer, writes
+//  the buffer in one call when it fills, and can hand the writing off to a background thread so
+//  formatting never waits on the disk.
+// Each vector is written in the same "(x, y, z)" form as operator<<, one per line.
+class VectorWriter
+{
+public:
+	// Writes to out, which must stay open for the writer's lifetime. The writer does not close it.
+	VectorWriter(FILE* out, size_t bufferSize = 1 << 20, bool background = false);
+	// Flushes anything still buffered.
+	~VectorWriter();
+
+	// precision is clamped to 0..17 for General and 0..45 for Fixed, so any number fits the buffer.
+	void SetFormat(NumberFormat format, int precision = 6);
+
+	void Write(Vector2D v);
+	void Write(Vector3D v);
+	void Write(Vector4D v);
+
+	void Write(const Vector2D* v, size_t count);
+	void Write(const Vector3D* v, size_t count);
+	void Write(const Vector4D* v, size_t count);
+
+	// Writes raw text, e.g. a header line or a scalar result.
+	void WriteText(const char* text, size_t length);
+	void WriteText(const char* text);
+
+	// Writes a single number in the current format, followed by a newline.
+	void WriteScalar(float s);
+
+	// Writes everything buffered so far and flushes out. Returns false if any write has failed.
+	bool Flush();
+
+	// False once any write has failed.
+	bool Good() const;
+
+private:
+	FILE* out;
+	NumberFormat format;
+	int precision;
+	size_t bufferSize;
+	std::vector<char> buffer;
+	size_t used;
+	std::atomic<bool> failed;
+
+	// Background writing state. The writer thread owns pending while hasPending is set.
+	bool background;
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::vector<char> pending;
+	size_t pendingSize;
+	bool hasPending;
+	bool stopping;
+
+	void WriteVector(const float* components, int dimension);
+	void Reserve(size_t bytes);
+	void Submit();
+	void WaitForWorker();
+	void WorkerLoop();
+
+	VectorWriter(const VectorWriter&);
+	VectorWriter& operator=(const VectorWriter&);
+};
+
+// Appends count vectors to text exactly as VectorWriter would write them, for formatting on one
+//  thread and writing on another.
+void AppendVectorText(std::vector<char>& text, const Vector2D* v, size_t count, NumberFormat format = NumberFormat::Shortest, int precision = 6);
+void AppendVectorText(std::vector<char>& text, const Vector3D* v, size_t count, NumberFormat format = NumberFormat::Shortest, int precision = 6);
+void AppendVectorText(std::vector<char>& text, const Vector4D* v, size_t count, NumberFormat format = NumberFormat::Shortest, int precision = 6);
@@ -0,0 +1,63 @@
+/*
+Title: Vector Mathematics
+File Name: WorldOrigin.h
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstddef>
+
+#include "DVector3D.h"
+#include "Vector3D.h"
+
+// Camera-relative coordinates for large worlds.
+// World positions are stored as DVector3D, but rendering and physics run on float Vector3D
+//  positions measured from a local origin that follows the camera. Near the origin floats are
+//  precise, and the expensive per-frame math never has to touch doubles.
+
+// Converts a world position to a float position relative to origin.
+Vector3D ToLocal(DVector3D world, DVector3D origin);
+// Converts a float position relative to origin back to a world position.
+DVector3D ToWorld(Vector3D local, DVector3D origin);
+
+// Batch versions of the above. The subtraction is done in double and only the small result is
+//  rounded to float, so no precision is lost to the size of the world coordinates.
+void ToLocalBatch(const DVector3D* world, size_t count, DVector3D origin, Vector3D* out);
+void ToWorldBatch(const Vector3D* local, size_t count, DVector3D origin, DVector3D* out);
+
+// Moves every local position by -shift, for when the origin moves by shift.
+void RebaseBatch(Vector3D* local, size_t count, Vector3D shift);
+
+// Tracks the local origin, moving it when the camera (or player, or whatever is the focus)
+//  strays too far from it.
+struct WorldOrigin
+{
+	DVector3D origin;
+	// How far the focus may get from the origin before the origin is moved to it.
+	double rebaseDistance;
+
+	WorldOrigin(double rebaseDistance = 4096.0);
+
+	// Moves the origin to focus if focus is more than rebaseDistance away.
+	// Returns true if it moved, with shift set to how far, so that existing local positions
+	//  can be updated with RebaseBatch. The new origin is snapped to whole units, so shift is a
+	//  whole number, exactly representable as a float while each component is below 2^24 in
+	//  magnitude. RebaseBatch is then exact for typical positions. A longer jump still moves the
+	//  origin, but shift is rounded to float and positions rebased with it are off by that rounding.
+	bool Update(DVector3D focus, Vector3D& shift);
+};
@@ -0,0 +1,796 @@
+/*
+Title: Vector Mathematics
+File Name: ArrowIPC.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/ArrowIPC.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Values from Arrow's Schema.fbs and Message.fbs.
+static const int16_t ARROW_METADATA_V5 = 4;
+static const uint8_t ARROW_TYPE_FLOATING_POINT = 3;
+static const uint8_t ARROW_TYPE_FIXED_SIZE_LIST = 16;
+static const int16_t ARROW_PRECISION_SINGLE = 1;
+static const uint8_t ARROW_HEADER_SCHEMA = 1;
+static const uint8_t ARROW_HEADER_RECORD_BATCH = 3;
+
+static const char ARROW_MAGIC[6] = { 'A', 'R', 'R', 'O', 'W', '1' };
+static const uint32_t ARROW_CONTINUATION = 0xFFFFFFFFu;
+// Bodies are padded to 64 bytes, as the Arrow spec recommends, so mapped columns are cache-line aligned.
+static const size_t ARROW_ALIGNMENT = 64;
+
+static const char* const COLUMN_NAMES[4] = { "x", "y", "z", "w" };
+
+static size_t RoundUp(size_t n, size_t alignment)
+{
+	return (n + alignment - 1) / alignment * alignment;
+}
+
+//
+// FlatBuffers encoding
+//
+// The usual FlatBuffers builder works back to front. This one writes front to back instead:
+//  a table is written before its children, its offset fields are left as placeholders,
+//  and each placeholder is patched once the child it points to has been written.
+// Offsets only ever point forward, which is all the format requires.
+
+struct TableField
+{
+	int slot;
+	int size;        // 1, 2, 4 or 8 bytes
+	uint64_t value;  // Ignored for offset fields
+	bool isOffset;
+};
+
+static TableField Scalar(int slot, int size, uint64_t value)
+{
+	return TableField{ slot, size, value, false };
+}
+
+static TableField Offset(int slot)
+{
+	return TableField{ slot, 4, 0, true };
+}
+
+class FlatBufferBuilder
+{
+public:
+	std::vector<unsigned char> data;
+
+	// Reserves the root offset at the start of the buffer.
+	size_t Begin()
+	{
+		data.clear();
+		return Placeholder();
+	}
+
+	// Writes a vtable and the table it describes.
+	// The positions of the table's offset fields are appended to offsets, in the order they were given.
+	size_t Table(std::initializer_list<TableField> fields, std::vector<size_t>& offsets)
+	{
+		int slots = 0;
+		for (const TableField& f : fields)
+		{
+			slots = f.slot + 1 > slots ? f.slot + 1 : slots;
+		}
+
+		// Lay the fields out largest first, so aligning each to its own size wastes little space.
+		uint16_t fieldOffsets[16] = {};
+		size_t cursor = 4;
+		for (int size = 8; size >= 1; size /= 2)
+		{
+			for (const TableField& f : fields)
+			{
+				if (f.size == size)
+				{
+					cursor = RoundUp(cursor, size);
+					fieldOffsets[f.slot] = static_cast<uint16_t>(cursor);
+					cursor += size;
+				}
+			}
+		}
+		size_t tableSize = cursor;
+
+		Pad(2);
+		size_t vtable = data.size();
+		Append16(static_cast<uint16_t>(4 + 2 * slots));
+		Append16(static_cast<uint16_t>(tableSize));
+		for (int s = 0; s < slots; s++)
+		{
+			Append16(fieldOffsets[s]);
+		}
+
+		// Tables start 8-aligned, so field alignment within the table is alignment within the buffer.
+		Pad(8);
+		size_t table = data.size();
+		data.resize(table + tableSize, 0);
+		Store32(table, static_cast<uint32_t>(table - vtable));
+		for (const TableField& f : fields)
+		{
+			size_t at = table + fieldOffsets[f.slot];
+			if (f.isOffset)
+			{
+				offsets.push_back(at);
+			}
+			else
+			{
+				memcpy(&data[at], &f.value, f.size);
+			}
+		}
+		return table;
+	}
+
+	// Writes a vector of count offsets and returns the position of each element.
+	size_t OffsetVector(size_t count, std::vector<size_t>& elements)
+	{
+		Pad(4);
+		size_t vector = data.size();
+		Append32(static_cast<uint32_t>(count));
+		for (size_t i = 0; i < count; i++)
+		{
+			elements.push_back(Placeholder());
+		}
+		return vector;
+	}
+
+	// Writes a vector of count structs of structSize bytes each, with 8-byte alignment.
+	size_t StructVector(const void* structs, size_t structSize, size_t count)
+	{
+		while ((data.size() + 4) % 8 != 0)
+		{
+			data.push_back(0);
+		}
+		size_t vector = data.size();
+		Append32(static_cast<uint32_t>(count));
+		const unsigned char* bytes = static_cast<const unsigned char*>(structs);
+		data.insert(data.end(), bytes, bytes + structSize * count);
+		return vector;
+	}
+
+	size_t String(const char* s)
+	{
+		Pad(4);
+		size_t string = data.size();
+		size_t length = strlen(s);
+		Append32(static_cast<uint32_t>(length));
+		data.insert(data.end(), s, s + length + 1);
+		return string;
+	}
+
+	// Points the offset stored at position at to target.
+	void Patch(size_t at, size_t target)
+	{
+		Store32(at, static_cast<uint32_t>(target - at));
+	}
+
+private:
+	size_t Placeholder()
+	{
+		Pad(4);
+		size_t at = data.size();
+		Append32(0);
+		return at;
+	}
+
+	void Pad(size_t alignment)
+	{
+		data.resize(RoundUp(data.size(), alignment), 0);
+	}
+
+	void Append16(uint16_t v)
+	{
+		data.resize(data.size() + 2);
+		memcpy(&data[data.size() - 2], &v, 2);
+	}
+
+	void Append32(uint32_t v)
+	{
+		data.resize(data.size() + 4);
+		memcpy(&data[data.size() - 4], &v, 4);
+	}
+
+	void Store32(size_t at, uint32_t v)
+	{
+		memcpy(&data[at], &v, 4);
+	}
+};
+
+// Writes a Field table for a non-nullable float column and points fieldOffset at it.
+static void FloatField(FlatBufferBuilder& fb, size_t fieldOffset, const char* name)
+{
+	std::vector<size_t> offsets;
+	size_t field = fb.Table({ Offset(0), Scalar(1, 1, 0), Scalar(2, 1, ARROW_TYPE_FLOATING_POINT), Offset(3) }, offsets);
+	fb.Patch(fieldOffset, field);
+	fb.Patch(offsets[0], fb.String(name));
+	std::vector<size_t> typeOffsets;
+	fb.Patch(offsets[1], fb.Table({ Scalar(0, 2, static_cast<uint16_t>(ARROW_PRECISION_SINGLE)) }, typeOffsets));
+}
+
+// Writes a Schema table for the given layout and points schemaOffset at it.
+static void Schema(FlatBufferBuilder& fb, size_t schemaOffset, int dimension, ArrowLayout layout)
+{
+	std::vector<size_t> offsets;
+	fb.Patch(schemaOffset, fb.Table({ Scalar(0, 2, 0), Offset(1) }, offsets));
+	std::vector<size_t> fields;
+	if (layout == ArrowLayout::FixedSizeList)
+	{
+		fb.Patch(offsets[0], fb.OffsetVector(1, fields));
+		std::vector<size_t> listOffsets;
+		size_t field = fb.Table({ Offset(0), Scalar(1, 1, 0), Scalar(2, 1, ARROW_TYPE_FIXED_SIZE_LIST), Offset(3), Offset(5) }, listOffsets);
+		fb.Patch(fields[0], field);
+		fb.Patch(listOffsets[0], fb.String("vectors"));
+		std::vector<size_t> typeOffsets;
+		fb.Patch(listOffsets[1], fb.Table({ Scalar(0, 4, static_cast<uint32_t>(dimension)) }, typeOffsets));
+		std::vector<size_t> children;
+		fb.Patch(listOffsets[2], fb.OffsetVector(1, children));
+		FloatField(fb, children[0], "item");
+	}
+	else
+	{
+		fb.Patch(offsets[0], fb.OffsetVector(dimension, fields));
+		for (int c = 0; c < dimension; c++)
+		{
+			FloatField(fb, fields[c], COLUMN_NAMES[c]);
+		}
+	}
+}
+
+// Wraps a message header in a Message table.
+// Returns the position of the offset that must be pointed at the header.
+static size_t Message(FlatBufferBuilder& fb, uint8_t headerType, uint64_t bodyLength)
+{
+	size_t root = fb.Begin();
+	std::vector<size_t> offsets;
+	fb.Patch(root, fb.Table({ Scalar(0, 2, static_cast<uint16_t>(ARROW_METADATA_V5)), Scalar(1, 1, headerType), Offset(2), Scalar(3, 8, bodyLength) }, offsets));
+	return offsets[0];
+}
+
+// Arrow's Buffer, FieldNode and Block structs.
+struct ArrowBuffer
+{
+	int64_t offset;
+	int64_t length;
+};
+
+struct ArrowFieldNode
+{
+	int64_t length;
+	int64_t nullCount;
+};
+
+struct ArrowBlock
+{
+	int64_t offset;
+	int32_t metaDataLength;
+	int32_t padding;
+	int64_t bodyLength;
+};
+
+static_assert(sizeof(ArrowBlock) == 24, "Block must match the Arrow struct layout");
+
+//
+// Writing
+//
+
+class ArrowFileWriter
+{
+public:
+	ArrowFileWriter(FILE* f)
+		: f(f), position(0), ok(true)
+	{
+	}
+
+	bool Good() const
+	{
+		return ok;
+	}
+
+	void Write(const void* bytes, size_t n)
+	{
+		ok = ok && (n == 0 || fwrite(bytes, 1, n, f) == n);
+		position += n;
+	}
+
+	void Zeros(size_t n)
+	{
+		static const unsigned char zeros[ARROW_ALIGNMENT] = {};
+		while (n > 0)
+		{
+			size_t k = n < ARROW_ALIGNMENT ? n : ARROW_ALIGNMENT;
+			Write(zeros, k);
+			n -= k;
+		}
+	}
+
+	// Writes an encapsulated message: continuation marker, metadata length, and the metadata.
+	// The metadata is padded so the body, which must follow, starts ARROW_ALIGNMENT-aligned.
+	// Returns the block describing the message.
+	ArrowBlock Metadata(const FlatBufferBuilder& fb, uint64_t bodyLength)
+	{
+		ArrowBlock block = {};
+		block.offset = static_cast<int64_t>(position);
+		uint32_t length = static_cast<uint32_t>(RoundUp(position + 8 + fb.data.size(), ARROW_ALIGNMENT) - position - 8);
+		Write(&ARROW_CONTINUATION, 4);
+		Write(&length, 4);
+		Write(fb.data.data(), fb.data.size());
+		Zeros(length - fb.data.size());
+		block.metaDataLength = static_cast<int32_t>(8 + length);
+		block.bodyLength = static_cast<int64_t>(bodyLength);
+		return block;
+	}
+
+	size_t Position() const
+	{
+		return position;
+	}
+
+private:
+	FILE* f;
+	size_t position;
+	bool ok;
+};
+
+// Writes a RecordBatch message and its body for vectors [start, start + rows).
+static ArrowBlock WriteBatch(ArrowFileWriter& out, const float* components, int dimension, size_t start, size_t rows, ArrowLayout layout, std::vector<float>& scratch)
+{
+	std::vector<ArrowFieldNode> nodes;
+	std::vector<ArrowBuffer> buffers;
+	size_t columnBytes = rows * sizeof(float);
+	size_t body;
+	if (layout == ArrowLayout::FixedSizeList)
+	{
+		// The list and its child each have a validity buffer, left empty since nothing is null.
+		// The list itself has no other buffers; the child's values are the AoS data.
+		nodes.push_back({ static_cast<int64_t>(rows), 0 });
+		nodes.push_back({ static_cast<int64_t>(rows * dimension), 0 });
+		buffers.push_back({ 0, 0 });
+		buffers.push_back({ 0, 0 });
+		buffers.push_back({ 0, static_cast<int64_t>(columnBytes * dimension) });
+		body = RoundUp(columnBytes * dimension, ARROW_ALIGNMENT);
+	}
+	else
+	{
+		size_t stride = RoundUp(columnBytes, ARROW_ALIGNMENT);
+		for (int c = 0; c < dimension; c++)
+		{
+			nodes.push_back({ static_cast<int64_t>(rows), 0 });
+			buffers.push_back({ static_cast<int64_t>(stride * c), 0 });
+			buffers.push_back({ static_cast<int64_t>(stride * c), static_cast<int64_t>(columnBytes) });
+		}
+		body = stride * dimension;
+	}
+
+	FlatBufferBuilder fb;
+	size_t header = Message(fb, ARROW_HEADER_RECORD_BATCH, body);
+	std::vector<size_t> offsets;
+	fb.Patch(header, fb.Table({ Scalar(0, 8, rows), Offset(1), Offset(2) }, offsets));
+	fb.Patch(offsets[0], fb.StructVector(nodes.data(), sizeof(ArrowFieldNode), nodes.size()));
+	fb.Patch(offsets[1], fb.StructVector(buffers.data(), sizeof(ArrowBuffer), buffers.size()));
+	ArrowBlock block = out.Metadata(fb, body);
+
+	const float* first = components + start * dimension;
+	if (layout == ArrowLayout::FixedSizeList)
+	{
+		out.Write(first, columnBytes * dimension);
+		out.Zeros(body - columnBytes * dimension);
+	}
+	else
+	{
+		scratch.resize(rows);
+		for (int c = 0; c < dimension; c++)
+		{
+			for (size_t i = 0; i < rows; i++)
+			{
+				scratch[i] = first[i * dimension + c];
+			}
+			out.Write(scratch.data(), columnBytes);
+			out.Zeros(RoundUp(columnBytes, ARROW_ALIGNMENT) - columnBytes);
+		}
+	}
+	return block;
+}
+
+static bool WriteArrowFile(const char* path, const float* components, int dimension, size_t count, ArrowLayout layout, size_t batchRows)
+{
+	FILE* f = fopen(path, "wb");
+	if (!f)
+	{
+		return false;
+	}
+	ArrowFileWriter out(f);
+
+	// The file starts with the magic and a stream: the schema, the record batches, and an end-of-stream marker.
+	out.Write(ARROW_MAGIC, 6);
+	out.Zeros(2);
+	FlatBufferBuilder fb;
+	Schema(fb, Message(fb, ARROW_HEADER_SCHEMA, 0), dimension, layout);
+	out.Metadata(fb, 0);
+
+	if (batchRows == 0)
+	{
+		batchRows = count > 0 ? count : 1;
+	}
+	std::vector<ArrowBlock> blocks;
+	std::vector<float> scratch;
+	for (size_t start = 0; out.Good() && start < count; start += batchRows)
+	{
+		size_t rows = count - start < batchRows ? count - start : batchRows;
+		blocks.push_back(WriteBatch(out, components, dimension, start, rows, layout, scratch));
+	}
+	const uint32_t endOfStream[2] = { ARROW_CONTINUATION, 0 };
+	out.Write(endOfStream, 8);
+
+	// The footer repeats the schema and indexes the batches, so readers can seek straight to them.
+	size_t root = fb.Begin();
+	std::vector<size_t> offsets;
+	fb.Patch(root, fb.Table({ Scalar(0, 2, static_cast<uint16_t>(ARROW_METADATA_V5)), Offset(1), Offset(3) }, offsets));
+	Schema(fb, offsets[0], dimension, layout);
+	fb.Patch(offsets[1], fb.StructVector(blocks.data(), sizeof(ArrowBlock), blocks.size()));
+	uint32_t footerLength = static_cast<uint32_t>(fb.data.size());
+	out.Write(fb.data.data(), fb.data.size());
+	out.Write(&footerLength, 4);
+	out.Write(ARROW_MAGIC, 6);
+
+	bool ok = out.Good();
+	ok = (fclose(f) == 0) && ok;
+	return ok;
+}
+
+bool WriteArrowFile(const char* path, const Vector2D* v, size_t count, ArrowLayout layout, size_t batchRows)
+{
+	return WriteArrowFile(path, &v->x, 2, count, layout, batchRows);
+}
+
+bool WriteArrowFile(const char* path, const Vector3D* v, size_t count, ArrowLayout layout, size_t batchRows)
+{
+	return WriteArrowFile(path, &v->x, 3, count, layout, batchRows);
+}
+
+bool WriteArrowFile(const char* path, const Vector4D* v, size_t count, ArrowLayout layout, size_t batchRows)
+{
+	return WriteArrowFile(path, &v->x, 4, count, layout, batchRows);
+}
+
+//
+// FlatBuffers decoding
+//
+// Every read is bounds-checked against the buffer, so a corrupt file fails to open instead of crashing.
+// Positions are byte offsets into the buffer; 0 doubles as "absent", since no table can start there.
+
+class FlatBufferReader
+{
+public:
+	FlatBufferReader(const unsigned char* data, size_t size)
+		: data(data), size(size)
+	{
+	}
+
+	size_t Root() const
+	{
+		return Deref(0);
+	}
+
+	// The position of a table's field, or 0 if the field is absent.
+	size_t Field(size_t table, int slot) const
+	{
+		if (table == 0 || !InBounds(table, 4))
+		{
+			return 0;
+		}
+		int32_t soffset;
+		memcpy(&soffset, data + table, 4);
+		int64_t vtable = static_cast<int64_t>(table) - soffset;
+		if (vtable < 0 || !InBounds(static_cast<size_t>(vtable), 4))
+		{
+			return 0;
+		}
+		uint16_t vtableSize = Read16(static_cast<size_t>(vtable));
+		size_t entry = static_cast<size_t>(vtable) + 4 + 2 * slot;
+		if (4 + 2 * static_cast<size_t>(slot) + 2 > vtableSize || !InBounds(entry, 2))
+		{
+			return 0;
+		}
+		uint16_t offset = Read16(entry);
+		return offset == 0 ? 0 : table + offset;
+	}
+
+	// Follows the offset stored at position at; returns 0 if it leaves the buffer.
+	size_t Deref(size_t at) const
+	{
+		if (!InBounds(at, 4))
+		{
+			return 0;
+		}
+		uint32_t offset;
+		memcpy(&offset, data + at, 4);
+		size_t target = at + offset;
+		return offset != 0 && InBounds(target, 4) ? target : 0;
+	}
+
+	// Follows an offset field, returning 0 if it is absent.
+	size_t Child(size_t table, int slot) const
+	{
+		size_t field = Field(table, slot);
+		return field == 0 ? 0 : Deref(field);
+	}
+
+	template <typename T>
+	T Scalar(size_t table, int slot, T fallback) const
+	{
+		size_t field = Field(table, slot);
+		if (field == 0 || !InBounds(field, sizeof(T)))
+		{
+			return fallback;
+		}
+		T v;
+		memcpy(&v, data + field, sizeof(T));
+		return v;
+	}
+
+	// The length of a vector, checking that its elements of elementSize bytes fit in the buffer.
+	size_t VectorLength(size_t vector, size_t elementSize) const
+	{
+		if (vector == 0)
+		{
+			return 0;
+		}
+		uint32_t length;
+		memcpy(&length, data + vector, 4);
+		return InBounds(vector + 4, static_cast<size_t>(length) * elementSize) ? length : 0;
+	}
+
+	const unsigned char* VectorData(size_t vector) const
+	{
+		return data + vector + 4;
+	}
+
+	// The table pointed at by element i of a vector of offsets.
+	size_t VectorTable(size_t vector, size_t i) const
+	{
+		return Deref(vector + 4 + 4 * i);
+	}
+
+	bool StringEquals(size_t string, const char* s) const
+	{
+		size_t length = strlen(s);
+		return string != 0 && VectorLength(string, 1) == length && memcmp(VectorData(string), s, length) == 0;
+	}
+
+private:
+	const unsigned char* data;
+	size_t size;
+
+	bool InBounds(size_t at, size_t n) const
+	{
+		return at <= size && n <= size - at;
+	}
+
+	uint16_t Read16(size_t at) const
+	{
+		uint16_t v;
+		memcpy(&v, data + at, 2);
+		return v;
+	}
+};
+
+// The type of a field, and for FixedSizeList the list size.
+static uint8_t FieldType(const FlatBufferReader& fb, size_t field, int32_t& listSize)
+{
+	uint8_t type = fb.Scalar<uint8_t>(field, 2, 0);
+	size_t typeTable = fb.Child(field, 3);
+	if (type == ARROW_TYPE_FLOATING_POINT)
+	{
+		return fb.Scalar<int16_t>(typeTable, 0, 0) == ARROW_PRECISION_SINGLE ? type : 0;
+	}
+	if (type == ARROW_TYPE_FIXED_SIZE_LIST)
+	{
+		listSize = fb.Scalar<int32_t>(typeTable, 0, 0);
+	}
+	return type;
+}
+
+// Works out the layout and dimension from a Schema table, rejecting anything else.
+static bool ReadSchema(const FlatBufferReader& fb, size_t schema, ArrowLayout& layout, int& dimension)
+{
+	// Big-endian data would need byte swapping, which would rule out mapping it.
+	if (schema == 0 || fb.Scalar<int16_t>(schema, 0, 0) != 0)
+	{
+		return false;
+	}
+	size_t fields = fb.Child(schema, 1);
+	size_t fieldCount = fb.VectorLength(fields, 4);
+	int32_t listSize = 0;
+	if (fieldCount == 1 && FieldType(fb, fb.VectorTable(fields, 0), listSize) == ARROW_TYPE_FIXED_SIZE_LIST)
+	{
+		size_t children = fb.Child(fb.VectorTable(fields, 0), 5);
+		int32_t unused;
+		if (listSize < 2 || listSize > 4 || fb.VectorLength(children, 4) != 1 || FieldType(fb, fb.VectorTable(children, 0), unused) != ARROW_TYPE_FLOATING_POINT)
+		{
+			return false;
+		}
+		layout = ArrowLayout::FixedSizeList;
+		dimension = listSize;
+		return true;
+	}
+	if (fieldCount < 2 || fieldCount > 4)
+	{
+		return false;
+	}
+	for (size_t i = 0; i < fieldCount; i++)
+	{
+		if (FieldType(fb, fb.VectorTable(fields, i), listSize) != ARROW_TYPE_FLOATING_POINT)
+		{
+			return false;
+		}
+	}
+	layout = ArrowLayout::Columns;
+	dimension = static_cast<int>(fieldCount);
+	return true;
+}
+
+//
+// Reading
+//
+
+ArrowVectorFile::ArrowVectorFile()
+	: layout(ArrowLayout::FixedSizeList), dimension(0)
+{
+}
+
+// Maps one record batch described by a footer block into a view.
+static bool ReadBatch(const MappedFile& file, const ArrowBlock& block, ArrowLayout layout, int dimension, VectorArrayView& view)
+{
+	// Compared by subtraction, since the lengths come from the file and could overflow a sum.
+	uint64_t size = file.size;
+	if (block.offset < 0 || block.metaDataLength < 8 || block.bodyLength < 0 ||
+		static_cast<uint64_t>(block.offset) > size ||
+		static_cast<uint64_t>(block.metaDataLength) > size - static_cast<uint64_t>(block.offset) ||
+		static_cast<uint64_t>(block.bodyLength) > size - static_cast<uint64_t>(block.offset) - static_cast<uint64_t>(block.metaDataLength) ||
+		(block.offset + block.metaDataLength) % 8 != 0)
+	{
+		return false;
+	}
+
+	// Files from before Arrow 0.15 have no continuation marker, just the metadata length.
+	const unsigned char* message = reinterpret_cast<const unsigned char*>(file.data) + block.offset;
+	uint32_t marker;
+	memcpy(&marker, message, 4);
+	size_t prefix = marker == ARROW_CONTINUATION ? 8 : 4;
+	FlatBufferReader fb(message + prefix, block.metaDataLength - prefix);
+	size_t root = fb.Root();
+	if (fb.Scalar<uint8_t>(root, 1, 0) != ARROW_HEADER_RECORD_BATCH)
+	{
+		return false;
+	}
+	size_t batch = fb.Child(root, 2);
+	int64_t rows = fb.Scalar<int64_t>(batch, 0, 0);
+	size_t nodes = fb.Child(batch, 1);
+	size_t buffers = fb.Child(batch, 2);
+	size_t nodeCount = fb.VectorLength(nodes, sizeof(ArrowFieldNode));
+	size_t bufferCount = fb.VectorLength(buffers, sizeof(ArrowBuffer));
+	size_t columns = layout == ArrowLayout::FixedSizeList ? 1 : dimension;
+	if (batch == 0 || rows < 0 || fb.Child(batch, 3) != 0 || nodeCount != (layout == ArrowLayout::FixedSizeList ? 2 : columns) || bufferCount != (layout == ArrowLayout::FixedSizeList ? 3 : 2 * columns))
+	{
+		return false;
+	}
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		ArrowFieldNode node;
+		memcpy(&node, fb.VectorData(nodes) + i * sizeof(node), sizeof(node));
+		if (node.nullCount != 0)
+		{
+			return false;
+		}
+	}
+
+	memset(&view, 0, sizeof(view));
+	view.count = static_cast<size_t>(rows);
+	view.dimension = dimension;
+	view.stride = layout == ArrowLayout::FixedSizeList ? dimension : 1;
+	const char* body = file.data + block.offset + block.metaDataLength;
+	uint64_t rowBytes = sizeof(float) * (layout == ArrowLayout::FixedSizeList ? dimension : 1);
+	for (size_t c = 0; c < columns; c++)
+	{
+		// The values buffer is the last buffer of each column.
+		ArrowBuffer values;
+		size_t index = layout == ArrowLayout::FixedSizeList ? 2 : 2 * c + 1;
+		memcpy(&values, fb.VectorData(buffers) + index * sizeof(values), sizeof(values));
+		// rows is bounded by division, since rows * rowBytes could wrap around.
+		if (values.offset < 0 || values.length < 0 || values.offset % sizeof(float) != 0 ||
+			values.offset > block.bodyLength || values.length > block.bodyLength - values.offset ||
+			static_cast<uint64_t>(rows) > static_cast<uint64_t>(values.length) / rowBytes)
+		{
+			return false;
+		}
+		const float* column = reinterpret_cast<const float*>(body + values.offset);
+		if (layout == ArrowLayout::FixedSizeList)
+		{
+			for (int d = 0; d < dimension; d++)
+			{
+				view.components[d] = column + d;
+			}
+		}
+		else
+		{
+			view.components[c] = column;
+		}
+	}
+	return true;
+}
+
+bool ArrowVectorFile::Open(const char* path)
+{
+	Close();
+	if (!file.Open(path) || file.size < 8 + 6 + 4 ||
+		memcmp(file.data, ARROW_MAGIC, 6) != 0 || memcmp(file.data + file.size - 6, ARROW_MAGIC, 6) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	// The file ends with the footer, its length, and the magic again.
+	uint32_t footerLength;
+	memcpy(&footerLength, file.data + file.size - 10, 4);
+	if (footerLength > file.size - 8 - 10)
+	{
+		Close();
+		return false;
+	}
+	const unsigned char* footer = reinterpret_cast<const unsigned char*>(file.data) + file.size - 10 - footerLength;
+	FlatBufferReader fb(footer, footerLength);
+	size_t root = fb.Root();
+	if (root == 0 || !ReadSchema(fb, fb.Child(root, 1), layout, dimension))
+	{
+		Close();
+		return false;
+	}
+	size_t blocks = fb.Child(root, 3);
+	size_t blockCount = fb.VectorLength(blocks, sizeof(ArrowBlock));
+	batches.resize(blockCount);
+	for (size_t i = 0; i < blockCount; i++)
+	{
+		ArrowBlock block;
+		memcpy(&block, fb.VectorData(blocks) + i * sizeof(block), sizeof(block));
+		if (!ReadBatch(file, block, layout, dimension, batches[i]))
+		{
+			Close();
+			return false;
+		}
+	}
+	return true;
+}
+
+void ArrowVectorFile::Close()
+{
+	file.Close();
+	batches.clear();
+	dimension = 0;
+}
+
+size_t ArrowVectorFile::Count() const
+{
+	size_t count = 0;
+	for (const VectorArrayView& batch : batches)
+	{
+		count += batch.count;
+	}
+	return count;
+}
@@ -0,0 +1,330 @@
+/*
+Title: Vector Mathematics
+File Name: AsyncStream.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/AsyncStream.h"
+
+#include <vector>
+
+#include "../header/Trace.h"
+#include "../header/VectorFile.h"
+#include "../header/VectorParser.h"
+
+IoThread::IoThread(ThreadPool& pool)
+	: pool(pool), stopping(false)
+{
+	thread = std::thread(&IoThread::Loop, this);
+}
+
+IoThread::~IoThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	thread.join();
+}
+
+void IoThread::Post(std::function<void()> job)
+{
+	// Notify under the lock: the job may let its owner finish and destroy this object as soon as the lock is released.
+	std::lock_guard<std::mutex> lock(mutex);
+	jobs.push_back(std::move(job));
+	wake.notify_one();
+}
+
+void IoThread::Loop()
+{
+	SetTraceThreadName("stream io");
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;)
+	{
+		wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+		if (jobs.empty())
+		{
+			return;
+		}
+		std::function<void()> job = std::move(jobs.front());
+		jobs.pop_front();
+		lock.unlock();
+		job();
+		lock.lock();
+	}
+}
+
+StreamOptions::StreamOptions()
+	: chunkBytes(4 << 20), chunksInFlight(0), format(NumberFormat::Shortest), precision(6)
+{
+}
+
+// One chunk's results, ready to be written.
+struct StreamChunk
+{
+	bool ok;
+	size_t vectors;
+	// Input lines the chunk covered, to turn its errorLine into one for the whole file.
+	size_t lines;
+	size_t errorLine;
+	std::vector<char> text;
+};
+
+struct ChunkRange
+{
+	size_t begin;
+	size_t end;
+};
+
+static Generator<ChunkRange> Chunks(size_t count, size_t chunkSize)
+{
+	for (size_t begin = 0; begin < count; begin += chunkSize)
+	{
+		co_yield ChunkRange{begin, count - begin < chunkSize ? count : begin + chunkSize};
+	}
+}
+
+static size_t CountLines(const std::vector<char>& text)
+{
+	size_t lines = 0;
+	for (char c : text)
+	{
+		lines += c == '\n';
+	}
+	return lines + (!text.empty() && text.back() != '\n');
+}
+
+static const Vector2D* AsVectors(const VectorArrayView& view, Vector2D*)
+{
+	return AsVector2D(view);
+}
+
+static const Vector3D* AsVectors(const VectorArrayView& view, Vector3D*)
+{
+	return AsVector3D(view);
+}
+
+static const Vector4D* AsVectors(const VectorArrayView& view, Vector4D*)
+{
+	return AsVector4D(view);
+}
+
+// Parses, computes, and formats one chunk of text on the pool.
+template <typename V>
+static Task<StreamChunk> ProcessText(ThreadPool& pool, std::vector<char> text, const StreamKernel<V>& kernel, const StreamOptions& options)
+{
+	co_await Schedule(pool);
+	TraceScope trace("text chunk", "kernel", "bytes", text.size());
+	StreamChunk chunk = {true, 0, CountLines(text), 0, {}};
+	std::vector<V> vectors(CountVectorLines(text.data(), text.size()));
+	ParseResult parsed = ParseVectors(text.data(), text.size(), vectors.data(), vectors.size());
+	if (!parsed.ok)
+	{
+		chunk.ok = false;
+		chunk.errorLine = parsed.errorLine;
+		co_return chunk;
+	}
+	kernel(vectors.data(), vectors.data(), parsed.count);
+	AppendVectorText(chunk.text, vectors.data(), parsed.count, options.format, options.precision);
+	chunk.vectors = parsed.count;
+	co_return chunk;
+}
+
+// Computes and formats vectors [range.begin, range.end) of a mapped file on the pool.
+// AoS data is read in place; SoA data is gathered first.
+template <typename V>
+static Task<StreamChunk> ProcessMapped(ThreadPool& pool, const VectorArrayView& view, ChunkRange range, const StreamKernel<V>& kernel, const StreamOptions& options)
+{
+	co_await Schedule(pool);
+	size_t count = range.end - range.begin;
+	TraceScope trace("mapped chunk", "kernel", "vectors", count);
+	std::vector<V> vectors(count);
+	const V* in = AsVectors(view, static_cast<V*>(nullptr));
+	if (in != nullptr)
+	{
+		in += range.begin;
+	}
+	else
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			float* components = &vectors[i].x;
+			for (int c = 0; c < view.dimension; c++)
+			{
+				components[c] = view.components[c][(range.begin + i) * view.stride];
+			}
+		}
+		in = vectors.data();
+	}
+	kernel(in, vectors.data(), count);
+	StreamChunk chunk = {true, count, count, 0, {}};
+	AppendVectorText(chunk.text, vectors.data(), count, options.format, options.precision);
+	co_return chunk;
+}
+
+// Awaits chunks in input order and writes each as it finishes, until at most keep are still in flight.
+// After a failure the remaining chunks are only awaited, since a started task must finish before it is freed.
+static Task<void> Retire(std::deque<Task<StreamChunk>>& inflight, size_t keep, FILE* out, IoThread& io, size_t& lines, StreamResult& result)
+{
+	while (inflight.size() > keep)
+	{
+		StreamChunk chunk = co_await inflight.front();
+		inflight.pop_front();
+		if (!result.ok)
+		{
+			continue;
+		}
+		if (!chunk.ok)
+		{
+			result.ok = false;
+			result.errorLine = lines + chunk.errorLine;
+			continue;
+		}
+		size_t written = co_await io.Run([&]
+		{
+			TraceScope trace("write", "io", "bytes", chunk.text.size());
+			return fwrite(chunk.text.data(), 1, chunk.text.size(), out);
+		});
+		if (written != chunk.text.size())
+		{
+			result.ok = false;
+			continue;
+		}
+		lines += chunk.lines;
+		result.vectors += chunk.vectors;
+	}
+}
+
+template <typename V>
+static Task<void> StreamText(FILE* in, FILE* out, IoThread& io, ThreadPool& pool, const StreamKernel<V>& kernel, const StreamOptions& options, size_t window, StreamResult& result)
+{
+	std::deque<Task<StreamChunk>> inflight;
+	std::vector<char> carry;
+	size_t lines = 0;
+	bool end = false;
+	while (!end && result.ok)
+	{
+		std::vector<char> text;
+		text.swap(carry);
+		size_t have = text.size();
+		text.resize(have + options.chunkBytes);
+		size_t got = co_await io.Run([&]
+		{
+			TraceScope trace("read", "io", "bytes", options.chunkBytes);
+			return fread(text.data() + have, 1, options.chunkBytes, in);
+		});
+		text.resize(have + got);
+		if (got < options.chunkBytes)
+		{
+			end = true;
+			if (ferror(in))
+			{
+				result.ok = false;
+				break;
+			}
+		}
+		else
+		{
+			// Carry the partial last line over to the next chunk. A line longer than a whole chunk
+			//  just keeps growing until its newline arrives.
+			size_t cut = text.size();
+			while (cut > 0 && text[cut - 1] != '\n')
+			{
+				cut--;
+			}
+			carry.assign(text.begin() + cut, text.end());
+			text.resize(cut);
+		}
+		if (!text.empty())
+		{
+			inflight.push_back(ProcessText<V>(pool, std::move(text), kernel, options));
+			inflight.back().Start();
+		}
+		co_await Retire(inflight, window - 1, out, io, lines, result);
+	}
+	co_await Retire(inflight, 0, out, io, lines, result);
+}
+
+template <typename V>
+static Task<void> StreamMapped(const VectorArrayView& view, FILE* out, IoThread& io, ThreadPool& pool, const StreamKernel<V>& kernel, const StreamOptions& options, size_t window, StreamResult& result)
+{
+	std::deque<Task<StreamChunk>> inflight;
+	size_t lines = 0;
+	size_t chunkSize = options.chunkBytes / sizeof(V) > 0 ? options.chunkBytes / sizeof(V) : 1;
+	for (ChunkRange range : Chunks(view.count, chunkSize))
+	{
+		inflight.push_back(ProcessMapped<V>(pool, view, range, kernel, options));
+		inflight.back().Start();
+		co_await Retire(inflight, window - 1, out, io, lines, result);
+		if (!result.ok)
+		{
+			break;
+		}
+	}
+	co_await Retire(inflight, 0, out, io, lines, result);
+}
+
+template <typename V>
+static StreamResult Stream(const char* inPath, FILE* out, const StreamKernel<V>& kernel, ThreadPool& pool, const StreamOptions& options)
+{
+	StreamResult result = {true, 0, 0};
+	size_t window = options.chunksInFlight > 0 ? options.chunksInFlight : 2 * pool.Size();
+	IoThread io(pool);
+
+	VectorFile file;
+	if (file.Open(inPath))
+	{
+		if (file.view.dimension != static_cast<int>(sizeof(V) / sizeof(float)))
+		{
+			result.ok = false;
+			return result;
+		}
+		SyncWait(StreamMapped<V>(file.view, out, io, pool, kernel, options, window, result));
+	}
+	else
+	{
+		FILE* in = fopen(inPath, "rb");
+		if (in == nullptr)
+		{
+			result.ok = false;
+			return result;
+		}
+		SyncWait(StreamText<V>(in, out, io, pool, kernel, options, window, result));
+		fclose(in);
+	}
+	if (fflush(out) != 0)
+	{
+		result.ok = false;
+	}
+	return result;
+}
+
+StreamResult StreamVectors(const char* inPath, FILE* out, const StreamKernel<Vector2D>& kernel, ThreadPool& pool, const StreamOptions& options)
+{
+	return Stream(inPath, out, kernel, pool, options);
+}
+
+StreamResult StreamVectors(const char* inPath, FILE* out, const StreamKernel<Vector3D>& kernel, ThreadPool& pool, const StreamOptions& options)
+{
+	return Stream(inPath, out, kernel, pool, options);
+}
+
+StreamResult StreamVectors(const char* inPath, FILE* out, const StreamKernel<Vector4D>& kernel, ThreadPool& pool, const StreamOptions& options)
+{
+	return Stream(inPath, out, kernel, pool, options);
+}
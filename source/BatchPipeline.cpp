@@ -0,0 +1,220 @@
+/*
+Title: Vector Mathematics
+File Name: BatchPipeline.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/BatchPipeline.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+static double PipelineSeconds()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename V>
+BatchPipeline<V>::BatchPipeline(size_t batchCapacity, size_t batchCount)
+	: batchCapacity(batchCapacity ? batchCapacity : 1), batchCount(batchCount ? batchCount : 1)
+{
+}
+
+template <typename V>
+BatchPipeline<V>& BatchPipeline<V>::Source(const char* name, SourceFunction function)
+{
+	StageDefinition definition = { name, function, nullptr, nullptr, 1 };
+	stages.push_back(definition);
+	return *this;
+}
+
+template <typename V>
+BatchPipeline<V>& BatchPipeline<V>::Stage(const char* name, StageFunction function, unsigned threads)
+{
+	StageDefinition definition = { name, nullptr, function, nullptr, threads ? threads : 1 };
+	stages.push_back(definition);
+	return *this;
+}
+
+template <typename V>
+BatchPipeline<V>& BatchPipeline<V>::Sink(const char* name, SinkFunction function)
+{
+	StageDefinition definition = { name, nullptr, nullptr, function, 1 };
+	stages.push_back(definition);
+	return *this;
+}
+
+template <typename V>
+bool BatchPipeline<V>::Run()
+{
+	size_t stageCount = stages.size();
+	if (stageCount < 2 || !stages.front().source || !stages.back().sink)
+	{
+		return false;
+	}
+	for (size_t s = 1; s + 1 < stageCount; s++)
+	{
+		if (!stages[s].stage)
+		{
+			return false;
+		}
+	}
+
+	// Queue s feeds stage s + 1. Each can hold every batch, so pushes never wait;
+	//  all backpressure comes from the source waiting on the pool.
+	BatchPool<V> pool(batchCount, batchCapacity);
+	std::vector<std::unique_ptr<BoundedQueue<BatchSlot<V>>>> queues;
+	for (size_t q = 0; q + 1 < stageCount; q++)
+	{
+		queues.emplace_back(new BoundedQueue<BatchSlot<V>>(batchCount));
+	}
+
+	stats.assign(stageCount, StageStats());
+	std::unique_ptr<std::atomic<unsigned>[]> running(new std::atomic<unsigned>[stageCount]);
+	for (size_t s = 0; s < stageCount; s++)
+	{
+		stats[s].name = stages[s].name;
+		stats[s].threads = stages[s].threads;
+		running[s].store(stages[s].threads);
+	}
+	std::mutex statsMutex;
+	double start = PipelineSeconds();
+
+	auto worker = [&](size_t s)
+	{
+		const StageDefinition& stage = stages[s];
+		unsigned long long batches = 0, vectors = 0, sequence = 0;
+		double busy = 0.0, depthSum = 0.0;
+		size_t maxDepth = 0;
+
+		if (s == 0)
+		{
+			for (bool more = true; more;)
+			{
+				BatchSlot<V>* batch = pool.Acquire();
+				batch->sequence = sequence++;
+				double t = PipelineSeconds();
+				more = stage.source(*batch);
+				busy += PipelineSeconds() - t;
+				if (batch->count == 0)
+				{
+					pool.Release(batch);
+					continue;
+				}
+				batches++;
+				vectors += batch->count;
+				queues[0]->Push(batch);
+			}
+		}
+		else
+		{
+			BoundedQueue<BatchSlot<V>>& input = *queues[s - 1];
+			bool last = s + 1 == stageCount;
+			for (;;)
+			{
+				size_t depth = input.Depth();
+				BatchSlot<V>* batch;
+				if (!input.Pop(batch))
+				{
+					break;
+				}
+				depthSum += static_cast<double>(depth);
+				maxDepth = depth > maxDepth ? depth : maxDepth;
+				double t = PipelineSeconds();
+				if (last)
+				{
+					stage.sink(*batch);
+				}
+				else
+				{
+					stage.stage(*batch);
+				}
+				busy += PipelineSeconds() - t;
+				batches++;
+				vectors += batch->count;
+				if (last)
+				{
+					pool.Release(batch);
+				}
+				else
+				{
+					queues[s]->Push(batch);
+				}
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(statsMutex);
+			StageStats& result = stats[s];
+			result.batches += batches;
+			result.vectors += vectors;
+			result.busySeconds += busy;
+			result.meanQueueDepth += depthSum;
+			result.maxQueueDepth = maxDepth > result.maxQueueDepth ? maxDepth : result.maxQueueDepth;
+			double elapsed = PipelineSeconds() - start;
+			result.seconds = elapsed > result.seconds ? elapsed : result.seconds;
+		}
+		// The stage's last thread to finish tells the next stage nothing more is coming.
+		if (running[s].fetch_sub(1) == 1 && s < queues.size())
+		{
+			queues[s]->Close();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t s = 0; s < stageCount; s++)
+	{
+		for (unsigned t = 0; t < stages[s].threads; t++)
+		{
+			threads.emplace_back(worker, s);
+		}
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	for (StageStats& result : stats)
+	{
+		result.meanQueueDepth = result.batches ? result.meanQueueDepth / result.batches : 0.0;
+	}
+	return true;
+}
+
+template <typename V>
+const std::vector<StageStats>& BatchPipeline<V>::Stats() const
+{
+	return stats;
+}
+
+template <typename V>
+void BatchPipeline<V>::PrintStats(FILE* out) const
+{
+	for (const StageStats& s : stats)
+	{
+		double throughput = s.seconds > 0.0 ? s.vectors / s.seconds / 1e6 : 0.0;
+		double busy = s.seconds > 0.0 ? 100.0 * s.busySeconds / (s.seconds * s.threads) : 0.0;
+		fprintf(out, "%-16s %2u threads %8llu batches %9.2f Mvectors/s  busy %5.1f%%  queue depth mean %5.1f max %3zu\n",
+			s.name.c_str(), s.threads, s.batches, throughput, busy, s.meanQueueDepth, s.maxQueueDepth);
+	}
+}
+
+template class BatchPipeline<Vector3D>;
+template class BatchPipeline<Vector4D>;
@@ -0,0 +1,231 @@
+/*
+Title: Vector Mathematics
+File Name: BatchQueue.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/BatchQueue.h"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+// Backs off from a busy wait in stages: spin, then yield, then sleep, so a short wait stays
+//  cheap but a long one does not burn a core.
+static void Backoff(int& attempt)
+{
+	if (attempt >= 1024)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(50));
+	}
+	else if (attempt >= 64)
+	{
+		std::this_thread::yield();
+	}
+	attempt++;
+}
+
+template <typename T>
+BoundedQueue<T>::BoundedQueue(size_t capacity)
+	: enqueuePosition(0), dequeuePosition(0), closed(false)
+{
+	size_t size = 2;
+	while (size < capacity)
+	{
+		size <<= 1;
+	}
+	mask = size - 1;
+	cells = new Cell[size];
+	for (size_t i = 0; i < size; i++)
+	{
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+		cells[i].item = nullptr;
+	}
+}
+
+template <typename T>
+BoundedQueue<T>::~BoundedQueue()
+{
+	delete[] cells;
+}
+
+template <typename T>
+bool BoundedQueue<T>::TryPush(T* item)
+{
+	size_t position = enqueuePosition.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		Cell& cell = cells[position & mask];
+		size_t sequence = cell.sequence.load(std::memory_order_acquire);
+		// The cell is free for this lap when its sequence equals the position.
+		intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+		if (difference == 0)
+		{
+			if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				cell.item = item;
+				cell.sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (difference < 0)
+		{
+			// Still holding last lap's item: the queue is full.
+			return false;
+		}
+		else
+		{
+			position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template <typename T>
+bool BoundedQueue<T>::TryPop(T*& item)
+{
+	size_t position = dequeuePosition.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		Cell& cell = cells[position & mask];
+		size_t sequence = cell.sequence.load(std::memory_order_acquire);
+		// The cell holds an item for this lap when its sequence is one past the position.
+		intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+		if (difference == 0)
+		{
+			if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				item = cell.item;
+				// Free the cell for the producer one lap ahead.
+				cell.sequence.store(position + mask + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (difference < 0)
+		{
+			return false;
+		}
+		else
+		{
+			position = dequeuePosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template <typename T>
+bool BoundedQueue<T>::Push(T* item)
+{
+	for (int attempt = 0;; Backoff(attempt))
+	{
+		if (closed.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		if (TryPush(item))
+		{
+			return true;
+		}
+	}
+}
+
+template <typename T>
+bool BoundedQueue<T>::Pop(T*& item)
+{
+	for (int attempt = 0;; Backoff(attempt))
+	{
+		if (TryPop(item))
+		{
+			return true;
+		}
+		// Check again after seeing closed, since an item may have been pushed just before Close.
+		if (closed.load(std::memory_order_acquire))
+		{
+			return TryPop(item);
+		}
+	}
+}
+
+template <typename T>
+void BoundedQueue<T>::Close()
+{
+	closed.store(true, std::memory_order_release);
+}
+
+template <typename T>
+bool BoundedQueue<T>::Closed() const
+{
+	return closed.load(std::memory_order_acquire);
+}
+
+template <typename T>
+size_t BoundedQueue<T>::Depth() const
+{
+	size_t enqueued = enqueuePosition.load(std::memory_order_relaxed);
+	size_t dequeued = dequeuePosition.load(std::memory_order_relaxed);
+	return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+template <typename T>
+size_t BoundedQueue<T>::Capacity() const
+{
+	return mask + 1;
+}
+
+template <typename V>
+BatchPool<V>::BatchPool(size_t batchCount, size_t batchCapacity)
+	: storage(batchCount * batchCapacity), slots(batchCount), free(batchCount)
+{
+	for (size_t i = 0; i < batchCount; i++)
+	{
+		slots[i].vectors = storage.data() + i * batchCapacity;
+		slots[i].count = 0;
+		slots[i].capacity = batchCapacity;
+		slots[i].sequence = 0;
+		free.TryPush(&slots[i]);
+	}
+}
+
+template <typename V>
+BatchSlot<V>* BatchPool<V>::Acquire()
+{
+	BatchSlot<V>* batch = nullptr;
+	free.Pop(batch);
+	batch->count = 0;
+	return batch;
+}
+
+template <typename V>
+void BatchPool<V>::Release(BatchSlot<V>* batch)
+{
+	free.TryPush(batch);
+}
+
+template <typename V>
+size_t BatchPool<V>::BatchCount() const
+{
+	return slots.size();
+}
+
+template <typename V>
+size_t BatchPool<V>::BatchCapacity() const
+{
+	return slots.empty() ? 0 : slots[0].capacity;
+}
+
+template class BoundedQueue<BatchSlot<Vector3D>>;
+template class BoundedQueue<BatchSlot<Vector4D>>;
+template class BatchPool<Vector3D>;
+template class BatchPool<Vector4D>;
@@ -0,0 +1,658 @@
+/*
+Title: Vector Mathematics
+File Name: BulkIO.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/BulkIO.h"
+
+#include <cstring>
+#include <vector>
+
+#include "../header/VectorFile.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../header/ThreadPool.h"
+#include "../header/Trace.h"
+#endif
+
+#ifdef __linux__
+#include <atomic>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+BulkIOOptions::BulkIOOptions()
+	: chunkBytes(4 << 20), queueDepth(8), direct(true), useIoUring(true)
+{
+}
+
+#ifndef _WIN32
+
+// O_DIRECT needs offsets, lengths and buffer addresses aligned to the device's logical block
+//  size, which is 512 or 4096 bytes; 4096 satisfies both.
+static const size_t DIRECT_ALIGNMENT = 4096;
+
+static uint64_t AlignDown(uint64_t n)
+{
+	return n / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+}
+
+static uint64_t AlignUp(uint64_t n)
+{
+	return (n + DIRECT_ALIGNMENT - 1) / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+}
+
+// One block-aligned buffer per chunk in flight, allocated together.
+struct ChunkBuffers
+{
+	unsigned char* memory;
+	size_t size;
+	unsigned count;
+
+	ChunkBuffers(unsigned count, size_t size)
+		: memory(static_cast<unsigned char*>(std::aligned_alloc(DIRECT_ALIGNMENT, count * size))), size(size), count(count)
+	{
+	}
+
+	~ChunkBuffers()
+	{
+		std::free(memory);
+	}
+
+	unsigned char* operator[](unsigned slot) const
+	{
+		return memory + slot * size;
+	}
+
+private:
+	ChunkBuffers(const ChunkBuffers&);
+	ChunkBuffers& operator=(const ChunkBuffers&);
+};
+
+#ifdef __linux__
+
+// A minimal io_uring, set up and driven with raw system calls so there is no liburing dependency.
+// Only this thread touches the rings: it fills submission entries and consumes completions.
+class Uring
+{
+public:
+	Uring()
+		: fd(-1), sqRing(nullptr), sqRingSize(0), cqRing(nullptr), cqRingSize(0), sqes(nullptr), sqesSize(0), registered(false)
+	{
+	}
+
+	~Uring()
+	{
+		if (sqes != nullptr)
+		{
+			munmap(sqes, sqesSize);
+		}
+		if (cqRing != nullptr && cqRing != sqRing)
+		{
+			munmap(cqRing, cqRingSize);
+		}
+		if (sqRing != nullptr)
+		{
+			munmap(sqRing, sqRingSize);
+		}
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+	}
+
+	bool Setup(unsigned entries)
+	{
+		io_uring_params params;
+		memset(&params, 0, sizeof(params));
+		fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (single)
+		{
+			sqRingSize = cqRingSize = sqRingSize > cqRingSize ? sqRingSize : cqRingSize;
+		}
+		sqRing = Map(sqRingSize, IORING_OFF_SQ_RING);
+		cqRing = single ? sqRing : Map(cqRingSize, IORING_OFF_CQ_RING);
+		sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		sqes = static_cast<io_uring_sqe*>(Map(sqesSize, IORING_OFF_SQES));
+		if (sqRing == nullptr || cqRing == nullptr || sqes == nullptr)
+		{
+			return false;
+		}
+
+		char* sq = static_cast<char*>(sqRing);
+		sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+		sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+		sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+		char* cq = static_cast<char*>(cqRing);
+		cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+		cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+		cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+		cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+		return true;
+	}
+
+	// Pins the buffers in the kernel once, so each transfer skips mapping them again.
+	void RegisterBuffers(const ChunkBuffers& buffers)
+	{
+		std::vector<iovec> iov(buffers.count);
+		for (unsigned slot = 0; slot < buffers.count; slot++)
+		{
+			iov[slot].iov_base = buffers[slot];
+			iov[slot].iov_len = buffers.size;
+		}
+		registered = syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, iov.data(), buffers.count) == 0;
+	}
+
+	bool Registered() const
+	{
+		return registered;
+	}
+
+	bool Submit(bool write, int file, unsigned char* buffer, unsigned slot, size_t length, uint64_t offset)
+	{
+		unsigned tail = *sqTail;
+		unsigned index = tail & sqMask;
+		io_uring_sqe* sqe = &sqes[index];
+		memset(sqe, 0, sizeof(*sqe));
+		if (registered)
+		{
+			sqe->opcode = write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+			sqe->buf_index = static_cast<uint16_t>(slot);
+		}
+		else
+		{
+			sqe->opcode = write ? IORING_OP_WRITE : IORING_OP_READ;
+		}
+		sqe->fd = file;
+		sqe->off = offset;
+		sqe->addr = reinterpret_cast<uint64_t>(buffer);
+		sqe->len = static_cast<uint32_t>(length);
+		sqe->user_data = slot;
+		sqArray[index] = index;
+		std::atomic_ref<unsigned>(*sqTail).store(tail + 1, std::memory_order_release);
+
+		for (;;)
+		{
+			long submitted = syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0);
+			if (submitted >= 0 || errno != EINTR)
+			{
+				return submitted == 1;
+			}
+		}
+	}
+
+	bool Wait(unsigned& slot, long& result)
+	{
+		for (;;)
+		{
+			unsigned head = *cqHead;
+			if (head != std::atomic_ref<unsigned>(*cqTail).load(std::memory_order_acquire))
+			{
+				const io_uring_cqe& cqe = cqes[head & cqMask];
+				slot = static_cast<unsigned>(cqe.user_data);
+				result = cqe.res;
+				std::atomic_ref<unsigned>(*cqHead).store(head + 1, std::memory_order_release);
+				return true;
+			}
+			if (syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR)
+			{
+				return false;
+			}
+		}
+	}
+
+private:
+	int fd;
+	void* sqRing;
+	size_t sqRingSize;
+	void* cqRing;
+	size_t cqRingSize;
+	io_uring_sqe* sqes;
+	size_t sqesSize;
+	unsigned* sqTail;
+	unsigned sqMask;
+	unsigned* sqArray;
+	unsigned* cqHead;
+	unsigned* cqTail;
+	unsigned cqMask;
+	io_uring_cqe* cqes;
+	bool registered;
+
+	void* Map(size_t size, off_t offset)
+	{
+		void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+		return p == MAP_FAILED ? nullptr : p;
+	}
+
+	Uring(const Uring&);
+	Uring& operator=(const Uring&);
+};
+
+#endif
+
+// Keeps up to one transfer per buffer in flight, through io_uring when it can be set up and
+//  otherwise through a few threads calling pread and pwrite.
+class ChunkQueue
+{
+public:
+	ChunkQueue(int fd, const ChunkBuffers& buffers, bool useIoUring, BulkIOStats& stats)
+		: fd(fd), buffers(buffers), inFlight(0), ring(false)
+	{
+#ifdef __linux__
+		if (useIoUring && uring.Setup(buffers.count))
+		{
+			uring.RegisterBuffers(buffers);
+			ring = true;
+		}
+#else
+		(void)useIoUring;
+#endif
+		if (!ring)
+		{
+			threads.reset(new ThreadPool(buffers.count + 1));
+		}
+		stats.engine = ring ? BulkIOEngine::IoUring : BulkIOEngine::Threads;
+#ifdef __linux__
+		stats.registeredBuffers = ring && uring.Registered();
+#endif
+	}
+
+	// Starts moving length bytes between buffer slot and the file at offset.
+	bool Submit(unsigned slot, bool write, uint64_t offset, size_t length)
+	{
+#ifdef __linux__
+		if (ring)
+		{
+			if (!uring.Submit(write, fd, buffers[slot], slot, length, offset))
+			{
+				return false;
+			}
+			inFlight++;
+			return true;
+		}
+#endif
+		inFlight++;
+		threads->Post([this, slot, write, offset, length]
+		{
+			long result;
+			{
+				TraceScope trace(write ? "pwrite" : "pread", "io", "bytes", length);
+				result = Transfer(write, buffers[slot], length, offset);
+			}
+			std::lock_guard<std::mutex> lock(mutex);
+			completed.emplace_back(slot, result);
+			done.notify_one();
+		});
+		return true;
+	}
+
+	// Waits for a transfer to finish. result is the number of bytes moved, or -errno.
+	bool Wait(unsigned& slot, long& result)
+	{
+		TraceScope trace("wait", "io");
+		inFlight--;
+#ifdef __linux__
+		if (ring)
+		{
+			return uring.Wait(slot, result);
+		}
+#endif
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [this] { return !completed.empty(); });
+		slot = completed.front().first;
+		result = completed.front().second;
+		completed.pop_front();
+		return true;
+	}
+
+	unsigned InFlight() const
+	{
+		return inFlight;
+	}
+
+private:
+	int fd;
+	const ChunkBuffers& buffers;
+	unsigned inFlight;
+	bool ring;
+#ifdef __linux__
+	Uring uring;
+#endif
+	std::unique_ptr<ThreadPool> threads;
+	std::mutex mutex;
+	std::condition_variable done;
+	std::deque<std::pair<unsigned, long>> completed;
+
+	// Moves all length bytes, stopping early only at the end of the file.
+	long Transfer(bool write, unsigned char* buffer, size_t length, uint64_t offset)
+	{
+		size_t moved = 0;
+		while (moved < length)
+		{
+			ssize_t n = write ? pwrite(fd, buffer + moved, length - moved, offset + moved)
+				: pread(fd, buffer + moved, length - moved, offset + moved);
+			if (n < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (n < 0)
+			{
+				return -errno;
+			}
+			if (n == 0)
+			{
+				break;
+			}
+			moved += n;
+		}
+		return static_cast<long>(moved);
+	}
+
+	ChunkQueue(const ChunkQueue&);
+	ChunkQueue& operator=(const ChunkQueue&);
+};
+
+// Opens path with O_DIRECT if asked and the filesystem allows it, otherwise without.
+static int OpenFile(const char* path, int flags, bool tryDirect, bool& direct)
+{
+	direct = false;
+#ifdef O_DIRECT
+	if (tryDirect)
+	{
+		int fd = open(path, flags | O_DIRECT | O_CLOEXEC, 0644);
+		if (fd >= 0)
+		{
+			direct = true;
+			return fd;
+		}
+	}
+#else
+	(void)tryDirect;
+#endif
+	return open(path, flags | O_CLOEXEC, 0644);
+}
+
+template <typename V>
+static bool ReadBulk(const char* path, const BulkChunkFunction<V>& consume, const BulkIOOptions& options, BulkIOStats* stats)
+{
+	BulkIOStats local;
+	BulkIOStats& s = stats != nullptr ? *stats : local;
+	s = { BulkIOEngine::Threads, false, false, 0, 0 };
+
+	int fd = OpenFile(path, O_RDONLY, options.direct, s.direct);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0)
+	{
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return false;
+	}
+
+	// Chunks hold whole vectors, but the data starts part way into a block, so each read is
+	//  widened to whole blocks on both sides.
+	const size_t vectorBytes = sizeof(V);
+	size_t perChunk = options.chunkBytes / vectorBytes > 0 ? options.chunkBytes / vectorBytes : 1;
+	size_t chunkData = perChunk * vectorBytes;
+	ChunkBuffers buffers(options.queueDepth > 0 ? options.queueDepth : 1, AlignUp(chunkData) + 2 * DIRECT_ALIGNMENT);
+	if (buffers.memory == nullptr)
+	{
+		close(fd);
+		return false;
+	}
+
+	VectorFileHeader h;
+	bool ok = pread(fd, buffers[0], DIRECT_ALIGNMENT, 0) >= static_cast<ssize_t>(sizeof(h));
+	if (ok)
+	{
+		memcpy(&h, buffers[0], sizeof(h));
+		ok = ValidVectorFileHeader(h, static_cast<uint64_t>(st.st_size)) &&
+			h.layout == static_cast<uint8_t>(VectorLayout::AoS) &&
+			h.dimension * sizeof(float) == vectorBytes;
+	}
+	if (!ok)
+	{
+		close(fd);
+		return false;
+	}
+
+	size_t count = static_cast<size_t>(h.count);
+	size_t chunks = (count + perChunk - 1) / perChunk;
+	uint64_t fileSize = static_cast<uint64_t>(st.st_size);
+	std::vector<size_t> slotChunk(buffers.count);
+	size_t next = 0;
+	{
+		ChunkQueue queue(fd, buffers, options.useIoUring, s);
+		auto start = [&](unsigned slot)
+		{
+			slotChunk[slot] = next;
+			uint64_t begin = h.dataOffset + next * chunkData;
+			uint64_t end = begin + chunkData < h.dataOffset + count * vectorBytes ? begin + chunkData : h.dataOffset + count * vectorBytes;
+			next++;
+			return queue.Submit(slot, false, AlignDown(begin), static_cast<size_t>(AlignUp(end) - AlignDown(begin)));
+		};
+		for (unsigned slot = 0; ok && slot < buffers.count && next < chunks; slot++)
+		{
+			ok = start(slot);
+		}
+
+		// After a failure, keep waiting until nothing is in flight, since the buffers are about to be freed.
+		while (queue.InFlight() > 0)
+		{
+			unsigned slot;
+			long result;
+			if (!queue.Wait(slot, result))
+			{
+				ok = false;
+				break;
+			}
+			if (!ok)
+			{
+				continue;
+			}
+
+			size_t chunk = slotChunk[slot];
+			size_t first = chunk * perChunk;
+			size_t n = count - first < perChunk ? count - first : perChunk;
+			uint64_t begin = h.dataOffset + first * vectorBytes;
+			uint64_t aligned = AlignDown(begin);
+			uint64_t end = AlignUp(begin + n * vectorBytes);
+			uint64_t expected = (end < fileSize ? end : fileSize) - aligned;
+			if (result < 0 || static_cast<uint64_t>(result) != expected)
+			{
+				ok = false;
+				continue;
+			}
+			{
+				TraceScope trace("consume", "kernel", "vectors", n);
+				consume(reinterpret_cast<const V*>(buffers[slot] + (begin - aligned)), first, n);
+			}
+			s.chunks++;
+			s.bytes += n * vectorBytes;
+			if (next < chunks)
+			{
+				ok = start(slot);
+			}
+		}
+	}
+	close(fd);
+	return ok;
+}
+
+template <typename V>
+static bool WriteBulk(const char* path, const V* v, size_t count, const BulkIOOptions& options, BulkIOStats* stats)
+{
+	BulkIOStats local;
+	BulkIOStats& s = stats != nullptr ? *stats : local;
+	s = { BulkIOEngine::Threads, false, false, 0, 0 };
+
+	VectorFileHeader h = MakeVectorFileHeader(static_cast<int>(sizeof(V) / sizeof(float)), count, VectorLayout::AoS);
+	h.checksum = VectorFileChecksum(v, static_cast<size_t>(h.dataSize));
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(v);
+	uint64_t total = h.dataOffset + h.dataSize;
+
+	int fd = OpenFile(path, O_WRONLY | O_CREAT | O_TRUNC, options.direct, s.direct);
+	if (fd < 0)
+	{
+		return false;
+	}
+	size_t chunkSize = static_cast<size_t>(AlignUp(options.chunkBytes > 0 ? options.chunkBytes : 1));
+	ChunkBuffers buffers(options.queueDepth > 0 ? options.queueDepth : 1, chunkSize);
+	if (buffers.memory == nullptr)
+	{
+		close(fd);
+		return false;
+	}
+
+	size_t chunks = static_cast<size_t>((total + chunkSize - 1) / chunkSize);
+	std::vector<size_t> slotLength(buffers.count);
+	size_t next = 0;
+	bool ok = true;
+	{
+		ChunkQueue queue(fd, buffers, options.useIoUring, s);
+		// Copies the next chunk of the file image (header, padding, then data) into slot and starts writing it.
+		// With O_DIRECT the last chunk is zero-padded to a whole block and the file truncated afterwards.
+		auto start = [&](unsigned slot)
+		{
+			uint64_t begin = static_cast<uint64_t>(next) * chunkSize;
+			uint64_t end = begin + chunkSize < total ? begin + chunkSize : total;
+			TraceScope trace("fill", "io", "bytes", end - begin);
+			unsigned char* buffer = buffers[slot];
+			uint64_t p = begin;
+			if (p == 0)
+			{
+				// Chunks are at least a block, so the header and its padding always fit in the first.
+				memset(buffer, 0, static_cast<size_t>(h.dataOffset));
+				memcpy(buffer, &h, sizeof(h));
+				p = h.dataOffset;
+			}
+			memcpy(buffer + (p - begin), data + (p - h.dataOffset), static_cast<size_t>(end - p));
+			size_t length = static_cast<size_t>(s.direct ? AlignUp(end - begin) : end - begin);
+			memset(buffer + (end - begin), 0, length - static_cast<size_t>(end - begin));
+			slotLength[slot] = length;
+			next++;
+			return queue.Submit(slot, true, begin, length);
+		};
+		for (unsigned slot = 0; ok && slot < buffers.count && next < chunks; slot++)
+		{
+			ok = start(slot);
+		}
+
+		while (queue.InFlight() > 0)
+		{
+			unsigned slot;
+			long result;
+			if (!queue.Wait(slot, result))
+			{
+				ok = false;
+				break;
+			}
+			if (!ok)
+			{
+				continue;
+			}
+			if (result < 0 || static_cast<size_t>(result) != slotLength[slot])
+			{
+				ok = false;
+				continue;
+			}
+			s.chunks++;
+			s.bytes += slotLength[slot];
+			if (next < chunks)
+			{
+				ok = start(slot);
+			}
+		}
+	}
+	if (ok && s.direct && total % DIRECT_ALIGNMENT != 0)
+	{
+		ok = ftruncate(fd, static_cast<off_t>(total)) == 0;
+	}
+	ok = close(fd) == 0 && ok;
+	return ok;
+}
+
+#else
+
+template <typename V>
+static bool ReadBulk(const char*, const BulkChunkFunction<V>&, const BulkIOOptions&, BulkIOStats*)
+{
+	return false;
+}
+
+template <typename V>
+static bool WriteBulk(const char*, const V*, size_t, const BulkIOOptions&, BulkIOStats*)
+{
+	return false;
+}
+
+#endif
+
+bool ReadVectorFileBulk(const char* path, const BulkChunkFunction<Vector2D>& consume, const BulkIOOptions& options, BulkIOStats* stats)
+{
+	return ReadBulk(path, consume, options, stats);
+}
+
+bool ReadVectorFileBulk(const char* path, const BulkChunkFunction<Vector3D>& consume, const BulkIOOptions& options, BulkIOStats* stats)
+{
+	return ReadBulk(path, consume, options, stats);
+}
+
+bool ReadVectorFileBulk(const char* path, const BulkChunkFunction<Vector4D>& consume, const BulkIOOptions& options, BulkIOStats* stats)
+{
+	return ReadBulk(path, consume, options, stats);
+}
+
+bool WriteVectorFileBulk(const char* path, const Vector2D* v, size_t count, const BulkIOOptions& options, BulkIOStats* stats)
+{
+	return WriteBulk(path, v, count, options, stats);
+}
+
+bool WriteVectorFileBulk(const char* path, const Vector3D* v, size_t count, const BulkIOOptions& options, BulkIOStats* stats)
+{
+	return WriteBulk(path, v, count, options, stats);
+}
+
+bool WriteVectorFileBulk(const char* path, const Vector4D* v, size_t count, const BulkIOOptions& options, BulkIOStats* stats)
+{
+	return WriteBulk(path, v, count, options, stats);
+}
@@ -0,0 +1,1120 @@
+/*
+Title: Vector Mathematics
+File Name: CommandLine.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/CommandLine.h"
+
+#include <algorithm>
+#include <charconv>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../header/ArrowIPC.h"
+#include "../header/MappedFile.h"
+#include "../header/ThreadPool.h"
+#include "../header/Trace.h"
+#include "../header/VectorBatch.h"
+#include "../header/VectorFile.h"
+#include "../header/VectorParser.h"
+#include "../header/VectorService.h"
+#include "../header/VectorWriter.h"
+
+// Vectors per chunk handed to a thread. Large enough that handing out chunks costs nothing next to the math.
+static const size_t GRAIN = 1 << 16;
+// Vectors read, computed, and written at a time, so memory stays bounded whatever the input size.
+static const size_t CHUNK_VECTORS = GRAIN * 16;
+// Text read at a time for each thread parsing it.
+static const size_t TEXT_BYTES_PER_THREAD = 8 << 20;
+
+enum class OutputFormat
+{
+	// One "(x, y, z)" vector or one number per line.
+	Text,
+	// Little-endian float32 values with no header.
+	Raw,
+	// A .vecf file; see VectorFile.h.
+	VectorFile,
+	// An Arrow IPC file; see ArrowIPC.h.
+	Arrow,
+};
+
+struct Options
+{
+	const char* program;
+	const char* command;
+	const char* inputs[2];
+	int inputCount;
+	// Dimension of text input. Binary files record their own.
+	int dimension;
+	OutputFormat format;
+	const char* output;
+	unsigned threads;
+	// Significant digits for text output, or 0 for the shortest text that reads back exactly.
+	int precision;
+	std::vector<float> matrix;
+	std::vector<float> translation;
+	// For serve and service-stats.
+	const char* socketPath;
+	int windowMicroseconds;
+	int batchVectors;
+	// Chrome trace JSON of the run, or null for none.
+	const char* tracePath;
+};
+
+// Vectors read from a file or stdin a chunk at a time.
+// Text is read through in and parsed as whole lines arrive; binary files are mapped and their views handed out in order.
+struct VectorInput
+{
+	const char* name;
+	int dimension;
+	FILE* in;
+	// Read but not yet parsed, from the start of a line.
+	std::vector<char> text;
+	size_t textBytes;
+	bool textEnded;
+	// Lines parsed so far, to number the bad one.
+	size_t line;
+	unsigned threads;
+	VectorFile vectorFile;
+	ArrowVectorFile arrowFile;
+	const VectorArrayView* views;
+	size_t viewCount;
+	size_t view;
+	size_t position;
+	// Vectors in the views not yet handed out.
+	size_t viewVectors;
+	// Text vectors parsed but not yet handed out, AoS, from start on.
+	std::vector<float> pending;
+	size_t start;
+	// Nothing is left to read into pending.
+	bool ended;
+
+	VectorInput()
+		: name(nullptr), dimension(0), in(nullptr), textBytes(0), textEnded(false), line(0), threads(1),
+		views(nullptr), viewCount(0), view(0), position(0), viewVectors(0), start(0), ended(false)
+	{
+	}
+
+	~VectorInput()
+	{
+		if (in && in != stdin)
+		{
+			fclose(in);
+		}
+	}
+
+private:
+	VectorInput(const VectorInput&);
+	VectorInput& operator=(const VectorInput&);
+};
+
+static void PrintUsage(FILE* out, const char* program)
+{
+	fprintf(out,
+		"usage: %s <command> [options] [input [input2]]\n"
+		"\n"
+		"commands:\n"
+		"  normalize A    unit vectors in the direction of each vector\n"
+		"  dot A B        dot product of each pair, one number per line\n"
+		"  cross A B      cross product of each pair (3D only)\n"
+		"  project A B    projection of each vector of A onto the matching vector of B\n"
+		"  transform A    M * v + t for each vector, with --matrix and --translate\n"
+		"  stats A        count, bounds, mean and magnitude range\n"
+		"  serve          run as a service on a Unix socket until interrupted (Linux only)\n"
+		"  service-stats  print the statistics of a running service\n"
+		"\n"
+		"Inputs may be text (one vector per line), .vecf or Arrow files; the format is detected\n"
+		"from the contents. \"-\" reads text from stdin, as does a missing input to a\n"
+		"command taking one.\n"
+		"\n"
+		"options:\n"
+		"  --dim N              dimension of text input: 2, 3 or 4 (default 3)\n"
+		"  --format F           output format: text (default), raw, vecf or arrow\n"
+		"  --output PATH, -o    write to PATH instead of stdout (required for vecf and arrow)\n"
+		"  --threads N          threads to use (default: one per core)\n"
+		"  --precision N        significant digits in text output (default: shortest exact)\n"
+		"  --matrix a,b,...     row-major N x N matrix for transform\n"
+		"  --translate a,b,...  translation for transform (default: none)\n"
+		"  --socket PATH        socket for serve and service-stats\n"
+		"  --window-us N        how long serve holds requests to batch them (default 50)\n"
+		"  --batch N            vectors that make serve dispatch at once (default 262144)\n"
+		"  --trace PATH         write a Chrome trace of the run to PATH (open in ui.perfetto.dev)\n",
+		program);
+}
+
+static bool ParseInt(const char* text, int& value)
+{
+	const char* end = text + strlen(text);
+	std::from_chars_result r = std::from_chars(text, end, value);
+	return r.ec == std::errc() && r.ptr == end;
+}
+
+// Parses a comma separated list of numbers.
+static bool ParseFloats(const char* text, std::vector<float>& values)
+{
+	values.clear();
+	const char* end = text + strlen(text);
+	while (text < end)
+	{
+		float v;
+		std::from_chars_result r = std::from_chars(text, end, v);
+		if (r.ec != std::errc())
+		{
+			return false;
+		}
+		values.push_back(v);
+		text = r.ptr;
+		if (text < end && *text++ != ',')
+		{
+			return false;
+		}
+	}
+	return !values.empty();
+}
+
+// Fills options from argv. Returns false, having printed why, if the arguments are invalid.
+static bool ParseOptions(int argc, char* argv[], Options& options)
+{
+	options.program = argv[0];
+	options.command = argv[1];
+	options.inputs[0] = options.inputs[1] = nullptr;
+	options.inputCount = 0;
+	options.dimension = 3;
+	options.format = OutputFormat::Text;
+	options.output = nullptr;
+	options.threads = 0;
+	options.precision = 0;
+	options.socketPath = nullptr;
+	options.windowMicroseconds = 50;
+	options.batchVectors = 1 << 18;
+	options.tracePath = nullptr;
+
+	for (int i = 2; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		if (arg[0] != '-' || strcmp(arg, "-") == 0)
+		{
+			if (options.inputCount == 2)
+			{
+				fprintf(stderr, "%s: too many inputs\n", options.program);
+				return false;
+			}
+			options.inputs[options.inputCount++] = arg;
+			continue;
+		}
+		if (i + 1 == argc)
+		{
+			fprintf(stderr, "%s: %s needs a value\n", options.program, arg);
+			return false;
+		}
+		const char* value = argv[++i];
+		int n;
+		bool ok = true;
+		if (strcmp(arg, "--dim") == 0)
+		{
+			ok = ParseInt(value, options.dimension) && options.dimension >= 2 && options.dimension <= 4;
+		}
+		else if (strcmp(arg, "--format") == 0)
+		{
+			if (strcmp(value, "text") == 0)
+			{
+				options.format = OutputFormat::Text;
+			}
+			else if (strcmp(value, "raw") == 0)
+			{
+				options.format = OutputFormat::Raw;
+			}
+			else if (strcmp(value, "vecf") == 0)
+			{
+				options.format = OutputFormat::VectorFile;
+			}
+			else if (strcmp(value, "arrow") == 0)
+			{
+				options.format = OutputFormat::Arrow;
+			}
+			else
+			{
+				ok = false;
+			}
+		}
+		else if (strcmp(arg, "--output") == 0 || strcmp(arg, "-o") == 0)
+		{
+			options.output = value;
+		}
+		else if (strcmp(arg, "--threads") == 0)
+		{
+			ok = ParseInt(value, n) && n > 0;
+			options.threads = static_cast<unsigned>(n);
+		}
+		else if (strcmp(arg, "--precision") == 0)
+		{
+			ok = ParseInt(value, options.precision) && options.precision > 0 && options.precision <= 9;
+		}
+		else if (strcmp(arg, "--matrix") == 0)
+		{
+			ok = ParseFloats(value, options.matrix);
+		}
+		else if (strcmp(arg, "--translate") == 0)
+		{
+			ok = ParseFloats(value, options.translation);
+		}
+		else if (strcmp(arg, "--socket") == 0)
+		{
+			options.socketPath = value;
+		}
+		else if (strcmp(arg, "--window-us") == 0)
+		{
+			ok = ParseInt(value, options.windowMicroseconds) && options.windowMicroseconds >= 0;
+		}
+		else if (strcmp(arg, "--batch") == 0)
+		{
+			ok = ParseInt(value, options.batchVectors) && options.batchVectors > 0;
+		}
+		else if (strcmp(arg, "--trace") == 0)
+		{
+			options.tracePath = value;
+		}
+		else
+		{
+			fprintf(stderr, "%s: unknown option %s\n", options.program, arg);
+			return false;
+		}
+		if (!ok)
+		{
+			fprintf(stderr, "%s: invalid value for %s: %s\n", options.program, arg, value);
+			return false;
+		}
+	}
+
+	if ((options.format == OutputFormat::VectorFile || options.format == OutputFormat::Arrow) && !options.output)
+	{
+		fprintf(stderr, "%s: vecf and arrow output need --output\n", options.program);
+		return false;
+	}
+	return true;
+}
+
+// Calls f with a null pointer to the vector type of the given dimension, so generic code can name that type.
+template <typename F>
+static void WithVectorType(int dimension, F f)
+{
+	switch (dimension)
+	{
+	case 2:
+		f(static_cast<Vector2D*>(nullptr));
+		break;
+	case 3:
+		f(static_cast<Vector3D*>(nullptr));
+		break;
+	default:
+		f(static_cast<Vector4D*>(nullptr));
+		break;
+	}
+}
+
+// Builds a vector of type V from its components.
+template <typename V>
+static V FromComponents(const float* components)
+{
+	V v;
+	float* out = &v.x;
+	for (size_t c = 0; c < sizeof(V) / sizeof(float); c++)
+	{
+		out[c] = components[c];
+	}
+	return v;
+}
+
+//
+// Input
+//
+
+// Opens path, or stdin if path is null or "-". Returns false, having printed why, on failure.
+// Text is read a piece at a time from then on; binary files are mapped through their own readers, which need a path.
+static bool OpenInput(const char* path, const Options& options, ThreadPool& pool, VectorInput& input)
+{
+	bool fromStdin = !path || strcmp(path, "-") == 0;
+	input.name = fromStdin ? "stdin" : path;
+	input.in = fromStdin ? stdin : fopen(path, "rb");
+	if (!input.in)
+	{
+		fprintf(stderr, "%s: could not open %s\n", options.program, path);
+		return false;
+	}
+	input.textBytes = TEXT_BYTES_PER_THREAD * pool.Size();
+	input.threads = pool.Size();
+	// Enough to recognize a binary file.
+	input.text.resize(6);
+	input.text.resize(fread(input.text.data(), 1, input.text.size(), input.in));
+	input.textEnded = input.text.size() < 6;
+	if (ferror(input.in))
+	{
+		fprintf(stderr, "%s: could not read %s\n", options.program, input.name);
+		return false;
+	}
+
+	const char* text = input.text.data();
+	size_t size = input.text.size();
+	bool isVectorFile = size >= 4 && memcmp(text, "VECF", 4) == 0;
+	bool isArrowFile = size >= 6 && memcmp(text, "ARROW1", 6) == 0;
+	if (!isVectorFile && !isArrowFile)
+	{
+		input.dimension = options.dimension;
+		return true;
+	}
+	if (fromStdin)
+	{
+		fprintf(stderr, "%s: binary input must be given as a path, not on stdin\n", options.program);
+		return false;
+	}
+	fclose(input.in);
+	input.in = nullptr;
+	input.text.clear();
+	if (isVectorFile)
+	{
+		if (!input.vectorFile.Open(path) || input.vectorFile.view.dimension < 2)
+		{
+			fprintf(stderr, "%s: %s is not a valid vector file\n", options.program, input.name);
+			return false;
+		}
+		input.views = &input.vectorFile.view;
+		input.viewCount = 1;
+		input.viewVectors = input.vectorFile.view.count;
+		input.dimension = input.vectorFile.view.dimension;
+		input.ended = true;
+		return true;
+	}
+	if (!input.arrowFile.Open(path))
+	{
+		fprintf(stderr, "%s: %s is not an Arrow file of float vectors\n", options.program, input.name);
+		return false;
+	}
+	input.views = input.arrowFile.batches.data();
+	input.viewCount = input.arrowFile.batches.size();
+	for (size_t i = 0; i < input.viewCount; i++)
+	{
+		input.viewVectors += input.views[i].count;
+	}
+	input.dimension = input.arrowFile.dimension;
+	input.ended = true;
+	return true;
+}
+
+// Appends the next piece of text input to input.text.
+static bool ReadText(const Options& options, VectorInput& input)
+{
+	TraceScope trace("read", "io", "bytes", input.textBytes);
+	size_t have = input.text.size();
+	input.text.resize(have + input.textBytes);
+	size_t got = fread(input.text.data() + have, 1, input.textBytes, input.in);
+	input.text.resize(have + got);
+	if (got < input.textBytes)
+	{
+		input.textEnded = true;
+		if (ferror(input.in))
+		{
+			fprintf(stderr, "%s: could not read %s\n", options.program, input.name);
+			return false;
+		}
+	}
+	return true;
+}
+
+// Parses the whole lines read so far onto input.pending, or everything once the text has ended.
+static bool ParseText(const Options& options, VectorInput& input)
+{
+	size_t cut = input.text.size();
+	if (!input.textEnded)
+	{
+		// The partial last line waits for the rest of it.
+		while (cut > 0 && input.text[cut - 1] != '\n')
+		{
+			cut--;
+		}
+	}
+	// Drop the vectors already handed out once they are at least half of pending, so each is moved at most once
+	//  on average.
+	if (input.start > 0 && input.start * 2 >= input.pending.size())
+	{
+		input.pending.erase(input.pending.begin(), input.pending.begin() + input.start);
+		input.start = 0;
+	}
+	const char* text = input.text.data();
+	size_t capacity = CountVectorLines(text, cut);
+	size_t have = input.pending.size();
+	input.pending.resize(have + capacity * input.dimension);
+	ParseResult result = {};
+	WithVectorType(input.dimension, [&](auto type)
+	{
+		using V = typename std::remove_pointer<decltype(type)>::type;
+		result = ParseVectorsParallel(text, cut, reinterpret_cast<V*>(input.pending.data() + have), capacity, input.threads);
+	});
+	if (!result.ok)
+	{
+		fprintf(stderr, "%s: %s:%zu: expected a %dD vector\n", options.program, input.name, input.line + result.errorLine, input.dimension);
+		return false;
+	}
+	input.pending.resize(have + result.count * input.dimension);
+	input.line += std::count(text, text + cut, '\n');
+	input.text.erase(input.text.begin(), input.text.begin() + cut);
+	input.ended = input.textEnded;
+	return true;
+}
+
+// Copies the next count vectors from input's views to out, as one AoS array.
+static void ReadViews(VectorInput& input, size_t count, float* out)
+{
+	TraceScope trace("gather", "io", "vectors", count);
+	int d = input.dimension;
+	input.viewVectors -= count;
+	while (count > 0)
+	{
+		const VectorArrayView& view = input.views[input.view];
+		size_t n = view.count - input.position < count ? view.count - input.position : count;
+		if (view.stride == static_cast<size_t>(d))
+		{
+			memcpy(out, view.components[0] + input.position * d, n * d * sizeof(float));
+		}
+		else
+		{
+			for (size_t i = 0; i < n; i++)
+			{
+				for (int c = 0; c < d; c++)
+				{
+					out[i * d + c] = view.components[c][(input.position + i) * view.stride];
+				}
+			}
+		}
+		out += n * d;
+		count -= n;
+		input.position += n;
+		if (input.position == view.count)
+		{
+			input.view++;
+			input.position = 0;
+		}
+	}
+}
+
+// Vectors input can hand out without reading more.
+static size_t ReadyVectors(const VectorInput& input)
+{
+	return input.in ? (input.pending.size() - input.start) / input.dimension : input.viewVectors;
+}
+
+// Hands out the next count vectors of input as one AoS array, valid until the next call.
+// A run of an AoS view is handed out in place. Anything else is copied to chunk, since the next text is parsed
+//  onto pending while these are being processed.
+static const float* TakeVectors(VectorInput& input, size_t count, std::vector<float>& chunk)
+{
+	size_t n = count * input.dimension;
+	if (input.in)
+	{
+		const float* first = input.pending.data() + input.start;
+		chunk.assign(first, first + n);
+		input.start += n;
+		return chunk.data();
+	}
+	const VectorArrayView& view = input.views[input.view];
+	if (view.stride == static_cast<size_t>(input.dimension) && view.count - input.position >= count)
+	{
+		const float* first = view.components[0] + input.position * input.dimension;
+		input.viewVectors -= count;
+		input.position += count;
+		if (input.position == view.count)
+		{
+			input.view++;
+			input.position = 0;
+		}
+		return first;
+	}
+	chunk.resize(n);
+	ReadViews(input, count, chunk.data());
+	return chunk.data();
+}
+
+// Parses text until each text input has a whole chunk ready, or has ended. Mapped inputs are always ready.
+static bool FillInputs(const Options& options, VectorInput* inputs, int inputCount)
+{
+	for (int i = 0; i < inputCount; i++)
+	{
+		VectorInput& input = inputs[i];
+		while (!input.ended && ReadyVectors(input) < CHUNK_VECTORS)
+		{
+			if (!ParseText(options, input) || (!input.ended && ReadyVectors(input) < CHUNK_VECTORS && !ReadText(options, input)))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Calls process(chunks, count) with the next count vectors of each input, at most CHUNK_VECTORS at a time, until
+//  the inputs run out or process returns false. The next chunks are read while process works on these.
+template <typename F>
+static bool ForEachChunk(const Options& options, VectorInput* inputs, int inputCount, F process)
+{
+	std::vector<float> chunks[2];
+	const float* data[2] = {};
+	bool ok = FillInputs(options, inputs, inputCount);
+	while (ok)
+	{
+		size_t count = CHUNK_VECTORS;
+		for (int i = 0; i < inputCount; i++)
+		{
+			size_t ready = ReadyVectors(inputs[i]);
+			count = ready < count ? ready : count;
+		}
+		if (count == 0)
+		{
+			for (int i = 0; i < inputCount; i++)
+			{
+				if (ReadyVectors(inputs[i]) > 0)
+				{
+					fprintf(stderr, "%s: inputs differ: %s has more vectors than %s\n", options.program, inputs[i].name, inputs[1 - i].name);
+					return false;
+				}
+			}
+			return true;
+		}
+
+		for (int i = 0; i < inputCount; i++)
+		{
+			data[i] = TakeVectors(inputs[i], count, chunks[i]);
+		}
+		std::future<bool> next = std::async(std::launch::async, [&] { return FillInputs(options, inputs, inputCount); });
+		ok = process(data, count);
+		ok = next.get() && ok;
+	}
+	return false;
+}
+
+//
+// Output
+//
+
+static FILE* OpenOutput(const Options& options)
+{
+	FILE* out = options.output ? fopen(options.output, "wb") : stdout;
+	if (!out)
+	{
+		fprintf(stderr, "%s: could not create %s\n", options.program, options.output);
+	}
+	return out;
+}
+
+static bool CloseOutput(const Options& options, FILE* out, bool ok)
+{
+	ok = (fflush(out) == 0) && ok;
+	if (out != stdout)
+	{
+		ok = (fclose(out) == 0) && ok;
+	}
+	if (!ok)
+	{
+		fprintf(stderr, "%s: could not write %s\n", options.program, options.output ? options.output : "stdout");
+	}
+	return ok;
+}
+
+static void SetTextFormat(const Options& options, VectorWriter& writer)
+{
+	if (options.precision > 0)
+	{
+		writer.SetFormat(NumberFormat::General, options.precision);
+	}
+}
+
+// Streams the inputs through compute and writes its results a chunk at a time.
+// compute(in, out, begin, end) fills out with vectors [begin, end) of the results, dimension floats each,
+//  from the same vectors of each input. A dimension of 0 means one number per vector.
+// .vecf and Arrow files record their count up front, so vector results in those formats are kept and written at the end.
+template <typename F>
+static bool StreamCommand(const Options& options, ThreadPool& pool, VectorInput* inputs, int inputCount, int dimension, F compute)
+{
+	bool scalar = dimension == 0;
+	int width = scalar ? 1 : dimension;
+	bool keep = !scalar && (options.format == OutputFormat::VectorFile || options.format == OutputFormat::Arrow);
+	FILE* out = nullptr;
+	if (!keep && !(out = OpenOutput(options)))
+	{
+		return false;
+	}
+	// Formatting dominates, so the writes go to a background thread.
+	std::optional<VectorWriter> writer;
+	if (out && options.format != OutputFormat::Raw)
+	{
+		writer.emplace(out, 1 << 20, true);
+		SetTextFormat(options, *writer);
+	}
+
+	std::vector<float> results;
+	std::vector<float> kept;
+	bool wrote = true;
+	bool ok = ForEachChunk(options, inputs, inputCount, [&](const float* const* in, size_t count)
+	{
+		float* result;
+		if (keep)
+		{
+			kept.resize(kept.size() + count * width);
+			result = kept.data() + kept.size() - count * width;
+		}
+		else
+		{
+			results.resize(count * width);
+			result = results.data();
+		}
+		pool.ParallelFor(count, GRAIN, [&](size_t begin, size_t end) { compute(in, result, begin, end); });
+		if (keep)
+		{
+			return true;
+		}
+
+		TraceScope trace("write", "io", scalar ? "values" : "vectors", count);
+		if (!writer)
+		{
+			wrote = fwrite(result, sizeof(float), count * width, out) == count * width;
+			return wrote;
+		}
+		if (scalar)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				writer->WriteScalar(result[i]);
+			}
+		}
+		else
+		{
+			WithVectorType(dimension, [&](auto type)
+			{
+				using V = typename std::remove_pointer<decltype(type)>::type;
+				writer->Write(reinterpret_cast<const V*>(result), count);
+			});
+		}
+		return true;
+	});
+
+	if (!keep)
+	{
+		// Only a failed write is reported here; bad input has been reported already.
+		wrote = (!writer || writer->Flush()) && wrote;
+		writer.reset();
+		return CloseOutput(options, out, wrote) && ok;
+	}
+	if (!ok)
+	{
+		return false;
+	}
+	TraceScope trace("write", "io", "vectors", kept.size() / width);
+	WithVectorType(dimension, [&](auto type)
+	{
+		using V = typename std::remove_pointer<decltype(type)>::type;
+		const V* v = reinterpret_cast<const V*>(kept.data());
+		size_t count = kept.size() / width;
+		ok = options.format == OutputFormat::VectorFile ? WriteVectorFile(options.output, v, count) : WriteArrowFile(options.output, v, count);
+	});
+	if (!ok)
+	{
+		fprintf(stderr, "%s: could not write %s\n", options.program, options.output);
+	}
+	return ok;
+}
+
+//
+// Commands
+//
+
+// Checks that two inputs can be combined pairwise. Their counts are compared as they are read.
+static bool CheckPairs(const Options& options, const VectorInput* inputs)
+{
+	if (inputs[0].dimension != inputs[1].dimension)
+	{
+		fprintf(stderr, "%s: inputs differ: %dD vectors and %dD vectors\n", options.program, inputs[0].dimension, inputs[1].dimension);
+		return false;
+	}
+	return true;
+}
+
+static bool RunNormalize(const Options& options, ThreadPool& pool, VectorInput* inputs)
+{
+	bool ok = false;
+	WithVectorType(inputs[0].dimension, [&](auto type)
+	{
+		using V = typename std::remove_pointer<decltype(type)>::type;
+		ok = StreamCommand(options, pool, inputs, 1, inputs[0].dimension, [](const float* const* in, float* out, size_t begin, size_t end)
+		{
+			NormalizeBatch(reinterpret_cast<const V*>(in[0]) + begin, reinterpret_cast<V*>(out) + begin, end - begin);
+		});
+	});
+	return ok;
+}
+
+static bool RunDot(const Options& options, ThreadPool& pool, VectorInput* inputs)
+{
+	if (!CheckPairs(options, inputs))
+	{
+		return false;
+	}
+	bool ok = false;
+	WithVectorType(inputs[0].dimension, [&](auto type)
+	{
+		using V = typename std::remove_pointer<decltype(type)>::type;
+		ok = StreamCommand(options, pool, inputs, 2, 0, [](const float* const* in, float* out, size_t begin, size_t end)
+		{
+			DotBatch(reinterpret_cast<const V*>(in[0]) + begin, reinterpret_cast<const V*>(in[1]) + begin, out + begin, end - begin);
+		});
+	});
+	return ok;
+}
+
+static bool RunCross(const Options& options, ThreadPool& pool, VectorInput* inputs)
+{
+	if (!CheckPairs(options, inputs))
+	{
+		return false;
+	}
+	if (inputs[0].dimension != 3)
+	{
+		fprintf(stderr, "%s: cross needs 3D vectors\n", options.program);
+		return false;
+	}
+	return StreamCommand(options, pool, inputs, 2, 3, [](const float* const* in, float* out, size_t begin, size_t end)
+	{
+		CrossBatch(reinterpret_cast<const Vector3D*>(in[0]) + begin, reinterpret_cast<const Vector3D*>(in[1]) + begin, reinterpret_cast<Vector3D*>(out) + begin, end - begin);
+	});
+}
+
+static bool RunProject(const Options& options, ThreadPool& pool, VectorInput* inputs)
+{
+	if (!CheckPairs(options, inputs))
+	{
+		return false;
+	}
+	bool ok = false;
+	WithVectorType(inputs[0].dimension, [&](auto type)
+	{
+		using V = typename std::remove_pointer<decltype(type)>::type;
+		ok = StreamCommand(options, pool, inputs, 2, inputs[0].dimension, [](const float* const* in, float* out, size_t begin, size_t end)
+		{
+			ProjectBatch(reinterpret_cast<const V*>(in[0]) + begin, reinterpret_cast<const V*>(in[1]) + begin, reinterpret_cast<V*>(out) + begin, end - begin);
+		});
+	});
+	return ok;
+}
+
+static bool RunTransform(const Options& options, ThreadPool& pool, VectorInput* inputs)
+{
+	size_t d = static_cast<size_t>(inputs[0].dimension);
+	if (options.matrix.size() != d * d || (!options.translation.empty() && options.translation.size() != d))
+	{
+		fprintf(stderr, "%s: transform of %zuD vectors needs --matrix with %zu values and optionally --translate with %zu\n",
+			options.program, d, d * d, d);
+		return false;
+	}
+	bool ok = false;
+	WithVectorType(inputs[0].dimension, [&](auto type)
+	{
+		using V = typename std::remove_pointer<decltype(type)>::type;
+		const float zero[4] = {};
+		V t = FromComponents<V>(options.translation.empty() ? zero : options.translation.data());
+		const float* matrix = options.matrix.data();
+		ok = StreamCommand(options, pool, inputs, 1, inputs[0].dimension, [&](const float* const* in, float* out, size_t begin, size_t end)
+		{
+			TransformBatch(reinterpret_cast<const V*>(in[0]) + begin, reinterpret_cast<V*>(out) + begin, end - begin, matrix, t);
+		});
+	});
+	return ok;
+}
+
+// Per-chunk results for stats, combined once every chunk is done.
+struct StatsPartial
+{
+	float min[4];
+	float max[4];
+	double sum[4];
+	float minMagnitude;
+	float maxMagnitude;
+	double sumMagnitude;
+};
+
+static void MergeStats(StatsPartial& total, const StatsPartial& p, int d)
+{
+	for (int c = 0; c < d; c++)
+	{
+		total.min[c] = p.min[c] < total.min[c] ? p.min[c] : total.min[c];
+		total.max[c] = p.max[c] > total.max[c] ? p.max[c] : total.max[c];
+		total.sum[c] += p.sum[c];
+	}
+	total.minMagnitude = p.minMagnitude < total.minMagnitude ? p.minMagnitude : total.minMagnitude;
+	total.maxMagnitude = p.maxMagnitude > total.maxMagnitude ? p.maxMagnitude : total.maxMagnitude;
+	total.sumMagnitude += p.sumMagnitude;
+}
+
+static bool RunStats(const Options& options, ThreadPool& pool, VectorInput* inputs)
+{
+	if (options.format != OutputFormat::Text)
+	{
+		fprintf(stderr, "%s: stats only writes text\n", options.program);
+		return false;
+	}
+	int d = inputs[0].dimension;
+	size_t total = 0;
+	StatsPartial totals = {};
+	std::vector<StatsPartial> partials;
+	bool ok = ForEachChunk(options, inputs, 1, [&](const float* const* in, size_t count)
+	{
+		const float* data = in[0];
+		partials.resize((count + GRAIN - 1) / GRAIN);
+		pool.ParallelFor(count, GRAIN, [&](size_t begin, size_t end)
+		{
+			StatsPartial& p = partials[begin / GRAIN];
+			const float* v = data + begin * d;
+			for (int c = 0; c < d; c++)
+			{
+				p.min[c] = p.max[c] = v[c];
+				p.sum[c] = 0.0;
+			}
+			p.minMagnitude = p.maxMagnitude = -1.0f;
+			p.sumMagnitude = 0.0;
+
+			float magnitudes[256];
+			for (size_t block = begin; block < end; block += 256)
+			{
+				size_t n = end - block < 256 ? end - block : 256;
+				WithVectorType(d, [&](auto type)
+				{
+					using V = typename std::remove_pointer<decltype(type)>::type;
+					MagnitudeBatch(reinterpret_cast<const V*>(data) + block, magnitudes, n);
+				});
+				for (size_t i = 0; i < n; i++)
+				{
+					const float* x = data + (block + i) * d;
+					for (int c = 0; c < d; c++)
+					{
+						p.min[c] = x[c] < p.min[c] ? x[c] : p.min[c];
+						p.max[c] = x[c] > p.max[c] ? x[c] : p.max[c];
+						p.sum[c] += x[c];
+					}
+					float m = magnitudes[i];
+					p.minMagnitude = p.minMagnitude < 0.0f || m < p.minMagnitude ? m : p.minMagnitude;
+					p.maxMagnitude = m > p.maxMagnitude ? m : p.maxMagnitude;
+					p.sumMagnitude += m;
+				}
+			}
+		});
+		for (size_t k = 0; k < partials.size(); k++)
+		{
+			if (total == 0 && k == 0)
+			{
+				totals = partials[0];
+			}
+			else
+			{
+				MergeStats(totals, partials[k], d);
+			}
+		}
+		total += count;
+		return true;
+	});
+	if (!ok)
+	{
+		return false;
+	}
+
+	FILE* out = OpenOutput(options);
+	if (!out)
+	{
+		return false;
+	}
+	VectorWriter writer(out);
+	SetTextFormat(options, writer);
+	std::string count = "count " + std::to_string(total) + "\n";
+	writer.WriteText(count.c_str());
+	if (total > 0)
+	{
+		float mean[4];
+		for (int c = 0; c < d; c++)
+		{
+			mean[c] = static_cast<float>(totals.sum[c] / total);
+		}
+
+		WithVectorType(d, [&](auto type)
+		{
+			using V = typename std::remove_pointer<decltype(type)>::type;
+			writer.WriteText("min ");
+			writer.Write(FromComponents<V>(totals.min));
+			writer.WriteText("max ");
+			writer.Write(FromComponents<V>(totals.max));
+			writer.WriteText("mean ");
+			writer.Write(FromComponents<V>(mean));
+		});
+		writer.WriteText("min magnitude ");
+		writer.WriteScalar(totals.minMagnitude);
+		writer.WriteText("max magnitude ");
+		writer.WriteScalar(totals.maxMagnitude);
+		writer.WriteText("mean magnitude ");
+		writer.WriteScalar(static_cast<float>(totals.sumMagnitude / total));
+	}
+	ok = writer.Flush();
+	return CloseOutput(options, out, ok);
+}
+
+static std::atomic<bool> stopRequested(false);
+
+static void RequestStop(int)
+{
+	stopRequested.store(true);
+}
+
+static bool RunServe(const Options& options, ThreadPool& pool, VectorInput*)
+{
+	if (!options.socketPath)
+	{
+		fprintf(stderr, "%s: serve needs --socket\n", options.program);
+		return false;
+	}
+	VectorServiceOptions service;
+	service.socketPath = options.socketPath;
+	service.windowMicroseconds = static_cast<unsigned>(options.windowMicroseconds);
+	service.batchVectors = static_cast<size_t>(options.batchVectors);
+
+	// Stopping cleanly removes the socket file and prints the final statistics.
+	std::signal(SIGINT, RequestStop);
+	std::signal(SIGTERM, RequestStop);
+	ServiceStats stats;
+	if (!RunVectorService(service, pool, stopRequested, stats))
+	{
+		return false;
+	}
+	PrintServiceStats(stderr, stats);
+	return true;
+}
+
+static bool RunServiceStats(const Options& options, ThreadPool&, VectorInput*)
+{
+	VectorServiceClient client;
+	ServiceStats stats;
+	if (!options.socketPath || !client.Connect(options.socketPath, 4096) || !client.QueryStats(stats))
+	{
+		fprintf(stderr, "%s: could not reach a service at %s\n", options.program, options.socketPath ? options.socketPath : "(no --socket given)");
+		return false;
+	}
+	PrintServiceStats(stdout, stats);
+	return true;
+}
+
+static bool WriteTrace(const Options& options)
+{
+	StopTrace();
+	FILE* out = fopen(options.tracePath, "wb");
+	bool ok = out != nullptr && WriteChromeTrace(out);
+	ok = out != nullptr && fclose(out) == 0 && ok;
+	if (!ok)
+	{
+		fprintf(stderr, "%s: could not write %s\n", options.program, options.tracePath);
+	}
+	return ok;
+}
+
+struct Command
+{
+	const char* name;
+	int inputs;
+	bool (*run)(const Options& options, ThreadPool& pool, VectorInput* inputs);
+};
+
+static const Command COMMANDS[] =
+{
+	{ "normalize", 1, RunNormalize },
+	{ "dot", 2, RunDot },
+	{ "cross", 2, RunCross },
+	{ "project", 2, RunProject },
+	{ "transform", 1, RunTransform },
+	{ "stats", 1, RunStats },
+	{ "serve", 0, RunServe },
+	{ "service-stats", 0, RunServiceStats },
+};
+
+int RunCommandLine(int argc, char* argv[])
+{
+	if (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "help") == 0)
+	{
+		PrintUsage(stdout, argv[0]);
+		return 0;
+	}
+
+	const Command* command = nullptr;
+	for (const Command& c : COMMANDS)
+	{
+		if (strcmp(argv[1], c.name) == 0)
+		{
+			command = &c;
+		}
+	}
+	if (!command)
+	{
+		fprintf(stderr, "%s: unknown command %s\n\n", argv[0], argv[1]);
+		PrintUsage(stderr, argv[0]);
+		return 2;
+	}
+
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		return 2;
+	}
+	// A lone input defaults to stdin. Commands taking two must name both, and only one can be stdin.
+	bool bothStdin = options.inputCount == 2 && strcmp(options.inputs[0], "-") == 0 && strcmp(options.inputs[1], "-") == 0;
+	if (options.inputCount > command->inputs || (command->inputs == 2 && options.inputCount != 2) || bothStdin)
+	{
+		const char* expected = command->inputs == 0 ? "no inputs" : command->inputs == 1 ? "one input" : "two inputs, at most one of them \"-\"";
+		fprintf(stderr, "%s: %s takes %s\n", options.program, command->name, expected);
+		return 2;
+	}
+
+	if (options.tracePath)
+	{
+		SetTraceThreadName("main");
+		StartTrace();
+	}
+	ThreadPool pool(options.threads);
+	VectorInput inputs[2];
+	bool ok = true;
+	for (int i = 0; ok && i < command->inputs; i++)
+	{
+		ok = OpenInput(i < options.inputCount ? options.inputs[i] : nullptr, options, pool, inputs[i]);
+	}
+	if (ok)
+	{
+		TraceScope trace(command->name, "command");
+		ok = command->run(options, pool, inputs);
+	}
+	if (options.tracePath && !WriteTrace(options))
+	{
+		ok = false;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+/*
+Title: Vector Mathematics
+File Name: DVector2D.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/DVector2D.h"
+
+DVector2D::DVector2D()
+	: x(0), y(0)
+{
+}
+
+DVector2D::DVector2D(double x, double y)
+	: x(x), y(y)
+{
+}
+
+DVector2D operator-(DVector2D v)
+{
+	return DVector2D(-v.x, -v.y);
+}
+
+DVector2D operator+(DVector2D l, DVector2D r)
+{
+	return DVector2D(l.x + r.x, l.y + r.y);
+}
+
+DVector2D operator-(DVector2D l, DVector2D r)
+{
+	return l + (-r);
+}
+
+DVector2D operator*(double s, DVector2D v)
+{
+	return DVector2D(s * v.x, s * v.y);
+}
+
+DVector2D operator*(DVector2D v, double s)
+{
+	return s * v;
+}
+
+DVector2D operator/(DVector2D v, double s)
+{
+	return (1.0/s) * v;
+}
+
+bool operator==(DVector2D l, DVector2D r)
+{
+	return ((l.x == r.x) && (l.y == r.y));
+}
+
+bool operator!=(DVector2D l, DVector2D r)
+{
+	return !(l == r);
+}
+
+double Dot(DVector2D l, DVector2D r)
+{
+	return l.x * r.x + l.y * r.y;
+}
+
+DVector2D Project(DVector2D a, DVector2D b)
+{
+	return  (Dot(a, b) / Dot(b, b)) * b;
+}
+
+DVector2D Reject(DVector2D a, DVector2D b)
+{
+	return a - Project(a, b);
+}
+
+double Magnitude(DVector2D v)
+{
+	return sqrt(Dot(v, v));
+}
+
+double MagInverse(DVector2D v)
+{
+	return 1.0 / Magnitude(v);
+}
+
+double MagSquared(DVector2D v)
+{
+	return Dot(v, v);
+}
+
+DVector2D ToDouble(Vector2D v)
+{
+	return DVector2D(v.x, v.y);
+}
+
+Vector2D ToFloat(DVector2D v)
+{
+	return Vector2D(static_cast<float>(v.x), static_cast<float>(v.y));
+}
+
+std::ostream& operator<<(std::ostream& os, DVector2D v)
+{
+	os << "(" << v.x << ", " << v.y << ")";
+	return os;
+}
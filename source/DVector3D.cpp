@@ -0,0 +1,129 @@
+/*
+Title: Vector Mathematics
+File Name: DVector3D.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/DVector3D.h"
+
+DVector3D::DVector3D()
+	: x(0), y(0), z(0)
+{
+}
+
+DVector3D::DVector3D(double x, double y, double z)
+	: x(x), y(y), z(z)
+{
+}
+
+DVector3D operator-(DVector3D v)
+{
+	return DVector3D(-v.x, -v.y, -v.z);
+}
+
+DVector3D operator+(DVector3D l, DVector3D r)
+{
+	return DVector3D(l.x + r.x, l.y + r.y, l.z + r.z);
+}
+
+DVector3D operator-(DVector3D l, DVector3D r)
+{
+	return l + (-r);
+}
+
+DVector3D operator*(double s, DVector3D v)
+{
+	return DVector3D(s * v.x, s * v.y, s * v.z);
+}
+
+DVector3D operator*(DVector3D v, double s)
+{
+	return s * v;
+}
+
+DVector3D operator/(DVector3D v, double s)
+{
+	return (1.0/s) * v;
+}
+
+bool operator==(DVector3D l, DVector3D r)
+{
+	return ((l.x == r.x) && (l.y == r.y) && (l.z == r.z));
+}
+
+bool operator!=(DVector3D l, DVector3D r)
+{
+	return !(l == r);
+}
+
+double Dot(DVector3D l, DVector3D r)
+{
+	return l.x * r.x + l.y * r.y + l.z * r.z;
+}
+
+DVector3D Project(DVector3D a, DVector3D b)
+{
+	return (Dot(a, b) / Dot(b, b)) * b;
+}
+
+DVector3D Reject(DVector3D a, DVector3D b)
+{
+	return a - Project(a, b);
+}
+
+DVector3D Cross(DVector3D a, DVector3D b)
+{
+	return DVector3D(a.y * b.z - a.z * b.y,
+					a.z * b.x - a.x * b.z,
+					a.x * b.y - a.y * b.x);
+}
+
+double Magnitude(DVector3D v)
+{
+	return sqrt(Dot(v, v));
+}
+
+double MagInverse(DVector3D v)
+{
+	return 1.0 / Magnitude(v);
+}
+
+double MagSquared(DVector3D v)
+{
+	return Dot(v, v);
+}
+
+double ScalarTriple(DVector3D a, DVector3D b, DVector3D c)
+{
+	return Dot(Cross(a, b), c);
+}
+
+DVector3D ToDouble(Vector3D v)
+{
+	return DVector3D(v.x, v.y, v.z);
+}
+
+Vector3D ToFloat(DVector3D v)
+{
+	return Vector3D(static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z));
+}
+
+std::ostream& operator<<(std::ostream& os, DVector3D v)
+{
+	os << "(" << v.x << ", " << v.y << ", " << v.z << ")";
+	return os;
+}
@@ -0,0 +1,117 @@
+/*
+Title: Vector Mathematics
+File Name: DVector4D.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/DVector4D.h"
+
+DVector4D::DVector4D()
+	: x(0), y(0), z(0), w(0)
+{
+}
+
+DVector4D::DVector4D(double x, double y, double z, double w)
+	: x(x), y(y), z(z), w(w)
+{
+}
+
+DVector4D operator-(DVector4D v)
+{
+	return DVector4D(-v.x, -v.y, -v.z, -v.w);
+}
+
+DVector4D operator+(DVector4D l, DVector4D r)
+{
+	return DVector4D(l.x + r.x, l.y + r.y, l.z + r.z, l.w + r.w);
+}
+
+DVector4D operator-(DVector4D l, DVector4D r)
+{
+	return l + (-r);
+}
+
+DVector4D operator*(double s, DVector4D v)
+{
+	return DVector4D(s * v.x, s * v.y, s * v.z, s * v.w);
+}
+
+DVector4D operator*(DVector4D v, double s)
+{
+	return s * v;
+}
+
+DVector4D operator/(DVector4D v, double s)
+{
+	return (1.0/s) * v;
+}
+
+bool operator==(DVector4D l, DVector4D r)
+{
+	return ((l.x == r.x) && (l.y == r.y) && (l.z == r.z) && (l.w == r.w));
+}
+
+bool operator!=(DVector4D l, DVector4D r)
+{
+	return !(l == r);
+}
+
+double Dot(DVector4D l, DVector4D r)
+{
+	return l.x * r.x + l.y * r.y + l.z * r.z + l.w * r.w;
+}
+
+DVector4D Project(DVector4D a, DVector4D b)
+{
+	return (Dot(a, b) / Dot(b, b)) * b;
+}
+
+DVector4D Reject(DVector4D a, DVector4D b)
+{
+	return a - Project(a, b);
+}
+
+double Magnitude(DVector4D v)
+{
+	return sqrt(Dot(v, v));
+}
+
+double MagInverse(DVector4D v)
+{
+	return 1.0 / Magnitude(v);
+}
+
+double MagSquared(DVector4D v)
+{
+	return Dot(v, v);
+}
+
+DVector4D ToDouble(Vector4D v)
+{
+	return DVector4D(v.x, v.y, v.z, v.w);
+}
+
+Vector4D ToFloat(DVector4D v)
+{
+	return Vector4D(static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z), static_cast<float>(v.w));
+}
+
+std::ostream & operator<<(std::ostream& os, DVector4D v)
+{
+	os << "(" << v.x << ", " << v.y << ", " << v.z << ", " << v.w << ")";
+	return os;
+}
@@ -0,0 +1,259 @@
+/*
+Title: Vector Mathematics
+File Name: Fixed.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/Fixed.h"
+
+#include <math.h>
+
+Fixed ToFixed(float f)
+{
+	// Every comparison with NaN is false, so it would reach the cast, which is undefined for it.
+	if (isnan(f))
+	{
+		Fixed zero = { 0 };
+		return zero;
+	}
+	double scaled = floor(static_cast<double>(f) * 65536.0 + 0.5);
+	scaled = scaled > 2147483647.0 ? 2147483647.0 : (scaled < -2147483648.0 ? -2147483648.0 : scaled);
+	Fixed r = { static_cast<int32_t>(scaled) };
+	return r;
+}
+
+float ToFloat(Fixed f)
+{
+	return static_cast<float>(f.raw / 65536.0);
+}
+
+Fixed64 ToFixed64(double d)
+{
+	if (isnan(d))
+	{
+		Fixed64 zero = { 0 };
+		return zero;
+	}
+	double scaled = floor(d * 4294967296.0 + 0.5);
+	Fixed64 r;
+	if (scaled >= 9223372036854775807.0)
+	{
+		r.raw = INT64_MAX;
+	}
+	else if (scaled <= -9223372036854775808.0)
+	{
+		r.raw = INT64_MIN;
+	}
+	else
+	{
+		r.raw = static_cast<int64_t>(scaled);
+	}
+	return r;
+}
+
+double ToDouble(Fixed64 f)
+{
+	return f.raw / 4294967296.0;
+}
+
+Fixed operator/(Fixed l, Fixed r)
+{
+	if (r.raw == 0)
+	{
+		Fixed f = { l.raw >= 0 ? INT32_MAX : INT32_MIN };
+		return f;
+	}
+	int64_t n = static_cast<int64_t>(l.raw) * 65536;
+	int64_t q = n / r.raw;
+	// Integer division truncates toward zero; step down for negative inexact quotients.
+	if ((n % r.raw != 0) && ((n < 0) != (r.raw < 0)))
+	{
+		q--;
+	}
+	q = q > INT32_MAX ? INT32_MAX : (q < INT32_MIN ? INT32_MIN : q);
+	Fixed f = { static_cast<int32_t>(q) };
+	return f;
+}
+
+Fixed64 operator/(Fixed64 l, Fixed64 r)
+{
+	if (r.raw == 0)
+	{
+		Fixed64 f = { l.raw >= 0 ? INT64_MAX : INT64_MIN };
+		return f;
+	}
+
+	bool negative = (l.raw < 0) != (r.raw < 0);
+	uint64_t a = l.raw < 0 ? 0 - static_cast<uint64_t>(l.raw) : static_cast<uint64_t>(l.raw);
+	uint64_t d = r.raw < 0 ? 0 - static_cast<uint64_t>(r.raw) : static_cast<uint64_t>(r.raw);
+	uint64_t quotient = 0, remainder = 0;
+	bool overflow = false;
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 numerator = static_cast<unsigned __int128>(a) << 32;
+	unsigned __int128 wideQuotient = numerator / d;
+	overflow = (wideQuotient >> 64) != 0;
+	quotient = static_cast<uint64_t>(wideQuotient);
+	remainder = static_cast<uint64_t>(numerator % d);
+#else
+	// Long division of the 96-bit |l| << 32 by |r|, one bit at a time.
+	uint64_t numHi = a >> 32, numLo = a << 32;
+	for (int bit = 127; bit >= 0; bit--)
+	{
+		uint64_t next = bit >= 64 ? (numHi >> (bit - 64)) & 1 : (numLo >> bit) & 1;
+		bool carry = (remainder >> 63) != 0;
+		remainder = (remainder << 1) | next;
+		if (carry || remainder >= d)
+		{
+			remainder -= d;
+			if (bit >= 64)
+			{
+				overflow = true;
+			}
+			else
+			{
+				quotient |= 1ULL << bit;
+			}
+		}
+	}
+#endif
+
+	Fixed64 f;
+	if (overflow || quotient > static_cast<uint64_t>(INT64_MAX))
+	{
+		f.raw = negative ? INT64_MIN : INT64_MAX;
+	}
+	else if (negative)
+	{
+		// Round toward negative infinity, as everywhere else.
+		f.raw = -static_cast<int64_t>(quotient) - (remainder != 0 ? 1 : 0);
+	}
+	else
+	{
+		f.raw = static_cast<int64_t>(quotient);
+	}
+	return f;
+}
+
+// The square roots below start from the floating-point sqrt and then correct it with exact integer
+//  checks. IEEE 754 requires sqrt to be correctly rounded, and the correction makes the result the
+//  one exact answer whatever the estimate was, so this is as deterministic as a bit-by-bit integer
+//  square root, and many times faster.
+uint32_t IntSqrt(uint64_t n)
+{
+	uint64_t r = static_cast<uint64_t>(sqrt(static_cast<double>(n)));
+	if (r > 0xffffffff)
+	{
+		r = 0xffffffff;
+	}
+	while (r * r > n)
+	{
+		r--;
+	}
+	while (r < 0xffffffff && (r + 1) * (r + 1) <= n)
+	{
+		r++;
+	}
+	return static_cast<uint32_t>(r);
+}
+
+Fixed SqrtWide(int64_t w)
+{
+	return SqrtWide(w > 0 ? static_cast<uint64_t>(w) : 0);
+}
+
+Fixed SqrtWide(uint64_t w)
+{
+	// sqrt(w / 2^32) * 2^16 = sqrt(w)
+	uint32_t r = IntSqrt(w);
+	Fixed f = { r > static_cast<uint32_t>(INT32_MAX) ? INT32_MAX : static_cast<int32_t>(r) };
+	return f;
+}
+
+Fixed64 SqrtWide(Int128 w)
+{
+	// sqrt(w / 2^64) * 2^32 = sqrt(w)
+	if (w.hi < 0 || (w.hi == 0 && w.lo == 0))
+	{
+		Fixed64 zero = { 0 };
+		return zero;
+	}
+	uint64_t nHi = static_cast<uint64_t>(w.hi), nLo = w.lo;
+
+#ifdef __SIZEOF_INT128__
+	// A double only holds 53 of the result's 64 bits, so one Newton step refines the estimate
+	//  before the exact correction.
+	unsigned __int128 n = (static_cast<unsigned __int128>(nHi) << 64) | nLo;
+	unsigned __int128 root = static_cast<unsigned __int128>(sqrt(static_cast<double>(n)));
+	root = root == 0 ? 1 : root;
+	root = (root + n / root) / 2;
+	const unsigned __int128 maxRoot = ~static_cast<uint64_t>(0);
+	root = root > maxRoot ? maxRoot : root;
+	while (root * root > n)
+	{
+		root--;
+	}
+	while (root < maxRoot && (root + 1) * (root + 1) <= n)
+	{
+		root++;
+	}
+	uint64_t rLo = static_cast<uint64_t>(root);
+#else
+	// Without a 128-bit type, fall back to the digit-by-digit method, two bits of w per result bit.
+	uint64_t rHi = 0, rLo = 0;
+	uint64_t bHi = 1ULL << 62, bLo = 0;
+
+	// Helpers on (hi, lo) pairs.
+	struct U128
+	{
+		static bool Less(uint64_t aHi, uint64_t aLo, uint64_t bHi, uint64_t bLo) { return aHi < bHi || (aHi == bHi && aLo < bLo); }
+		static void Add(uint64_t& aHi, uint64_t& aLo, uint64_t bHi, uint64_t bLo) { aLo += bLo; aHi += bHi + (aLo < bLo ? 1 : 0); }
+		static void Sub(uint64_t& aHi, uint64_t& aLo, uint64_t bHi, uint64_t bLo) { uint64_t borrow = aLo < bLo ? 1 : 0; aLo -= bLo; aHi -= bHi + borrow; }
+		static void Shr(uint64_t& hi, uint64_t& lo, int s) { lo = (lo >> s) | (hi << (64 - s)); hi >>= s; }
+	};
+
+	while (U128::Less(nHi, nLo, bHi, bLo))
+	{
+		U128::Shr(bHi, bLo, 2);
+	}
+	while (bHi != 0 || bLo != 0)
+	{
+		uint64_t tHi = rHi, tLo = rLo;
+		U128::Add(tHi, tLo, bHi, bLo);
+		U128::Shr(rHi, rLo, 1);
+		if (!U128::Less(nHi, nLo, tHi, tLo))
+		{
+			U128::Sub(nHi, nLo, tHi, tLo);
+			U128::Add(rHi, rLo, bHi, bLo);
+		}
+		U128::Shr(bHi, bLo, 2);
+	}
+#endif
+
+	Fixed64 f = { rLo > static_cast<uint64_t>(INT64_MAX) ? INT64_MAX : static_cast<int64_t>(rLo) };
+	return f;
+}
+
+Fixed Sqrt(Fixed f)
+{
+	return SqrtWide(static_cast<int64_t>(f.raw) * 65536);
+}
+
+Fixed64 Sqrt(Fixed64 f)
+{
+	Int128 w = { static_cast<uint64_t>(f.raw) << 32, f.raw >> 32 };
+	return SqrtWide(w);
+}
@@ -0,0 +1,192 @@
+/*
+Title: Vector Mathematics
+File Name: FixedVector.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/FixedVector.h"
+
+FixedVector2D ToFixed(Vector2D v)
+{
+	return FixedVector2D(ToFixed(v.x), ToFixed(v.y));
+}
+
+FixedVector3D ToFixed(Vector3D v)
+{
+	return FixedVector3D(ToFixed(v.x), ToFixed(v.y), ToFixed(v.z));
+}
+
+Vector2D ToFloat(FixedVector2D v)
+{
+	return Vector2D(ToFloat(v.x), ToFloat(v.y));
+}
+
+Vector3D ToFloat(FixedVector3D v)
+{
+	return Vector3D(ToFloat(v.x), ToFloat(v.y), ToFloat(v.z));
+}
+
+Fixed64Vector2D ToFixed64(DVector2D v)
+{
+	return Fixed64Vector2D(ToFixed64(v.x), ToFixed64(v.y));
+}
+
+Fixed64Vector3D ToFixed64(DVector3D v)
+{
+	return Fixed64Vector3D(ToFixed64(v.x), ToFixed64(v.y), ToFixed64(v.z));
+}
+
+DVector2D ToDouble(Fixed64Vector2D v)
+{
+	return DVector2D(ToDouble(v.x), ToDouble(v.y));
+}
+
+DVector3D ToDouble(Fixed64Vector3D v)
+{
+	return DVector3D(ToDouble(v.x), ToDouble(v.y), ToDouble(v.z));
+}
+
+// The Q16.16 dot and cross loops are only integer multiplies, adds and shifts, but SSE2 has no
+//  signed 32 x 32 -> 64-bit multiply, so at the default flags they stay scalar. Where the compiler
+//  lets single functions target AVX2, the loops are compiled again for it and picked at run time,
+//  like the F16C conversions in Half.cpp.
+// Magnitude and Project are dominated by the integer square root and division.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FIXED_AVX2_DISPATCH 1
+
+__attribute__((target("avx2")))
+static void DotAVX2(const FixedVector3D* a, const FixedVector3D* b, Fixed* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = Dot(a[i], b[i]);
+	}
+}
+
+__attribute__((target("avx2")))
+static void CrossAVX2(const FixedVector3D* a, const FixedVector3D* b, FixedVector3D* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = Cross(a[i], b[i]);
+	}
+}
+
+static bool HasAVX2()
+{
+	static const bool available = __builtin_cpu_supports("avx2");
+	return available;
+}
+#endif
+
+void DotBatch(const FixedVector3D* a, const FixedVector3D* b, Fixed* out, size_t count)
+{
+#ifdef FIXED_AVX2_DISPATCH
+	if (HasAVX2())
+	{
+		DotAVX2(a, b, out, count);
+		return;
+	}
+#endif
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = Dot(a[i], b[i]);
+	}
+}
+
+void CrossBatch(const FixedVector3D* a, const FixedVector3D* b, FixedVector3D* out, size_t count)
+{
+#ifdef FIXED_AVX2_DISPATCH
+	if (HasAVX2())
+	{
+		CrossAVX2(a, b, out, count);
+		return;
+	}
+#endif
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = Cross(a[i], b[i]);
+	}
+}
+
+void MagnitudeBatch(const FixedVector3D* in, Fixed* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = Magnitude(in[i]);
+	}
+}
+
+void ProjectBatch(const FixedVector3D* a, const FixedVector3D* b, FixedVector3D* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = Project(a[i], b[i]);
+	}
+}
+
+void DotBatch(const Fixed64Vector3D* a, const Fixed64Vector3D* b, Fixed64* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = Dot(a[i], b[i]);
+	}
+}
+
+void CrossBatch(const Fixed64Vector3D* a, const Fixed64Vector3D* b, Fixed64Vector3D* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = Cross(a[i], b[i]);
+	}
+}
+
+void MagnitudeBatch(const Fixed64Vector3D* in, Fixed64* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = Magnitude(in[i]);
+	}
+}
+
+void ProjectBatch(const Fixed64Vector3D* a, const Fixed64Vector3D* b, Fixed64Vector3D* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = Project(a[i], b[i]);
+	}
+}
+
+std::ostream& operator<<(std::ostream& os, FixedVector2D v)
+{
+	return os << ToFloat(v);
+}
+
+std::ostream& operator<<(std::ostream& os, FixedVector3D v)
+{
+	return os << ToFloat(v);
+}
+
+std::ostream& operator<<(std::ostream& os, Fixed64Vector2D v)
+{
+	return os << ToDouble(v);
+}
+
+std::ostream& operator<<(std::ostream& os, Fixed64Vector3D v)
+{
+	return os << ToDouble(v);
+}
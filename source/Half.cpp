@@ -0,0 +1,208 @@
+/*
+Title: Vector Mathematics
+File Name: Half.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/Half.h"
+
+#include <cstring>
+
+// F16C is only used where the compiler lets us enable it for single functions, so the rest
+//  of the program still runs on CPUs without it.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define HALF_F16C_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+// The conversions compute every case and pick one with masks rather than branches, and are inline
+//  here, so the batch loops below vectorize on CPUs without F16C and for the tail F16C leaves.
+// A ?: select would let the compiler move the float arithmetic back under a branch, since it may
+//  raise floating-point exceptions, and the loops would not vectorize.
+
+static inline uint32_t FloatBits(float f)
+{
+	uint32_t bits;
+	memcpy(&bits, &f, 4);
+	return bits;
+}
+
+static inline float BitsFloat(uint32_t bits)
+{
+	float f;
+	memcpy(&f, &bits, 4);
+	return f;
+}
+
+static inline uint16_t ToHalf(float f)
+{
+	uint32_t bits = FloatBits(f);
+	uint32_t sign = (bits >> 16) & 0x8000;
+	uint32_t magnitude = bits & 0x7fffffff;
+
+	// Normal: rebias the exponent from float's 127 to half's 15 and keep the top 10 mantissa bits,
+	//  adding just under half a unit, plus the lowest kept bit, to round to nearest even.
+	// A carry out of the mantissa correctly bumps the exponent, up to infinity.
+	uint32_t normal = (magnitude - ((127 - 15) << 23) + 0xfff + ((magnitude >> 13) & 1)) >> 13;
+
+	// Denormal or zero: adding 0.5 lines the half denormal's bits up with the bottom of the float
+	//  mantissa, and the float addition itself rounds to nearest even.
+	uint32_t denormal = FloatBits(BitsFloat(magnitude) + 0.5f) - FloatBits(0.5f);
+
+	// Too large becomes infinity. NaNs keep a mantissa bit set so they stay NaN.
+	uint32_t nan = 0u - static_cast<uint32_t>(magnitude > 0x7f800000);
+	uint32_t special = 0x7c00 | (nan & (0x200 | ((magnitude & 0x7fffff) >> 13)));
+
+	uint32_t isSpecial = 0u - static_cast<uint32_t>(magnitude >= 0x47800000);
+	uint32_t isDenormal = 0u - static_cast<uint32_t>(magnitude < 0x38800000);
+	uint32_t half = (special & isSpecial) | (denormal & isDenormal) | (normal & ~(isSpecial | isDenormal));
+	return static_cast<uint16_t>(sign | half);
+}
+
+static inline float ToFloat(uint16_t h)
+{
+	uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+	uint32_t shifted = static_cast<uint32_t>(h & 0x7fff) << 13;
+	uint32_t exponent = shifted & (0x1f << 23);
+
+	uint32_t normal = shifted + ((127 - 15) << 23);
+	uint32_t special = normal + ((128 - 16) << 23);
+	// A denormal half is a normal float: give it the implicit one of the smallest half exponent,
+	//  then subtract that one back off exactly.
+	uint32_t denormal = FloatBits(BitsFloat(normal + (1 << 23)) - BitsFloat((127 - 14) << 23));
+
+	uint32_t isSpecial = 0u - static_cast<uint32_t>(exponent == (0x1f << 23));
+	uint32_t isDenormal = 0u - static_cast<uint32_t>(exponent == 0);
+	uint32_t bits = (special & isSpecial) | (denormal & isDenormal) | (normal & ~(isSpecial | isDenormal));
+	return BitsFloat(sign | bits);
+}
+
+uint16_t FloatToHalf(float f)
+{
+	return ToHalf(f);
+}
+
+float HalfToFloat(uint16_t h)
+{
+	return ToFloat(h);
+}
+
+#ifdef HALF_F16C_DISPATCH
+__attribute__((target("avx,f16c")))
+static size_t FloatToHalfF16C(const float* in, uint16_t* out, size_t count)
+{
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 f = _mm256_loadu_ps(in + i);
+		__m128i h = _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+	}
+	return i;
+}
+
+__attribute__((target("avx,f16c")))
+static size_t HalfToFloatF16C(const uint16_t* in, float* out, size_t count)
+{
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+		_mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+	}
+	return i;
+}
+#endif
+
+bool HalfHardwareConversion()
+{
+#ifdef HALF_F16C_DISPATCH
+	static const bool available = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+	return available;
+#else
+	return false;
+#endif
+}
+
+void FloatToHalf(const float* in, uint16_t* out, size_t count)
+{
+	size_t i = 0;
+#ifdef HALF_F16C_DISPATCH
+	if (HalfHardwareConversion())
+	{
+		i = FloatToHalfF16C(in, out, count);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		out[i] = ToHalf(in[i]);
+	}
+}
+
+void HalfToFloat(const uint16_t* in, float* out, size_t count)
+{
+	size_t i = 0;
+#ifdef HALF_F16C_DISPATCH
+	if (HalfHardwareConversion())
+	{
+		i = HalfToFloatF16C(in, out, count);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		out[i] = ToFloat(in[i]);
+	}
+}
+
+uint16_t FloatToBFloat16(float f)
+{
+	uint32_t bits;
+	memcpy(&bits, &f, 4);
+	if ((bits & 0x7fffffff) > 0x7f800000)
+	{
+		// Keep NaNs quiet NaNs instead of letting rounding turn them into infinity.
+		return static_cast<uint16_t>((bits >> 16) | 0x40);
+	}
+	// Adding 0x7fff plus the lowest kept bit rounds to nearest, ties to even.
+	bits += 0x7fff + ((bits >> 16) & 1);
+	return static_cast<uint16_t>(bits >> 16);
+}
+
+float BFloat16ToFloat(uint16_t b)
+{
+	uint32_t bits = static_cast<uint32_t>(b) << 16;
+	float f;
+	memcpy(&f, &bits, 4);
+	return f;
+}
+
+// Both bfloat16 loops are simple integer bit operations, which the compiler vectorizes on its own.
+void FloatToBFloat16(const float* in, uint16_t* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = FloatToBFloat16(in[i]);
+	}
+}
+
+void BFloat16ToFloat(const uint16_t* in, float* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = BFloat16ToFloat(in[i]);
+	}
+}
@@ -0,0 +1,140 @@
+/*
+Title: Vector Mathematics
+File Name: HalfVector.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/HalfVector.h"
+
+#include "../header/VectorBatch.h"
+
+// Vectors are converted this many at a time into buffers on the stack.
+// Small enough that the float copies stay in L1 cache between being converted and used.
+static const size_t BLOCK = 256;
+
+// The 16-bit vector types, like Vector3D and Vector4D, are plain runs of components,
+//  so a whole array converts as one run.
+
+void EncodeHalf(const Vector3D* in, size_t count, HalfVector3D* out)
+{
+	FloatToHalf(&in->x, &out->x, count * 3);
+}
+
+void EncodeHalf(const Vector4D* in, size_t count, HalfVector4D* out)
+{
+	FloatToHalf(&in->x, &out->x, count * 4);
+}
+
+void DecodeHalf(const HalfVector3D* in, size_t count, Vector3D* out)
+{
+	HalfToFloat(&in->x, &out->x, count * 3);
+}
+
+void DecodeHalf(const HalfVector4D* in, size_t count, Vector4D* out)
+{
+	HalfToFloat(&in->x, &out->x, count * 4);
+}
+
+void EncodeBFloat16(const Vector3D* in, size_t count, BFloat16Vector3D* out)
+{
+	FloatToBFloat16(&in->x, &out->x, count * 3);
+}
+
+void EncodeBFloat16(const Vector4D* in, size_t count, BFloat16Vector4D* out)
+{
+	FloatToBFloat16(&in->x, &out->x, count * 4);
+}
+
+void DecodeBFloat16(const BFloat16Vector3D* in, size_t count, Vector3D* out)
+{
+	BFloat16ToFloat(&in->x, &out->x, count * 3);
+}
+
+void DecodeBFloat16(const BFloat16Vector4D* in, size_t count, Vector4D* out)
+{
+	BFloat16ToFloat(&in->x, &out->x, count * 4);
+}
+
+// Load, convert, compute, convert back, store: one block at a time.
+// decode and encode pick the 16-bit format.
+template <typename Packed, typename Vector>
+static void NormalizePacked(const Packed* in, Packed* out, size_t count,
+	void (*decode)(const Packed*, size_t, Vector*), void (*encode)(const Vector*, size_t, Packed*))
+{
+	Vector block[BLOCK];
+	for (size_t start = 0; start < count; start += BLOCK)
+	{
+		size_t n = count - start < BLOCK ? count - start : BLOCK;
+		decode(in + start, n, block);
+		NormalizeBatch(block, block, n);
+		encode(block, n, out + start);
+	}
+}
+
+template <typename Packed, typename Vector>
+static void DotPacked(const Packed* a, const Packed* b, float* out, size_t count,
+	void (*decode)(const Packed*, size_t, Vector*))
+{
+	Vector blockA[BLOCK], blockB[BLOCK];
+	for (size_t start = 0; start < count; start += BLOCK)
+	{
+		size_t n = count - start < BLOCK ? count - start : BLOCK;
+		decode(a + start, n, blockA);
+		decode(b + start, n, blockB);
+		DotBatch(blockA, blockB, out + start, n);
+	}
+}
+
+void NormalizeBatch(const HalfVector3D* in, HalfVector3D* out, size_t count)
+{
+	NormalizePacked<HalfVector3D, Vector3D>(in, out, count, DecodeHalf, EncodeHalf);
+}
+
+void NormalizeBatch(const HalfVector4D* in, HalfVector4D* out, size_t count)
+{
+	NormalizePacked<HalfVector4D, Vector4D>(in, out, count, DecodeHalf, EncodeHalf);
+}
+
+void NormalizeBatch(const BFloat16Vector3D* in, BFloat16Vector3D* out, size_t count)
+{
+	NormalizePacked<BFloat16Vector3D, Vector3D>(in, out, count, DecodeBFloat16, EncodeBFloat16);
+}
+
+void NormalizeBatch(const BFloat16Vector4D* in, BFloat16Vector4D* out, size_t count)
+{
+	NormalizePacked<BFloat16Vector4D, Vector4D>(in, out, count, DecodeBFloat16, EncodeBFloat16);
+}
+
+void DotBatch(const HalfVector3D* a, const HalfVector3D* b, float* out, size_t count)
+{
+	DotPacked<HalfVector3D, Vector3D>(a, b, out, count, DecodeHalf);
+}
+
+void DotBatch(const HalfVector4D* a, const HalfVector4D* b, float* out, size_t count)
+{
+	DotPacked<HalfVector4D, Vector4D>(a, b, out, count, DecodeHalf);
+}
+
+void DotBatch(const BFloat16Vector3D* a, const BFloat16Vector3D* b, float* out, size_t count)
+{
+	DotPacked<BFloat16Vector3D, Vector3D>(a, b, out, count, DecodeBFloat16);
+}
+
+void DotBatch(const BFloat16Vector4D* a, const BFloat16Vector4D* b, float* out, size_t count)
+{
+	DotPacked<BFloat16Vector4D, Vector4D>(a, b, out, count, DecodeBFloat16);
+}
@@ -0,0 +1,203 @@
+/*
+Title: Vector Mathematics
+File Name: HugePages.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/HugePages.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+static const size_t SMALL_PAGE_SIZE = 4096;
+
+size_t PageBlockSize(size_t bytes, bool hugePages)
+{
+	size_t unit = hugePages ? HUGE_PAGE_SIZE : SMALL_PAGE_SIZE;
+	bytes = bytes > 0 ? bytes : 1;
+	return (bytes + unit - 1) / unit * unit;
+}
+
+#ifdef __linux__
+
+// False when transparent huge pages are switched off ("[never]"), in which case madvise still
+//  succeeds but nothing will ever be backed by them.
+static bool TransparentHugePagesEnabled()
+{
+	static const bool enabled = []
+	{
+		FILE* f = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+		if (f == nullptr)
+		{
+			return false;
+		}
+		char line[128] = {};
+		bool ok = fgets(line, sizeof(line), f) != nullptr && strstr(line, "[never]") == nullptr;
+		fclose(f);
+		return ok;
+	}();
+	return enabled;
+}
+
+#endif
+
+PageBlock AllocatePages(size_t bytes, bool hugePages)
+{
+	PageBlock block = { nullptr, PageBlockSize(bytes, hugePages), PageKind::Normal };
+#ifdef __linux__
+	const int protection = PROT_READ | PROT_WRITE;
+	const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	if (!hugePages)
+	{
+		void* p = mmap(nullptr, block.size, protection, flags, -1, 0);
+		block.data = p == MAP_FAILED ? nullptr : p;
+		return block;
+	}
+
+#ifdef MAP_HUGETLB
+	// Fails at once when the reserved pool cannot cover the whole block.
+	void* p = mmap(nullptr, block.size, protection, flags | MAP_HUGETLB, -1, 0);
+	if (p != MAP_FAILED)
+	{
+		block.data = p;
+		block.kind = PageKind::Explicit;
+		return block;
+	}
+#endif
+
+	// Transparent huge pages only back 2 MB-aligned runs, so map one huge page extra and trim the
+	//  ends to leave an aligned block.
+	size_t span = block.size + HUGE_PAGE_SIZE;
+	void* raw = mmap(nullptr, span, protection, flags, -1, 0);
+	if (raw == MAP_FAILED)
+	{
+		return block;
+	}
+	char* start = static_cast<char*>(raw);
+	char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(start) + HUGE_PAGE_SIZE - 1) & ~static_cast<uintptr_t>(HUGE_PAGE_SIZE - 1));
+	if (aligned > start)
+	{
+		munmap(start, aligned - start);
+	}
+	size_t tail = (start + span) - (aligned + block.size);
+	if (tail > 0)
+	{
+		munmap(aligned + block.size, tail);
+	}
+	block.data = aligned;
+	if (TransparentHugePagesEnabled() && madvise(aligned, block.size, MADV_HUGEPAGE) == 0)
+	{
+		block.kind = PageKind::Transparent;
+	}
+#else
+	block.data = ::operator new(block.size, std::align_val_t(64), std::nothrow);
+	if (block.data != nullptr)
+	{
+		memset(block.data, 0, block.size);
+	}
+#endif
+	return block;
+}
+
+void FreePages(const PageBlock& block)
+{
+	if (block.data == nullptr)
+	{
+		return;
+	}
+#ifdef __linux__
+	munmap(block.data, block.size);
+#else
+	::operator delete(block.data, std::align_val_t(64));
+#endif
+}
+
+size_t HugePageBytes(const void* p, size_t bytes)
+{
+	size_t total = 0;
+#ifdef __linux__
+	FILE* f = fopen("/proc/self/smaps", "r");
+	if (f == nullptr)
+	{
+		return 0;
+	}
+	uintptr_t low = reinterpret_cast<uintptr_t>(p);
+	uintptr_t high = low + bytes;
+	bool inRange = false;
+	char line[512];
+	while (fgets(line, sizeof(line), f) != nullptr)
+	{
+		// Each mapping starts with a "start-end perms ..." line, followed by "Field: value kB" lines.
+		unsigned long start, end;
+		size_t kb;
+		if (sscanf(line, "%lx-%lx ", &start, &end) == 2)
+		{
+			inRange = start < high && end > low;
+		}
+		else if (inRange &&
+			(sscanf(line, "AnonHugePages: %zu kB", &kb) == 1 ||
+			sscanf(line, "Private_Hugetlb: %zu kB", &kb) == 1 ||
+			sscanf(line, "Shared_Hugetlb: %zu kB", &kb) == 1))
+		{
+			total += kb * 1024;
+		}
+	}
+	fclose(f);
+#else
+	(void)p;
+#endif
+	// A mapping can extend beyond the range asked about.
+	return total < bytes ? total : bytes;
+}
+
+HugePageResource::HugePageResource()
+	: lastKind(PageKind::Normal)
+{
+}
+
+PageKind HugePageResource::LastKind() const
+{
+	return lastKind.load(std::memory_order_relaxed);
+}
+
+void* HugePageResource::do_allocate(size_t bytes, size_t)
+{
+	PageBlock block = AllocatePages(bytes, true);
+	if (block.data == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	lastKind.store(block.kind, std::memory_order_relaxed);
+	return block.data;
+}
+
+void HugePageResource::do_deallocate(void* p, size_t bytes, size_t)
+{
+	PageBlock block = { p, PageBlockSize(bytes, true), PageKind::Normal };
+	FreePages(block);
+}
+
+bool HugePageResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
@@ -0,0 +1,234 @@
+/*
+Title: Vector Mathematics
+File Name: LatencyHistogram.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/LatencyHistogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <thread>
+
+// Values below 2 * HALF_BUCKET are exact; each doubling above that is split into HALF_BUCKET buckets.
+static const int SUB_BUCKET_BITS = 6;
+static const uint64_t HALF_BUCKET = uint64_t(1) << SUB_BUCKET_BITS;
+static const int MAX_VALUE_BITS = 40;
+// The exact values take two halves, each doubling from 2^(SUB_BUCKET_BITS + 1) up to 2^MAX_VALUE_BITS
+//  takes one more, and a last bucket holds everything larger.
+static const size_t BUCKET_COUNT = static_cast<size_t>((MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * HALF_BUCKET + 1);
+
+static size_t BucketIndex(uint64_t value)
+{
+	if (value < 2 * HALF_BUCKET)
+	{
+		return static_cast<size_t>(value);
+	}
+	int shift = std::bit_width(value) - 1 - SUB_BUCKET_BITS;
+	size_t index = static_cast<size_t>(shift) * HALF_BUCKET + static_cast<size_t>(value >> shift);
+	return index < BUCKET_COUNT ? index : BUCKET_COUNT - 1;
+}
+
+// The largest value that lands in bucket index.
+static uint64_t BucketTop(size_t index)
+{
+	if (index < 2 * HALF_BUCKET)
+	{
+		return index;
+	}
+	int shift = static_cast<int>(index / HALF_BUCKET) - 1;
+	uint64_t mantissa = index % HALF_BUCKET + HALF_BUCKET;
+	return ((mantissa + 1) << shift) - 1;
+}
+
+LatencyHistogram::LatencyHistogram()
+	: counts(BUCKET_COUNT), count(0), min(UINT64_MAX), max(0), sum(0.0)
+{
+}
+
+void LatencyHistogram::Record(uint64_t value)
+{
+	counts[BucketIndex(value)]++;
+	count++;
+	min = value < min ? value : min;
+	max = value > max ? value : max;
+	sum += static_cast<double>(value);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+	for (size_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		counts[i] += other.counts[i];
+	}
+	count += other.count;
+	min = other.min < min ? other.min : min;
+	max = other.max > max ? other.max : max;
+	sum += other.sum;
+}
+
+void LatencyHistogram::Clear()
+{
+	std::fill(counts.begin(), counts.end(), 0);
+	count = 0;
+	min = UINT64_MAX;
+	max = 0;
+	sum = 0.0;
+}
+
+uint64_t LatencyHistogram::Count() const
+{
+	return count;
+}
+
+uint64_t LatencyHistogram::Min() const
+{
+	return count > 0 ? min : 0;
+}
+
+uint64_t LatencyHistogram::Max() const
+{
+	return max;
+}
+
+double LatencyHistogram::Mean() const
+{
+	return count > 0 ? sum / static_cast<double>(count) : 0.0;
+}
+
+uint64_t LatencyHistogram::Percentile(double fraction) const
+{
+	if (count == 0)
+	{
+		return 0;
+	}
+	// The rank of the value wanted, counting from 1.
+	double wanted = fraction * static_cast<double>(count);
+	uint64_t rank = static_cast<uint64_t>(wanted);
+	rank += static_cast<double>(rank) < wanted;
+	rank = rank < 1 ? 1 : rank > count ? count : rank;
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i < BUCKET_COUNT; i++)
+	{
+		seen += counts[i];
+		// The last bucket also holds everything too large to bucket, so only Max bounds it.
+		if (seen >= rank && i + 1 < BUCKET_COUNT)
+		{
+			uint64_t top = BucketTop(i);
+			return top < max ? top : max;
+		}
+	}
+	return max;
+}
+
+void LatencyHistogram::Print(FILE* out, const char* name) const
+{
+	fprintf(out, "%-24s %9llu calls  mean %9.3f  p50 %9.3f  p99 %9.3f  p99.9 %9.3f  max %9.3f us\n",
+		name, static_cast<unsigned long long>(count), Mean() / 1e3,
+		Percentile(0.5) / 1e3, Percentile(0.99) / 1e3, Percentile(0.999) / 1e3, Max() / 1e3);
+}
+
+// One set of counters, on its own cache lines so that stripes used by different threads do not share any.
+struct alignas(64) LatencyRecorder::Stripe
+{
+	std::atomic<uint64_t> counts[BUCKET_COUNT];
+	std::atomic<uint64_t> count;
+	std::atomic<uint64_t> sum;
+	std::atomic<uint64_t> min;
+	std::atomic<uint64_t> max;
+
+	Stripe()
+	{
+		Clear();
+	}
+
+	void Clear()
+	{
+		for (std::atomic<uint64_t>& c : counts)
+		{
+			c.store(0, std::memory_order_relaxed);
+		}
+		count.store(0, std::memory_order_relaxed);
+		sum.store(0, std::memory_order_relaxed);
+		min.store(UINT64_MAX, std::memory_order_relaxed);
+		max.store(0, std::memory_order_relaxed);
+	}
+};
+
+// Threads are numbered as they first record, and thread k uses stripe k modulo the stripe count.
+static std::atomic<unsigned> nextLatencyThread(0);
+static thread_local unsigned latencyThread = nextLatencyThread.fetch_add(1, std::memory_order_relaxed);
+
+LatencyRecorder::LatencyRecorder(unsigned stripes)
+{
+	if (stripes == 0)
+	{
+		stripes = std::thread::hardware_concurrency();
+	}
+	stripeCount = stripes > 0 ? stripes : 1;
+	this->stripes.reset(new Stripe[stripeCount]);
+}
+
+LatencyRecorder::~LatencyRecorder()
+{
+}
+
+void LatencyRecorder::Record(uint64_t nanoseconds)
+{
+	Stripe& s = stripes[latencyThread % stripeCount];
+	s.counts[BucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+	s.count.fetch_add(1, std::memory_order_relaxed);
+	s.sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+	uint64_t seen = s.min.load(std::memory_order_relaxed);
+	while (nanoseconds < seen && !s.min.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed))
+	{
+	}
+	seen = s.max.load(std::memory_order_relaxed);
+	while (nanoseconds > seen && !s.max.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed))
+	{
+	}
+}
+
+LatencyHistogram LatencyRecorder::Snapshot() const
+{
+	LatencyHistogram h;
+	for (unsigned k = 0; k < stripeCount; k++)
+	{
+		const Stripe& s = stripes[k];
+		for (size_t i = 0; i < BUCKET_COUNT; i++)
+		{
+			h.counts[i] += s.counts[i].load(std::memory_order_relaxed);
+		}
+		h.count += s.count.load(std::memory_order_relaxed);
+		h.sum += static_cast<double>(s.sum.load(std::memory_order_relaxed));
+		uint64_t min = s.min.load(std::memory_order_relaxed);
+		uint64_t max = s.max.load(std::memory_order_relaxed);
+		h.min = min < h.min ? min : h.min;
+		h.max = max > h.max ? max : h.max;
+	}
+	return h;
+}
+
+void LatencyRecorder::Clear()
+{
+	for (unsigned k = 0; k < stripeCount; k++)
+	{
+		stripes[k].Clear();
+	}
+}
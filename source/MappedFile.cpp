@@ -0,0 +1,123 @@
+/*
+Title: Vector Mathematics
+File Name: MappedFile.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/MappedFile.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+	: data(nullptr), size(0), mapped(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const char* path)
+{
+	Close();
+
+#ifndef _WIN32
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	size = static_cast<size_t>(st.st_size);
+	if (size > 0)
+	{
+		void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED)
+		{
+			close(fd);
+			size = 0;
+			return false;
+		}
+		// We will almost always sweep the file front to back.
+		madvise(p, size, MADV_SEQUENTIAL);
+		data = static_cast<const char*>(p);
+		mapped = true;
+	}
+	// The mapping stays valid after the descriptor is closed.
+	close(fd);
+	return true;
+#else
+	FILE* f = fopen(path, "rb");
+	if (!f)
+	{
+		return false;
+	}
+
+	fseek(f, 0, SEEK_END);
+	long length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (length < 0)
+	{
+		fclose(f);
+		return false;
+	}
+
+	size = static_cast<size_t>(length);
+	char* buffer = static_cast<char*>(malloc(size > 0 ? size : 1));
+	if (!buffer || fread(buffer, 1, size, f) != size)
+	{
+		free(buffer);
+		fclose(f);
+		size = 0;
+		return false;
+	}
+	fclose(f);
+	data = buffer;
+	return true;
+#endif
+}
+
+void MappedFile::Close()
+{
+#ifndef _WIN32
+	if (mapped)
+	{
+		munmap(const_cast<char*>(data), size);
+	}
+#else
+	free(const_cast<char*>(data));
+#endif
+	data = nullptr;
+	size = 0;
+	mapped = false;
+}
@@ -0,0 +1,263 @@
+/*
+Title: Vector Mathematics
+File Name: MemoryResource.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/MemoryResource.h"
+
+#include <cstdint>
+#include <new>
+
+#include "../header/HugePages.h"
+
+// Blocks, slabs and large allocations all come from AllocatePages, which maps them directly and
+//  tries huge pages when asked. Its sizes are whole pages, so each caller keeps the real size.
+static void* SystemAllocate(size_t& size, bool hugePages)
+{
+	PageBlock block = AllocatePages(size, hugePages);
+	size = block.size;
+	return block.data;
+}
+
+static void SystemFree(void* p, size_t size)
+{
+	PageBlock block = { p, size, PageKind::Normal };
+	FreePages(block);
+}
+
+static char* AlignPointer(char* p, size_t alignment)
+{
+	uintptr_t n = reinterpret_cast<uintptr_t>(p);
+	return reinterpret_cast<char*>((n + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
+}
+
+// Each block from the system starts with this header, padded to a full alignment unit.
+struct FrameArena::Block
+{
+	Block* next;
+	size_t size;
+};
+
+FrameArena::FrameArena(size_t blockSize, bool hugePages)
+	: blocks(nullptr), cursor(nullptr), limit(nullptr), blockSize(blockSize), used(0), reserved(0), hugePages(hugePages)
+{
+}
+
+FrameArena::~FrameArena()
+{
+	while (blocks != nullptr)
+	{
+		Block* next = blocks->next;
+		SystemFree(blocks, blocks->size);
+		blocks = next;
+	}
+}
+
+void FrameArena::Reset()
+{
+	Block* largest = nullptr;
+	while (blocks != nullptr)
+	{
+		Block* next = blocks->next;
+		if (largest == nullptr || blocks->size > largest->size)
+		{
+			if (largest != nullptr)
+			{
+				SystemFree(largest, largest->size);
+			}
+			largest = blocks;
+		}
+		else
+		{
+			SystemFree(blocks, blocks->size);
+		}
+		blocks = next;
+	}
+	blocks = largest;
+	used = 0;
+	reserved = 0;
+	cursor = limit = nullptr;
+	if (blocks != nullptr)
+	{
+		blocks->next = nullptr;
+		reserved = blocks->size;
+		cursor = reinterpret_cast<char*>(blocks) + VECTOR_ALLOCATION_ALIGNMENT;
+		limit = reinterpret_cast<char*>(blocks) + blocks->size;
+	}
+}
+
+size_t FrameArena::BytesUsed() const
+{
+	return used;
+}
+
+size_t FrameArena::BytesReserved() const
+{
+	return reserved;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+	if (alignment < VECTOR_ALLOCATION_ALIGNMENT)
+	{
+		alignment = VECTOR_ALLOCATION_ALIGNMENT;
+	}
+	char* p = cursor != nullptr ? AlignPointer(cursor, alignment) : nullptr;
+	if (p == nullptr || p > limit || static_cast<size_t>(limit - p) < bytes)
+	{
+		size_t needed = VECTOR_ALLOCATION_ALIGNMENT + alignment + bytes;
+		size_t size = needed > blockSize ? needed : blockSize;
+		Block* block = static_cast<Block*>(SystemAllocate(size, hugePages));
+		if (block == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		block->next = blocks;
+		block->size = size;
+		blocks = block;
+		reserved += size;
+		cursor = reinterpret_cast<char*>(block) + VECTOR_ALLOCATION_ALIGNMENT;
+		limit = reinterpret_cast<char*>(block) + size;
+		p = AlignPointer(cursor, alignment);
+	}
+	used += (p - cursor) + bytes;
+	cursor = p + bytes;
+	return p;
+}
+
+void FrameArena::do_deallocate(void*, size_t, size_t)
+{
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
+
+struct SizeClassPool::FreeBlock
+{
+	FreeBlock* next;
+};
+
+struct SizeClassPool::Slab
+{
+	Slab* next;
+	size_t size;
+};
+
+// Smallest slab taken from the system; bigger classes take four blocks' worth at a time.
+static const size_t MIN_SLAB_BYTES = 256 << 10;
+
+// Index of the smallest class, 64 << index bytes, that holds bytes.
+static int SizeClass(size_t bytes)
+{
+	int c = 0;
+	while ((VECTOR_ALLOCATION_ALIGNMENT << c) < bytes)
+	{
+		c++;
+	}
+	return c;
+}
+
+SizeClassPool::SizeClassPool(size_t maxClassBytes, bool hugePages)
+	: slabs(nullptr), maxClassBytes(maxClassBytes), reserved(0), hugePages(hugePages)
+{
+	for (int c = 0; c < CLASS_COUNT; c++)
+	{
+		freeLists[c] = nullptr;
+		cursor[c] = limit[c] = nullptr;
+	}
+}
+
+SizeClassPool::~SizeClassPool()
+{
+	while (slabs != nullptr)
+	{
+		Slab* next = slabs->next;
+		SystemFree(slabs, slabs->size);
+		slabs = next;
+	}
+}
+
+size_t SizeClassPool::BytesReserved() const
+{
+	return reserved;
+}
+
+void* SizeClassPool::do_allocate(size_t bytes, size_t alignment)
+{
+	// Blocks are only 64-byte aligned within their slab, so stricter requests go to the system, which
+	//  aligns to a page.
+	if (bytes > maxClassBytes || alignment > VECTOR_ALLOCATION_ALIGNMENT)
+	{
+		size_t size = bytes;
+		void* p = SystemAllocate(size, hugePages);
+		if (p == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	int c = SizeClass(bytes);
+	if (freeLists[c] != nullptr)
+	{
+		FreeBlock* block = freeLists[c];
+		freeLists[c] = block->next;
+		return block;
+	}
+
+	size_t classBytes = VECTOR_ALLOCATION_ALIGNMENT << c;
+	if (cursor[c] == nullptr || static_cast<size_t>(limit[c] - cursor[c]) < classBytes)
+	{
+		size_t size = VECTOR_ALLOCATION_ALIGNMENT + 4 * classBytes;
+		size = size > MIN_SLAB_BYTES ? size : MIN_SLAB_BYTES;
+		Slab* slab = static_cast<Slab*>(SystemAllocate(size, hugePages));
+		if (slab == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		slab->next = slabs;
+		slab->size = size;
+		slabs = slab;
+		reserved += size;
+		cursor[c] = reinterpret_cast<char*>(slab) + VECTOR_ALLOCATION_ALIGNMENT;
+		limit[c] = reinterpret_cast<char*>(slab) + size;
+	}
+	void* p = cursor[c];
+	cursor[c] += classBytes;
+	return p;
+}
+
+void SizeClassPool::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+	if (bytes > maxClassBytes || alignment > VECTOR_ALLOCATION_ALIGNMENT)
+	{
+		SystemFree(p, PageBlockSize(bytes, hugePages));
+		return;
+	}
+	int c = SizeClass(bytes);
+	FreeBlock* block = static_cast<FreeBlock*>(p);
+	block->next = freeLists[c];
+	freeLists[c] = block;
+}
+
+bool SizeClassPool::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
@@ -0,0 +1,438 @@
+/*
+Title: Vector Mathematics
+File Name: Numa.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/Numa.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Parses a kernel CPU or node list such as "0-3,8-11".
+static std::vector<int> ParseList(const char* text)
+{
+	std::vector<int> values;
+	const char* p = text;
+	while (*p != '\0' && *p != '\n')
+	{
+		char* next;
+		long first = strtol(p, &next, 10);
+		if (next == p)
+		{
+			break;
+		}
+		long last = first;
+		p = next;
+		if (*p == '-')
+		{
+			last = strtol(p + 1, &next, 10);
+			p = next;
+		}
+		for (long v = first; v <= last; v++)
+		{
+			values.push_back(static_cast<int>(v));
+		}
+		if (*p == ',')
+		{
+			p++;
+		}
+	}
+	return values;
+}
+
+static bool ReadList(const char* path, std::vector<int>& values)
+{
+	FILE* f = fopen(path, "r");
+	if (f == nullptr)
+	{
+		return false;
+	}
+	char line[4096];
+	bool ok = fgets(line, sizeof(line), f) != nullptr;
+	fclose(f);
+	if (ok)
+	{
+		values = ParseList(line);
+	}
+	return ok;
+}
+
+NumaTopology NumaTopology::Detect()
+{
+	NumaTopology topology;
+#ifdef __linux__
+	cpu_set_t allowed;
+	bool haveMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+	std::vector<int> nodes;
+	if (ReadList("/sys/devices/system/node/online", nodes))
+	{
+		for (int node : nodes)
+		{
+			char path[128];
+			snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+			std::vector<int> cpus;
+			std::vector<int> usable;
+			ReadList(path, cpus);
+			for (int cpu : cpus)
+			{
+				if (!haveMask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)))
+				{
+					usable.push_back(cpu);
+				}
+			}
+			if (!usable.empty())
+			{
+				topology.nodeCpus.push_back(usable);
+				topology.nodeIds.push_back(node);
+			}
+		}
+	}
+	if (topology.nodeCpus.empty() && haveMask)
+	{
+		std::vector<int> cpus;
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+		{
+			if (CPU_ISSET(cpu, &allowed))
+			{
+				cpus.push_back(cpu);
+			}
+		}
+		topology.nodeCpus.push_back(cpus);
+		topology.nodeIds.push_back(0);
+	}
+#endif
+	if (topology.nodeCpus.empty())
+	{
+		// No topology to go on: one node, with CPU numbers that pinning will simply fail on.
+		unsigned n = std::thread::hardware_concurrency();
+		std::vector<int> cpus;
+		for (unsigned cpu = 0; cpu < (n > 0 ? n : 1); cpu++)
+		{
+			cpus.push_back(static_cast<int>(cpu));
+		}
+		topology.nodeCpus.push_back(cpus);
+		topology.nodeIds.push_back(0);
+	}
+	return topology;
+}
+
+unsigned NumaTopology::NodeCount() const
+{
+	return static_cast<unsigned>(nodeCpus.size());
+}
+
+bool PinCurrentThread(const std::vector<int>& cpus)
+{
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int cpu : cpus)
+	{
+		if (cpu >= 0 && cpu < CPU_SETSIZE)
+		{
+			CPU_SET(cpu, &set);
+		}
+	}
+	return CPU_COUNT(&set) > 0 && sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+	(void)cpus;
+	return false;
+#endif
+}
+
+NumaThreadPool::NumaThreadPool(unsigned threads)
+	: topology(NumaTopology::Detect()), body(nullptr), count(0), busy(0), pinFailures(0), generation(0), stopping(false)
+{
+	unsigned nodes = topology.NodeCount();
+	unsigned cpus = 0;
+	for (const std::vector<int>& list : topology.nodeCpus)
+	{
+		cpus += static_cast<unsigned>(list.size());
+	}
+	if (threads == 0)
+	{
+		threads = cpus;
+	}
+
+	// Deal threads out to the nodes in turn, each node using its CPUs in order, then lay the
+	//  workers out node by node so each node's slices are contiguous.
+	std::vector<unsigned> perNode(nodes, 0);
+	for (unsigned t = 0, node = 0; t < threads; t++, node = (node + 1) % nodes)
+	{
+		perNode[node]++;
+	}
+	workers.resize(threads);
+	nodeFirst.resize(nodes + 1);
+	unsigned w = 0;
+	for (unsigned node = 0; node < nodes; node++)
+	{
+		nodeFirst[node] = w;
+		const std::vector<int>& list = topology.nodeCpus[node];
+		for (unsigned i = 0; i < perNode[node]; i++, w++)
+		{
+			workers[w].cpu = list[i % list.size()];
+			workers[w].node = node;
+		}
+	}
+	nodeFirst[nodes] = w;
+
+	// Wait until every worker has tried to pin itself, so Pinned is accurate from the start.
+	busy = threads;
+	for (unsigned i = 0; i < threads; i++)
+	{
+		workers[i].thread = std::thread(&NumaThreadPool::WorkerLoop, this, i);
+	}
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return busy == 0; });
+}
+
+NumaThreadPool::~NumaThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (Worker& worker : workers)
+	{
+		worker.thread.join();
+	}
+}
+
+const NumaTopology& NumaThreadPool::Topology() const
+{
+	return topology;
+}
+
+unsigned NumaThreadPool::Size() const
+{
+	return static_cast<unsigned>(workers.size());
+}
+
+bool NumaThreadPool::Pinned() const
+{
+	return pinFailures == 0;
+}
+
+void NumaThreadPool::NodeRange(unsigned node, size_t count, size_t& begin, size_t& end) const
+{
+	size_t threads = workers.size();
+	begin = count * nodeFirst[node] / threads;
+	end = count * nodeFirst[node + 1] / threads;
+}
+
+void NumaThreadPool::ParallelFor(size_t count, const std::function<void(size_t, size_t, unsigned)>& body)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	this->body = &body;
+	this->count = count;
+	busy = static_cast<unsigned>(workers.size());
+	generation++;
+	wake.notify_all();
+	done.wait(lock, [this] { return busy == 0; });
+	this->body = nullptr;
+}
+
+void NumaThreadPool::WorkerLoop(unsigned index)
+{
+	bool pinned = PinCurrentThread(std::vector<int>(1, workers[index].cpu));
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!pinned)
+	{
+		pinFailures++;
+	}
+	if (--busy == 0)
+	{
+		done.notify_one();
+	}
+	unsigned long long seen = generation;
+	size_t threads = workers.size();
+	for (;;)
+	{
+		wake.wait(lock, [&] { return stopping || generation != seen; });
+		if (stopping)
+		{
+			return;
+		}
+		seen = generation;
+		size_t begin = count * index / threads;
+		size_t end = count * (index + 1) / threads;
+		const std::function<void(size_t, size_t, unsigned)>& run = *body;
+		lock.unlock();
+		if (begin < end)
+		{
+			run(begin, end, workers[index].node);
+		}
+		lock.lock();
+		if (--busy == 0)
+		{
+			done.notify_one();
+		}
+	}
+}
+
+// Reserves bytes of memory without touching it, so no page is placed yet.
+static char* Reserve(size_t bytes)
+{
+#ifdef __linux__
+	void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	return p == MAP_FAILED ? nullptr : static_cast<char*>(p);
+#else
+	return static_cast<char*>(::operator new(bytes, std::align_val_t(64), std::nothrow));
+#endif
+}
+
+static void Release(char* p, size_t bytes)
+{
+#ifdef __linux__
+	munmap(p, bytes);
+#else
+	(void)bytes;
+	::operator delete(p, std::align_val_t(64));
+#endif
+}
+
+// Restricts the pages of [p, p + bytes) to the given kernel node. There is no libnuma here, so
+//  this calls mbind directly.
+static bool BindToNode(char* p, size_t bytes, int node)
+{
+#if defined(__linux__) && defined(__NR_mbind)
+	const int MPOL_BIND_MODE = 2;
+	unsigned long mask[16] = {};
+	if (node < 0 || node >= static_cast<int>(sizeof(mask) * 8))
+	{
+		return false;
+	}
+	mask[node / (sizeof(unsigned long) * 8)] |= 1UL << (node % (sizeof(unsigned long) * 8));
+	return syscall(__NR_mbind, p, bytes, MPOL_BIND_MODE, mask, sizeof(mask) * 8, 0) == 0;
+#else
+	(void)p;
+	(void)bytes;
+	(void)node;
+	return false;
+#endif
+}
+
+NumaBuffer::NumaBuffer(size_t count, size_t elementSize, NumaThreadPool& pool, NumaPlacement placement)
+	: count(count), elementSize(elementSize), placement(placement), bound(false)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	if (placement != NumaPlacement::Partitioned)
+	{
+		Segment segment = { Reserve(count * elementSize), count * elementSize, 0, count };
+		if (segment.data == nullptr)
+		{
+			return;
+		}
+		segments.push_back(segment);
+		if (placement == NumaPlacement::Local)
+		{
+			memset(segment.data, 0, segment.bytes);
+		}
+		else
+		{
+			pool.ParallelFor(count, [&](size_t begin, size_t end, unsigned)
+			{
+				memset(segment.data + begin * elementSize, 0, (end - begin) * elementSize);
+			});
+		}
+		return;
+	}
+
+	bound = true;
+	for (unsigned node = 0; node < pool.Topology().NodeCount(); node++)
+	{
+		Segment segment;
+		pool.NodeRange(node, count, segment.begin, segment.end);
+		if (segment.begin == segment.end)
+		{
+			continue;
+		}
+		segment.bytes = (segment.end - segment.begin) * elementSize;
+		segment.data = Reserve(segment.bytes);
+		if (segment.data == nullptr)
+		{
+			for (Segment& s : segments)
+			{
+				Release(s.data, s.bytes);
+			}
+			segments.clear();
+			bound = false;
+			return;
+		}
+		bound = BindToNode(segment.data, segment.bytes, pool.Topology().nodeIds[node]) && bound;
+		segments.push_back(segment);
+	}
+	pool.ParallelFor(count, [&](size_t begin, size_t end, unsigned)
+	{
+		memset(Span(begin), 0, (end - begin) * elementSize);
+	});
+}
+
+NumaBuffer::~NumaBuffer()
+{
+	for (Segment& segment : segments)
+	{
+		Release(segment.data, segment.bytes);
+	}
+}
+
+void* NumaBuffer::Span(size_t index) const
+{
+	for (const Segment& segment : segments)
+	{
+		if (index < segment.end || &segment == &segments.back())
+		{
+			return segment.data + (index - segment.begin) * elementSize;
+		}
+	}
+	return nullptr;
+}
+
+void* NumaBuffer::Data() const
+{
+	return segments.empty() ? nullptr : segments[0].data;
+}
+
+size_t NumaBuffer::Count() const
+{
+	return count;
+}
+
+NumaPlacement NumaBuffer::Placement() const
+{
+	return placement;
+}
+
+bool NumaBuffer::Bound() const
+{
+	return bound;
+}
@@ -0,0 +1,253 @@
+/*
+Title: Vector Mathematics
+File Name: PerfCounters.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/PerfCounters.h"
+
+#include <chrono>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static double Now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#ifdef __linux__
+
+static void Describe(PerfEvent event, perf_event_attr& attr)
+{
+	switch (event)
+	{
+	case PerfEvent::Cycles:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CPU_CYCLES;
+		break;
+	case PerfEvent::Instructions:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+		break;
+	case PerfEvent::L1DataMisses:
+		attr.type = PERF_TYPE_HW_CACHE;
+		attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		break;
+	case PerfEvent::LastLevelMisses:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		break;
+	case PerfEvent::BranchMisses:
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+		break;
+	default:
+		attr.type = PERF_TYPE_SOFTWARE;
+		attr.config = PERF_COUNT_SW_TASK_CLOCK;
+		break;
+	}
+}
+
+#endif
+
+PerfCounters::PerfCounters()
+	: opened(0), leader(-1), startTime(0.0)
+{
+	for (int e = 0; e < PERF_EVENT_COUNT; e++)
+	{
+		fds[e] = -1;
+		order[e] = -1;
+	}
+#ifdef __linux__
+	for (int e = 0; e < PERF_EVENT_COUNT; e++)
+	{
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		Describe(static_cast<PerfEvent>(e), attr);
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.disabled = leader < 0 ? 1 : 0;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, leader < 0 ? -1 : fds[leader], 0));
+		if (fd < 0)
+		{
+			continue;
+		}
+		fds[e] = fd;
+		order[opened++] = e;
+		if (leader < 0)
+		{
+			leader = e;
+		}
+	}
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+	for (int e = 0; e < PERF_EVENT_COUNT; e++)
+	{
+		if (fds[e] >= 0)
+		{
+			close(fds[e]);
+		}
+	}
+#endif
+}
+
+bool PerfCounters::Has(PerfEvent event) const
+{
+	return fds[static_cast<int>(event)] >= 0;
+}
+
+void PerfCounters::Start()
+{
+#ifdef __linux__
+	if (leader >= 0)
+	{
+		ioctl(fds[leader], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+		ioctl(fds[leader], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	}
+#endif
+	startTime = Now();
+}
+
+PerfSample PerfCounters::Stop()
+{
+	PerfSample sample;
+	memset(&sample, 0, sizeof(sample));
+#ifdef __linux__
+	if (leader >= 0)
+	{
+		ioctl(fds[leader], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+	}
+#endif
+	sample.seconds = Now() - startTime;
+#ifdef __linux__
+	if (leader < 0)
+	{
+		return sample;
+	}
+	// Group read format: the number of counters, time enabled, time running, then each value.
+	uint64_t data[3 + PERF_EVENT_COUNT];
+	ssize_t n = read(fds[leader], data, sizeof(data));
+	if (n < static_cast<ssize_t>(3 * sizeof(uint64_t)) || data[0] != static_cast<uint64_t>(opened))
+	{
+		return sample;
+	}
+	// If the group only ran part of the time, scale the counts up to the whole interval.
+	double scale = data[2] > 0 && data[2] < data[1] ? static_cast<double>(data[1]) / data[2] : 1.0;
+	for (int i = 0; i < opened; i++)
+	{
+		int e = order[i];
+		sample.values[e] = static_cast<uint64_t>(data[3 + i] * scale);
+		sample.valid[e] = data[2] > 0;
+	}
+#endif
+	return sample;
+}
+
+void KernelProfiler::Add(const char* name, size_t bytes, const PerfSample& sample)
+{
+	Entry* entry = nullptr;
+	for (Entry& e : entries)
+	{
+		if (e.name == name)
+		{
+			entry = &e;
+			break;
+		}
+	}
+	if (entry == nullptr)
+	{
+		entries.push_back(Entry());
+		entry = &entries.back();
+		entry->name = name;
+		entry->calls = 0;
+		entry->bytes = 0;
+		memset(&entry->total, 0, sizeof(entry->total));
+		for (int e = 0; e < PERF_EVENT_COUNT; e++)
+		{
+			entry->total.valid[e] = true;
+		}
+	}
+	entry->calls++;
+	entry->bytes += bytes;
+	entry->total.seconds += sample.seconds;
+	for (int e = 0; e < PERF_EVENT_COUNT; e++)
+	{
+		entry->total.values[e] += sample.values[e];
+		// A counter missing from any call makes the total meaningless.
+		entry->total.valid[e] = entry->total.valid[e] && sample.valid[e];
+	}
+}
+
+// Prints numerator / denominator * scale in a fixed-width column, or "-" if either counter is missing.
+static void PrintRate(FILE* out, const PerfSample& s, PerfEvent numerator, double denominator, bool denominatorValid, double scale, const char* format)
+{
+	int n = static_cast<int>(numerator);
+	if (!s.valid[n] || !denominatorValid || denominator <= 0.0)
+	{
+		fprintf(out, " %9s", "-");
+		return;
+	}
+	fprintf(out, format, s.values[n] / denominator * scale);
+}
+
+void KernelProfiler::Print(FILE* out) const
+{
+	fprintf(out, "%-24s %7s %10s %9s %9s %9s %9s %9s %9s %9s\n",
+		"kernel", "calls", "ms", "cpu ms", "GHz", "IPC", "B/cycle", "L1 m/KB", "LLC m/KB", "br m/Ki");
+	for (const Entry& e : entries)
+	{
+		const PerfSample& s = e.total;
+		bool haveCycles = s.valid[static_cast<int>(PerfEvent::Cycles)];
+		double cycles = static_cast<double>(s.values[static_cast<int>(PerfEvent::Cycles)]);
+		double kilobytes = e.bytes / 1024.0;
+
+		fprintf(out, "%-24s %7zu %10.3f", e.name.c_str(), e.calls, s.seconds * 1e3);
+		PrintRate(out, s, PerfEvent::TaskClock, 1e6, true, 1.0, " %9.3f");
+		PrintRate(out, s, PerfEvent::Cycles, s.seconds, true, 1e-9, " %9.3f");
+		PrintRate(out, s, PerfEvent::Instructions, cycles, haveCycles, 1.0, " %9.3f");
+		if (haveCycles && cycles > 0.0 && e.bytes > 0)
+		{
+			fprintf(out, " %9.3f", e.bytes / cycles);
+		}
+		else
+		{
+			fprintf(out, " %9s", "-");
+		}
+		PrintRate(out, s, PerfEvent::L1DataMisses, kilobytes, e.bytes > 0, 1.0, " %9.2f");
+		PrintRate(out, s, PerfEvent::LastLevelMisses, kilobytes, e.bytes > 0, 1.0, " %9.2f");
+		PrintRate(out, s, PerfEvent::BranchMisses, static_cast<double>(s.values[static_cast<int>(PerfEvent::Instructions)]),
+			s.valid[static_cast<int>(PerfEvent::Instructions)], 1e3, " %9.3f");
+		fprintf(out, "\n");
+	}
+}
+
+void KernelProfiler::Clear()
+{
+	entries.clear();
+}
@@ -0,0 +1,570 @@
+/*
+Title: Vector Mathematics
+File Name: PointCloud.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/PointCloud.h"
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Size of each block the reader thread reads, and how many may be waiting at once.
+// Together they bound the memory the reader uses no matter how large the file is.
+static const size_t BLOCK_SIZE = 1 << 20;
+static const size_t MAX_QUEUED_BLOCKS = 4;
+
+PointChunk::PointChunk()
+	: count(0)
+{
+}
+
+Vector3D PointChunk::Get(size_t i) const
+{
+	return Vector3D(x[i], y[i], z[i]);
+}
+
+PointCloudReader::PointCloudReader()
+	: file(nullptr), format(PointCloudFormat::Unknown), chunkPoints(0), failed(false),
+	binary(false), bigEndian(false), vertexCount(0), verticesRead(0), vertexStride(0),
+	pos(0), end(0), eof(false), readerDone(false), stopping(false)
+{
+}
+
+PointCloudReader::~PointCloudReader()
+{
+	Close();
+}
+
+static bool EndsWith(const char* s, const char* suffix)
+{
+	size_t n = strlen(s), m = strlen(suffix);
+	if (m > n)
+	{
+		return false;
+	}
+	for (size_t i = 0; i < m; i++)
+	{
+		char c = s[n - m + i];
+		if (c >= 'A' && c <= 'Z')
+		{
+			c = c - 'A' + 'a';
+		}
+		if (c != suffix[i])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool PointCloudReader::Open(const char* path, size_t chunkPoints)
+{
+	Close();
+	file = fopen(path, "rb");
+	if (!file)
+	{
+		return false;
+	}
+	this->chunkPoints = chunkPoints > 0 ? chunkPoints : 1;
+
+	char magic[4] = {};
+	size_t n = fread(magic, 1, 4, file);
+	fseek(file, 0, SEEK_SET);
+	if (n == 4 && memcmp(magic, "ply", 3) == 0 && (magic[3] == '\n' || magic[3] == '\r'))
+	{
+		format = PointCloudFormat::PLY;
+	}
+	else if (EndsWith(path, ".obj"))
+	{
+		format = PointCloudFormat::OBJ;
+	}
+	else
+	{
+		format = PointCloudFormat::XYZ;
+	}
+
+	reader = std::thread(&PointCloudReader::ReaderLoop, this);
+
+	if (format == PointCloudFormat::PLY && !ReadPlyHeader())
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void PointCloudReader::Close()
+{
+	if (reader.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		cv.notify_all();
+		reader.join();
+	}
+	if (file)
+	{
+		fclose(file);
+		file = nullptr;
+	}
+	format = PointCloudFormat::Unknown;
+	failed = false;
+	binary = bigEndian = false;
+	vertexCount = verticesRead = vertexStride = 0;
+	properties.clear();
+	window.clear();
+	pos = end = 0;
+	eof = false;
+	filled.clear();
+	spare.clear();
+	readerDone = stopping = false;
+}
+
+void PointCloudReader::ReaderLoop()
+{
+	for (;;)
+	{
+		std::vector<char> block;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cv.wait(lock, [this] { return stopping || filled.size() < MAX_QUEUED_BLOCKS; });
+			if (stopping)
+			{
+				return;
+			}
+			if (!spare.empty())
+			{
+				block.swap(spare.back());
+				spare.pop_back();
+			}
+		}
+
+		block.resize(BLOCK_SIZE);
+		size_t n = fread(block.data(), 1, BLOCK_SIZE, file);
+		block.resize(n);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (n > 0)
+		{
+			filled.push_back(std::move(block));
+		}
+		if (n < BLOCK_SIZE)
+		{
+			readerDone = true;
+			cv.notify_all();
+			return;
+		}
+		cv.notify_all();
+	}
+}
+
+// Appends the next block from the reader thread to the window. Returns false at end of file.
+bool PointCloudReader::Pull()
+{
+	std::vector<char> block;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, [this] { return !filled.empty() || readerDone; });
+		if (filled.empty())
+		{
+			eof = true;
+			return false;
+		}
+		block.swap(filled.front());
+		filled.pop_front();
+	}
+	cv.notify_all();
+
+	// Drop what has already been parsed before growing the window.
+	if (pos > 0)
+	{
+		memmove(window.data(), window.data() + pos, end - pos);
+		end -= pos;
+		pos = 0;
+	}
+	if (window.size() < end + block.size())
+	{
+		window.resize(end + block.size());
+	}
+	memcpy(window.data() + end, block.data(), block.size());
+	end += block.size();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	spare.push_back(std::move(block));
+	return true;
+}
+
+// Returns the next line, without its line ending. Returns false once there are no more lines.
+bool PointCloudReader::NextLine(const char*& line, const char*& lineEnd)
+{
+	for (;;)
+	{
+		const char* start = window.data() + pos;
+		const char* newline = static_cast<const char*>(memchr(start, '\n', end - pos));
+		if (newline)
+		{
+			line = start;
+			lineEnd = newline;
+			pos = (newline - window.data()) + 1;
+			break;
+		}
+		if (eof || !Pull())
+		{
+			if (pos == end)
+			{
+				return false;
+			}
+			// The last line of the file has no newline.
+			line = window.data() + pos;
+			lineEnd = window.data() + end;
+			pos = end;
+			break;
+		}
+	}
+	if (lineEnd > line && lineEnd[-1] == '\r')
+	{
+		lineEnd--;
+	}
+	return true;
+}
+
+// Returns a pointer to the next n bytes, or nullptr if the file ends first.
+const char* PointCloudReader::NextBytes(size_t n)
+{
+	while (end - pos < n)
+	{
+		if (eof || !Pull())
+		{
+			return nullptr;
+		}
+	}
+	const char* p = window.data() + pos;
+	pos += n;
+	return p;
+}
+
+static bool ParsePropertyType(const std::string& name, int& size, int& type)
+{
+	static const char* names[] = { "char", "uchar", "short", "ushort", "int", "uint", "float", "double" };
+	static const char* sizedNames[] = { "int8", "uint8", "int16", "uint16", "int32", "uint32", "float32", "float64" };
+	static const int sizes[] = { 1, 1, 2, 2, 4, 4, 4, 8 };
+	for (int i = 0; i < 8; i++)
+	{
+		if (name == names[i] || name == sizedNames[i])
+		{
+			size = sizes[i];
+			type = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Splits a header line into whitespace-separated words.
+static std::vector<std::string> SplitWords(const char* p, const char* end)
+{
+	std::vector<std::string> words;
+	while (p < end)
+	{
+		while (p < end && (*p == ' ' || *p == '\t'))
+		{
+			p++;
+		}
+		const char* start = p;
+		while (p < end && *p != ' ' && *p != '\t')
+		{
+			p++;
+		}
+		if (p > start)
+		{
+			words.push_back(std::string(start, p));
+		}
+	}
+	return words;
+}
+
+// Reads the PLY header up to end_header.
+// Only the vertex element is read, and it must be the first element in the file, which it is in
+//  practically every PLY file. List properties on vertices are not supported.
+bool PointCloudReader::ReadPlyHeader()
+{
+	const char* line;
+	const char* lineEnd;
+	bool inVertex = false;
+	bool sawVertex = false;
+	xyzProperty[0] = xyzProperty[1] = xyzProperty[2] = -1;
+
+	if (!NextLine(line, lineEnd))
+	{
+		return false;
+	}
+	while (NextLine(line, lineEnd))
+	{
+		std::vector<std::string> words = SplitWords(line, lineEnd);
+		if (words.empty() || words[0] == "comment" || words[0] == "obj_info")
+		{
+			continue;
+		}
+		if (words[0] == "end_header")
+		{
+			return sawVertex && xyzProperty[0] >= 0 && xyzProperty[1] >= 0 && xyzProperty[2] >= 0;
+		}
+		if (words[0] == "format" && words.size() >= 2)
+		{
+			binary = words[1] != "ascii";
+			bigEndian = words[1] == "binary_big_endian";
+			if (binary && !bigEndian && words[1] != "binary_little_endian")
+			{
+				return false;
+			}
+		}
+		else if (words[0] == "element" && words.size() >= 3)
+		{
+			if (sawVertex)
+			{
+				// Later elements (faces, edges) are never read.
+				inVertex = false;
+				continue;
+			}
+			if (words[1] != "vertex")
+			{
+				return false;
+			}
+			sawVertex = inVertex = true;
+			vertexCount = static_cast<size_t>(strtoull(words[2].c_str(), nullptr, 10));
+		}
+		else if (words[0] == "property" && inVertex)
+		{
+			int size, type;
+			if (words.size() < 3 || words[1] == "list" || !ParsePropertyType(words[1], size, type))
+			{
+				return false;
+			}
+			int index = static_cast<int>(properties.size());
+			for (int c = 0; c < 3; c++)
+			{
+				if (words[2] == std::string(1, static_cast<char>('x' + c)))
+				{
+					xyzProperty[c] = index;
+					xyzOffset[c] = vertexStride;
+					xyzType[c] = static_cast<PropertyType>(type);
+				}
+			}
+			properties.push_back(static_cast<PropertyType>(type));
+			vertexStride += size;
+		}
+	}
+	return false;
+}
+
+// Reads the first three numbers on an XYZ line, or the three after "v" on an OBJ line.
+// Returns false for lines that hold no point (blank lines, comments, other OBJ records).
+bool PointCloudReader::ParseTextPoint(const char* p, const char* lineEnd, float* xyz)
+{
+	while (p < lineEnd && (*p == ' ' || *p == '\t'))
+	{
+		p++;
+	}
+	if (format == PointCloudFormat::OBJ)
+	{
+		if (lineEnd - p < 2 || p[0] != 'v' || (p[1] != ' ' && p[1] != '\t'))
+		{
+			return false;
+		}
+		p += 2;
+	}
+	else if (p == lineEnd || *p == '#')
+	{
+		return false;
+	}
+
+	for (int c = 0; c < 3; c++)
+	{
+		while (p < lineEnd && (*p == ' ' || *p == '\t' || *p == ',' || *p == '+'))
+		{
+			p++;
+		}
+		std::from_chars_result result = std::from_chars(p, lineEnd, xyz[c]);
+		if (result.ec != std::errc())
+		{
+			failed = true;
+			return false;
+		}
+		p = result.ptr;
+	}
+	return true;
+}
+
+bool PointCloudReader::ParsePlyAsciiPoint(const char* p, const char* lineEnd, float* xyz)
+{
+	for (int index = 0; index < static_cast<int>(properties.size()); index++)
+	{
+		while (p < lineEnd && (*p == ' ' || *p == '\t'))
+		{
+			p++;
+		}
+		const char* start = p;
+		while (p < lineEnd && *p != ' ' && *p != '\t')
+		{
+			p++;
+		}
+		for (int c = 0; c < 3; c++)
+		{
+			if (xyzProperty[c] == index)
+			{
+				double value;
+				if (std::from_chars(start, p, value).ec != std::errc())
+				{
+					return false;
+				}
+				xyz[c] = static_cast<float>(value);
+			}
+		}
+	}
+	return true;
+}
+
+float PointCloudReader::DecodeProperty(const char* p, PropertyType type) const
+{
+	static const int sizes[] = { 1, 1, 2, 2, 4, 4, 4, 8 };
+	unsigned char bytes[8];
+	int size = sizes[static_cast<int>(type)];
+	memcpy(bytes, p, size);
+
+	// Our machines are little-endian, so only big-endian files need their bytes swapped.
+	if (bigEndian)
+	{
+		for (int i = 0; i < size / 2; i++)
+		{
+			unsigned char t = bytes[i];
+			bytes[i] = bytes[size - 1 - i];
+			bytes[size - 1 - i] = t;
+		}
+	}
+
+	switch (type)
+	{
+	case PropertyType::Int8: { int8_t v; memcpy(&v, bytes, 1); return v; }
+	case PropertyType::UInt8: { uint8_t v; memcpy(&v, bytes, 1); return v; }
+	case PropertyType::Int16: { int16_t v; memcpy(&v, bytes, 2); return v; }
+	case PropertyType::UInt16: { uint16_t v; memcpy(&v, bytes, 2); return v; }
+	case PropertyType::Int32: { int32_t v; memcpy(&v, bytes, 4); return static_cast<float>(v); }
+	case PropertyType::UInt32: { uint32_t v; memcpy(&v, bytes, 4); return static_cast<float>(v); }
+	case PropertyType::Float32: { float v; memcpy(&v, bytes, 4); return v; }
+	default: { double v; memcpy(&v, bytes, 8); return static_cast<float>(v); }
+	}
+}
+
+bool PointCloudReader::Next(PointChunk& chunk)
+{
+	if (!file || failed)
+	{
+		return false;
+	}
+	if (chunk.x.size() < chunkPoints)
+	{
+		chunk.x.resize(chunkPoints);
+		chunk.y.resize(chunkPoints);
+		chunk.z.resize(chunkPoints);
+	}
+	chunk.count = 0;
+
+	float xyz[3];
+	if (format == PointCloudFormat::PLY && binary)
+	{
+		bool plainFloats = !bigEndian && xyzType[0] == PropertyType::Float32 &&
+			xyzType[1] == PropertyType::Float32 && xyzType[2] == PropertyType::Float32;
+		while (chunk.count < chunkPoints && verticesRead < vertexCount)
+		{
+			const char* vertex = NextBytes(vertexStride);
+			if (!vertex)
+			{
+				failed = true;
+				break;
+			}
+			for (int c = 0; c < 3; c++)
+			{
+				if (plainFloats)
+				{
+					memcpy(&xyz[c], vertex + xyzOffset[c], 4);
+				}
+				else
+				{
+					xyz[c] = DecodeProperty(vertex + xyzOffset[c], xyzType[c]);
+				}
+			}
+			chunk.x[chunk.count] = xyz[0];
+			chunk.y[chunk.count] = xyz[1];
+			chunk.z[chunk.count] = xyz[2];
+			chunk.count++;
+			verticesRead++;
+		}
+	}
+	else
+	{
+		const char* line;
+		const char* lineEnd;
+		while (chunk.count < chunkPoints)
+		{
+			if (format == PointCloudFormat::PLY && verticesRead == vertexCount)
+			{
+				break;
+			}
+			if (!NextLine(line, lineEnd))
+			{
+				// A PLY file that ends before all its vertices is truncated.
+				failed = failed || format == PointCloudFormat::PLY;
+				break;
+			}
+			bool ok = (format == PointCloudFormat::PLY) ? ParsePlyAsciiPoint(line, lineEnd, xyz) : ParseTextPoint(line, lineEnd, xyz);
+			if (failed || (!ok && format == PointCloudFormat::PLY))
+			{
+				failed = true;
+				break;
+			}
+			if (ok)
+			{
+				chunk.x[chunk.count] = xyz[0];
+				chunk.y[chunk.count] = xyz[1];
+				chunk.z[chunk.count] = xyz[2];
+				chunk.count++;
+				verticesRead++;
+			}
+		}
+	}
+	return chunk.count > 0;
+}
+
+bool PointCloudReader::Failed() const
+{
+	return failed;
+}
+
+PointCloudFormat PointCloudReader::Format() const
+{
+	return format;
+}
+
+size_t PointCloudReader::DeclaredCount() const
+{
+	return format == PointCloudFormat::PLY ? vertexCount : 0;
+}
@@ -0,0 +1,159 @@
+/*
+Title: Vector Mathematics
+File Name: Probes.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/Probes.h"
+
+#ifdef VECTOR_MATH_PROBES
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	struct ProbeRegistry
+	{
+		std::mutex mutex;
+		std::vector<const char*> names;
+		std::vector<ProbeCounters*> threads;
+		// Counts from threads that have already exited.
+		unsigned long long calls[PROBE_MAX_SITES];
+		unsigned long long samples[PROBE_MAX_SITES];
+		unsigned long long sampleNanos[PROBE_MAX_SITES];
+	};
+
+	void ReportAtExit()
+	{
+		PrintProbeReport(stderr);
+	}
+
+	// Never destroyed, so threads that outlive static destruction can still check out.
+	ProbeRegistry& Registry()
+	{
+		static ProbeRegistry* registry = []
+		{
+			ProbeRegistry* r = new ProbeRegistry();
+			std::atexit(ReportAtExit);
+			return r;
+		}();
+		return *registry;
+	}
+}
+
+thread_local ProbeCounters threadProbes;
+
+ProbeSite::ProbeSite(const char* name)
+	: name(name)
+{
+	ProbeRegistry& registry = Registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	if (registry.names.size() < PROBE_MAX_SITES)
+	{
+		registry.names.push_back(name);
+	}
+	else
+	{
+		registry.names.back() = "(other)";
+	}
+	id = static_cast<unsigned>(registry.names.size()) - 1;
+}
+
+ProbeCounters::ProbeCounters()
+{
+	for (unsigned i = 0; i < PROBE_MAX_SITES; i++)
+	{
+		calls[i].store(0, std::memory_order_relaxed);
+		samples[i].store(0, std::memory_order_relaxed);
+		sampleNanos[i].store(0, std::memory_order_relaxed);
+	}
+	ProbeRegistry& registry = Registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.threads.push_back(this);
+}
+
+ProbeCounters::~ProbeCounters()
+{
+	ProbeRegistry& registry = Registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for (unsigned i = 0; i < PROBE_MAX_SITES; i++)
+	{
+		registry.calls[i] += calls[i].load(std::memory_order_relaxed);
+		registry.samples[i] += samples[i].load(std::memory_order_relaxed);
+		registry.sampleNanos[i] += sampleNanos[i].load(std::memory_order_relaxed);
+	}
+	registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), this));
+}
+
+unsigned long long ProbeNanoseconds()
+{
+	return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void PrintProbeReport(FILE* out)
+{
+	struct Row
+	{
+		const char* name;
+		unsigned long long calls, samples, sampleNanos;
+	};
+
+	std::vector<Row> rows;
+	{
+		ProbeRegistry& registry = Registry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		for (size_t i = 0; i < registry.names.size(); i++)
+		{
+			Row row = { registry.names[i], registry.calls[i], registry.samples[i], registry.sampleNanos[i] };
+			for (ProbeCounters* counters : registry.threads)
+			{
+				row.calls += counters->calls[i].load(std::memory_order_relaxed);
+				row.samples += counters->samples[i].load(std::memory_order_relaxed);
+				row.sampleNanos += counters->sampleNanos[i].load(std::memory_order_relaxed);
+			}
+			if (row.calls != 0)
+			{
+				rows.push_back(row);
+			}
+		}
+	}
+	if (rows.empty())
+	{
+		return;
+	}
+	std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.calls > b.calls; });
+	int width = 5;
+	for (const Row& row : rows)
+	{
+		width = std::max(width, static_cast<int>(strlen(row.name)));
+	}
+
+	fprintf(out, "%-*s %14s %10s %10s %12s\n", width, "probe", "calls", "samples", "mean ns", "est. ms");
+	for (const Row& row : rows)
+	{
+		double mean = row.samples != 0 ? static_cast<double>(row.sampleNanos) / row.samples : 0.0;
+		fprintf(out, "%-*s %14llu %10llu %10.1f %12.3f\n", width, row.name, row.calls, row.samples, mean, mean * row.calls / 1e6);
+	}
+}
+
+#endif
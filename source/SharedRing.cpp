@@ -0,0 +1,462 @@
+/*
+Title: Vector Mathematics
+File Name: SharedRing.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/SharedRing.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef __linux__
+#include <climits>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const uint32_t SHARED_RING_MAGIC = 0x474e4952; // "RING"
+static const uint32_t SHARED_RING_VERSION = 1;
+
+// The control block at the start of the shared memory. Each side's counters get their own cache
+//  line, so the writer and reader do not invalidate each other's lines on every update.
+// Positions only ever increase; the slot for position p is p & (capacity - 1).
+struct SharedRingHeader
+{
+	// Written last by the creator, so an opener never sees a half-initialized ring.
+	std::atomic<uint32_t> magic;
+	uint32_t version;
+	uint32_t dimension;
+	RingMode mode;
+	uint64_t capacity;
+	uint64_t dataOffset;
+
+	// End of the space claimed by writers.
+	alignas(64) std::atomic<uint64_t> reserved;
+
+	// End of the data the reader may see. Writers commit in reservation order.
+	alignas(64) std::atomic<uint64_t> committed;
+	// Futex the reader sleeps on, bumped on every commit, and whether anyone is asleep on it.
+	std::atomic<uint32_t> committedSequence;
+	std::atomic<uint32_t> readerWaiting;
+
+	// End of the data the reader has finished with.
+	alignas(64) std::atomic<uint64_t> released;
+	std::atomic<uint32_t> releasedSequence;
+	std::atomic<uint32_t> writersWaiting;
+
+	alignas(64) std::atomic<uint32_t> shutdown;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+	"atomics shared between processes must be lock-free");
+
+#ifdef __linux__
+
+static size_t RoundUpPowerOfTwo(size_t n)
+{
+	size_t p = 1;
+	while (p < n)
+	{
+		p <<= 1;
+	}
+	return p;
+}
+
+// Process-shared futexes, since the word lives in memory mapped by several processes.
+static void FutexWait(std::atomic<uint32_t>& word, uint32_t expected, const timespec* timeout)
+{
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+}
+
+static void FutexWakeAll(std::atomic<uint32_t>& word)
+{
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+// Waits until ready() is true, the ring is shut down, or the timeout passes. Returns ready().
+// Checks a few times before sleeping, since the other side is often only a moment away.
+// The waiting flag is raised before the sequence is read and the condition checked again,
+//  so a wakeup sent between the check and the sleep is never lost: either the waker sees the
+//  flag, or the sequence has moved on and the futex returns at once.
+template <typename Ready>
+static bool WaitFor(SharedRingHeader* header, std::atomic<uint32_t>& sequence, std::atomic<uint32_t>& waiting, int timeoutMilliseconds, Ready ready)
+{
+	for (int spin = 0; spin < 64; spin++)
+	{
+		if (ready() || header->shutdown.load(std::memory_order_acquire))
+		{
+			return ready();
+		}
+	}
+
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMilliseconds);
+	for (;;)
+	{
+		waiting.fetch_add(1);
+		uint32_t seen = sequence.load();
+		if (ready() || header->shutdown.load())
+		{
+			waiting.fetch_sub(1);
+			return ready();
+		}
+		if (timeoutMilliseconds < 0)
+		{
+			FutexWait(sequence, seen, nullptr);
+		}
+		else
+		{
+			std::chrono::nanoseconds left = deadline - std::chrono::steady_clock::now();
+			if (left.count() <= 0)
+			{
+				waiting.fetch_sub(1);
+				return false;
+			}
+			timespec timeout;
+			timeout.tv_sec = static_cast<time_t>(left.count() / 1000000000);
+			timeout.tv_nsec = static_cast<long>(left.count() % 1000000000);
+			FutexWait(sequence, seen, &timeout);
+		}
+		waiting.fetch_sub(1);
+	}
+}
+
+// Bumps the sequence and wakes its sleepers, if there are any.
+static void Signal(std::atomic<uint32_t>& sequence, std::atomic<uint32_t>& waiting)
+{
+	sequence.fetch_add(1);
+	if (waiting.load() > 0)
+	{
+		FutexWakeAll(sequence);
+	}
+}
+
+SharedRing::SharedRing()
+	: header(nullptr), data(nullptr), mappedSize(0), ownedName(nullptr)
+{
+}
+
+SharedRing::~SharedRing()
+{
+	Close();
+}
+
+bool SharedRing::Create(const char* name, int dimension, size_t capacity, RingMode mode)
+{
+	Close();
+	if (dimension < 2 || dimension > 4 || capacity == 0)
+	{
+		return false;
+	}
+	capacity = RoundUpPowerOfTwo(capacity);
+	size_t dataOffset = 4096;
+	mappedSize = dataOffset + capacity * dimension * sizeof(float);
+
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0)
+	{
+		return false;
+	}
+	void* p = ftruncate(fd, static_cast<off_t>(mappedSize)) == 0 ? mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+	close(fd);
+	if (p == MAP_FAILED)
+	{
+		shm_unlink(name);
+		mappedSize = 0;
+		return false;
+	}
+
+	header = new (p) SharedRingHeader();
+	header->version = SHARED_RING_VERSION;
+	header->dimension = static_cast<uint32_t>(dimension);
+	header->mode = mode;
+	header->capacity = capacity;
+	header->dataOffset = dataOffset;
+	header->reserved.store(0);
+	header->committed.store(0);
+	header->committedSequence.store(0);
+	header->readerWaiting.store(0);
+	header->released.store(0);
+	header->releasedSequence.store(0);
+	header->writersWaiting.store(0);
+	header->shutdown.store(0);
+	header->magic.store(SHARED_RING_MAGIC, std::memory_order_release);
+	data = reinterpret_cast<float*>(static_cast<char*>(p) + dataOffset);
+
+	ownedName = new char[strlen(name) + 1];
+	strcpy(ownedName, name);
+	return true;
+}
+
+bool SharedRing::Open(const char* name)
+{
+	Close();
+	int fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0)
+	{
+		return false;
+	}
+	struct stat st;
+	void* p = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(SharedRingHeader))
+	{
+		mappedSize = static_cast<size_t>(st.st_size);
+		p = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+	if (p == MAP_FAILED)
+	{
+		mappedSize = 0;
+		return false;
+	}
+
+	header = static_cast<SharedRingHeader*>(p);
+	bool ok = header->magic.load(std::memory_order_acquire) == SHARED_RING_MAGIC && header->version == SHARED_RING_VERSION &&
+		header->dimension >= 2 && header->dimension <= 4 && header->dataOffset >= sizeof(SharedRingHeader) &&
+		header->capacity > 0 && (header->capacity & (header->capacity - 1)) == 0 &&
+		header->dataOffset + header->capacity * header->dimension * sizeof(float) <= mappedSize;
+	if (!ok)
+	{
+		Close();
+		return false;
+	}
+	data = reinterpret_cast<float*>(static_cast<char*>(p) + header->dataOffset);
+	return true;
+}
+
+void SharedRing::Close()
+{
+	if (header)
+	{
+		munmap(header, mappedSize);
+	}
+	if (ownedName)
+	{
+		shm_unlink(ownedName);
+		delete[] ownedName;
+	}
+	header = nullptr;
+	data = nullptr;
+	mappedSize = 0;
+	ownedName = nullptr;
+}
+
+RingSpan SharedRing::BeginWrite(size_t count, int timeoutMilliseconds)
+{
+	RingSpan span = { nullptr, 0, 0 };
+	if (!header || count == 0)
+	{
+		return span;
+	}
+	const uint64_t capacity = header->capacity;
+	for (;;)
+	{
+		if (header->shutdown.load(std::memory_order_acquire))
+		{
+			return span;
+		}
+		uint64_t position = header->reserved.load(std::memory_order_relaxed);
+		uint64_t space = capacity - (position - header->released.load(std::memory_order_acquire));
+		uint64_t toWrap = capacity - (position & (capacity - 1));
+		uint64_t n = count < space ? count : space;
+		n = n < toWrap ? n : toWrap;
+		if (n > 0)
+		{
+			bool claimed = true;
+			if (header->mode == RingMode::SingleProducer)
+			{
+				header->reserved.store(position + n, std::memory_order_relaxed);
+			}
+			else
+			{
+				claimed = header->reserved.compare_exchange_weak(position, position + n, std::memory_order_relaxed);
+			}
+			if (claimed)
+			{
+				span.data = data + (position & (capacity - 1)) * header->dimension;
+				span.count = static_cast<size_t>(n);
+				span.position = position;
+				return span;
+			}
+			continue;
+		}
+
+		// Full: wait for the reader to release something.
+		SharedRingHeader* h = header;
+		if (!WaitFor(h, h->releasedSequence, h->writersWaiting, timeoutMilliseconds,
+			[h, position] { return h->released.load(std::memory_order_acquire) + h->capacity > h->reserved.load(std::memory_order_relaxed) || h->reserved.load(std::memory_order_relaxed) != position; }))
+		{
+			if (header->shutdown.load() || timeoutMilliseconds >= 0)
+			{
+				return span;
+			}
+		}
+	}
+}
+
+void SharedRing::EndWrite(const RingSpan& span)
+{
+	if (!header || span.count == 0)
+	{
+		return;
+	}
+	// Writers that reserved earlier must commit first, or the reader would see their unfinished space.
+	// They are only ever filling memory, so the wait is short.
+	if (header->mode == RingMode::MultiProducer)
+	{
+		while (header->committed.load(std::memory_order_acquire) != span.position)
+		{
+			std::this_thread::yield();
+		}
+	}
+	header->committed.store(span.position + span.count, std::memory_order_release);
+	Signal(header->committedSequence, header->readerWaiting);
+}
+
+RingSpan SharedRing::BeginRead(size_t maxCount, int timeoutMilliseconds)
+{
+	RingSpan span = { nullptr, 0, 0 };
+	if (!header || maxCount == 0)
+	{
+		return span;
+	}
+	SharedRingHeader* h = header;
+	uint64_t position = h->released.load(std::memory_order_relaxed);
+	if (!WaitFor(h, h->committedSequence, h->readerWaiting, timeoutMilliseconds,
+		[h, position] { return h->committed.load(std::memory_order_acquire) != position; }))
+	{
+		return span;
+	}
+	uint64_t available = h->committed.load(std::memory_order_acquire) - position;
+	uint64_t toWrap = h->capacity - (position & (h->capacity - 1));
+	uint64_t n = maxCount < available ? maxCount : available;
+	n = n < toWrap ? n : toWrap;
+	span.data = data + (position & (h->capacity - 1)) * h->dimension;
+	span.count = static_cast<size_t>(n);
+	span.position = position;
+	return span;
+}
+
+void SharedRing::EndRead(const RingSpan& span)
+{
+	if (!header || span.count == 0)
+	{
+		return;
+	}
+	header->released.store(span.position + span.count, std::memory_order_release);
+	Signal(header->releasedSequence, header->writersWaiting);
+}
+
+void SharedRing::Shutdown()
+{
+	if (!header)
+	{
+		return;
+	}
+	header->shutdown.store(1);
+	Signal(header->committedSequence, header->readerWaiting);
+	Signal(header->releasedSequence, header->writersWaiting);
+}
+
+#else
+
+SharedRing::SharedRing()
+	: header(nullptr), data(nullptr), mappedSize(0), ownedName(nullptr)
+{
+}
+
+SharedRing::~SharedRing()
+{
+}
+
+bool SharedRing::Create(const char*, int, size_t, RingMode)
+{
+	return false;
+}
+
+bool SharedRing::Open(const char*)
+{
+	return false;
+}
+
+void SharedRing::Close()
+{
+}
+
+RingSpan SharedRing::BeginWrite(size_t, int)
+{
+	return RingSpan{ nullptr, 0, 0 };
+}
+
+void SharedRing::EndWrite(const RingSpan&)
+{
+}
+
+RingSpan SharedRing::BeginRead(size_t, int)
+{
+	return RingSpan{ nullptr, 0, 0 };
+}
+
+void SharedRing::EndRead(const RingSpan&)
+{
+}
+
+void SharedRing::Shutdown()
+{
+}
+
+#endif
+
+int SharedRing::Dimension() const
+{
+	return header ? static_cast<int>(header->dimension) : 0;
+}
+
+size_t SharedRing::Capacity() const
+{
+	return header ? static_cast<size_t>(header->capacity) : 0;
+}
+
+bool SharedRing::IsShutdown() const
+{
+	return !header || header->shutdown.load() != 0;
+}
+
+bool SharedRing::Write(const float* vectors, size_t count, int timeoutMilliseconds)
+{
+	int dimension = Dimension();
+	while (count > 0)
+	{
+		RingSpan span = BeginWrite(count, timeoutMilliseconds);
+		if (span.count == 0)
+		{
+			return false;
+		}
+		memcpy(span.data, vectors, span.count * dimension * sizeof(float));
+		EndWrite(span);
+		vectors += span.count * dimension;
+		count -= span.count;
+	}
+	return true;
+}
@@ -0,0 +1,318 @@
+/*
+Title: Vector Mathematics
+File Name: SnapshotCodec.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/SnapshotCodec.h"
+
+#include <cstdint>
+#include <cstring>
+
+static const char SNAPSHOT_MAGIC[4] = { 'V', 'S', 'N', 'P' };
+
+// Run-length tokens: a tag byte, a varint length, and for literal runs the bytes themselves.
+static const uint8_t TOKEN_ZEROS = 0;
+static const uint8_t TOKEN_LITERAL = 1;
+
+// Zero runs shorter than this are cheaper to copy as part of a literal.
+static const size_t MIN_ZERO_RUN = 4;
+
+static void PutVarint(std::vector<uint8_t>& out, uint64_t v)
+{
+	while (v >= 0x80)
+	{
+		out.push_back(static_cast<uint8_t>(v | 0x80));
+		v >>= 7;
+	}
+	out.push_back(static_cast<uint8_t>(v));
+}
+
+static bool GetVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v)
+{
+	v = 0;
+	for (int shift = 0; p < end && shift < 64; shift += 7)
+	{
+		uint8_t b = *p++;
+		v |= static_cast<uint64_t>(b & 0x7f) << shift;
+		if ((b & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Length of the run of zero bytes starting at p, checking eight bytes at a time.
+static size_t ZeroRun(const uint8_t* p, const uint8_t* end)
+{
+	const uint8_t* start = p;
+	while (end - p >= 8)
+	{
+		uint64_t w;
+		memcpy(&w, p, 8);
+		if (w != 0)
+		{
+			break;
+		}
+		p += 8;
+	}
+	while (p < end && *p == 0)
+	{
+		p++;
+	}
+	return p - start;
+}
+
+static void EncodeRuns(const std::vector<uint8_t>& in, std::vector<uint8_t>& out)
+{
+	out.clear();
+	const uint8_t* p = in.data();
+	const uint8_t* end = p + in.size();
+	const uint8_t* literal = p;
+	while (p < end)
+	{
+		size_t zeros = (*p == 0) ? ZeroRun(p, end) : 0;
+		if (zeros < MIN_ZERO_RUN)
+		{
+			p += zeros > 0 ? zeros : 1;
+			continue;
+		}
+		if (p > literal)
+		{
+			out.push_back(TOKEN_LITERAL);
+			PutVarint(out, p - literal);
+			out.insert(out.end(), literal, p);
+		}
+		out.push_back(TOKEN_ZEROS);
+		PutVarint(out, zeros);
+		p += zeros;
+		literal = p;
+	}
+	if (p > literal)
+	{
+		out.push_back(TOKEN_LITERAL);
+		PutVarint(out, p - literal);
+		out.insert(out.end(), literal, p);
+	}
+}
+
+// Total length the tokens in in decode to, or false if it exceeds limit or a token is malformed.
+// Checked before out is sized, since the lengths come from the stream and a zero run of any length
+//  takes only a few bytes.
+static bool DecodedLength(const std::vector<uint8_t>& in, uint64_t limit, uint64_t& total)
+{
+	const uint8_t* p = in.data();
+	const uint8_t* end = p + in.size();
+	total = 0;
+	while (p < end)
+	{
+		uint8_t tag = *p++;
+		uint64_t length;
+		if (!GetVarint(p, end, length) || length > limit - total)
+		{
+			return false;
+		}
+		if (tag == TOKEN_LITERAL)
+		{
+			if (length > static_cast<uint64_t>(end - p))
+			{
+				return false;
+			}
+			p += length;
+		}
+		total += length;
+	}
+	return true;
+}
+
+// Reads size bytes into out. The buffer grows only as the bytes arrive, so a corrupt size runs into the
+//  end of the stream rather than allocating it all up front.
+static bool ReadBytes(FILE* in, std::vector<uint8_t>& out, uint64_t size)
+{
+	const size_t chunk = 1 << 20;
+	out.clear();
+	while (out.size() < size)
+	{
+		size_t have = out.size();
+		size_t n = size - have < chunk ? static_cast<size_t>(size - have) : chunk;
+		out.resize(have + n);
+		if (fread(out.data() + have, 1, n, in) != n)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool DecodeRuns(const std::vector<uint8_t>& in, std::vector<uint8_t>& out)
+{
+	const uint8_t* p = in.data();
+	const uint8_t* end = p + in.size();
+	size_t pos = 0;
+	while (p < end)
+	{
+		uint8_t tag = *p++;
+		uint64_t length;
+		if (!GetVarint(p, end, length) || length > out.size() - pos)
+		{
+			return false;
+		}
+		if (tag == TOKEN_ZEROS)
+		{
+			memset(out.data() + pos, 0, static_cast<size_t>(length));
+		}
+		else if (tag == TOKEN_LITERAL && length <= static_cast<uint64_t>(end - p))
+		{
+			memcpy(out.data() + pos, p, static_cast<size_t>(length));
+			p += length;
+		}
+		else
+		{
+			return false;
+		}
+		pos += static_cast<size_t>(length);
+	}
+	return pos == out.size();
+}
+
+SnapshotWriter::SnapshotWriter(FILE* out, unsigned keyframeInterval)
+	: out(out), keyframeInterval(keyframeInterval > 0 ? keyframeInterval : 1), frameIndex(0), bytesWritten(0)
+{
+}
+
+bool SnapshotWriter::WriteFrame(const Vector3D* v, size_t count)
+{
+	if (count > SNAPSHOT_MAX_VECTORS)
+	{
+		return false;
+	}
+	size_t words = count * 3;
+	bool keyframe = (frameIndex % keyframeInterval == 0) || previous.size() != words;
+	if (keyframe)
+	{
+		previous.assign(words, 0);
+	}
+
+	// XOR against the previous frame and shuffle byte b of word i into planes[b * words + i].
+	// previous is updated in the same pass, so it always holds the last frame's raw bits.
+	const uint32_t* bits = reinterpret_cast<const uint32_t*>(&v->x);
+	planes.resize(words * 4);
+	uint8_t* plane0 = planes.data();
+	uint8_t* plane1 = plane0 + words;
+	uint8_t* plane2 = plane1 + words;
+	uint8_t* plane3 = plane2 + words;
+	for (size_t i = 0; i < words; i++)
+	{
+		uint32_t word;
+		memcpy(&word, bits + i, 4);
+		uint32_t delta = word ^ previous[i];
+		previous[i] = word;
+		plane0[i] = static_cast<uint8_t>(delta);
+		plane1[i] = static_cast<uint8_t>(delta >> 8);
+		plane2[i] = static_cast<uint8_t>(delta >> 16);
+		plane3[i] = static_cast<uint8_t>(delta >> 24);
+	}
+	EncodeRuns(planes, encoded);
+
+	SnapshotFrameHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+	header.flags = keyframe ? SNAPSHOT_KEYFRAME : 0;
+	header.frameIndex = frameIndex;
+	header.count = count;
+	header.encodedSize = encoded.size();
+
+	bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+	ok = ok && (encoded.empty() || fwrite(encoded.data(), 1, encoded.size(), out) == encoded.size());
+	if (!ok)
+	{
+		// The next frame must not be a delta against one that never made it out.
+		previous.clear();
+		return false;
+	}
+	bytesWritten += sizeof(header) + encoded.size();
+	frameIndex++;
+	return true;
+}
+
+uint64_t SnapshotWriter::BytesWritten() const
+{
+	return bytesWritten;
+}
+
+SnapshotReader::SnapshotReader(FILE* in)
+	: in(in), frameIndex(0)
+{
+}
+
+bool SnapshotReader::ReadFrame(std::vector<Vector3D>& frame)
+{
+	SnapshotFrameHeader header;
+	if (fread(&header, sizeof(header), 1, in) != 1 || memcmp(header.magic, SNAPSHOT_MAGIC, 4) != 0)
+	{
+		return false;
+	}
+
+	if (header.count > SNAPSHOT_MAX_VECTORS)
+	{
+		return false;
+	}
+	size_t words = static_cast<size_t>(header.count) * 3;
+	bool keyframe = (header.flags & SNAPSHOT_KEYFRAME) != 0;
+	if (!keyframe && previous.size() != words)
+	{
+		// A delta frame with nothing, or the wrong thing, to apply it to.
+		return false;
+	}
+
+	uint64_t decoded;
+	if (!ReadBytes(in, encoded, header.encodedSize) || !DecodedLength(encoded, words * 4, decoded) || decoded != words * 4)
+	{
+		return false;
+	}
+	planes.resize(words * 4);
+	if (!DecodeRuns(encoded, planes))
+	{
+		return false;
+	}
+
+	if (keyframe)
+	{
+		previous.assign(words, 0);
+	}
+	frame.resize(static_cast<size_t>(header.count));
+	uint32_t* bits = reinterpret_cast<uint32_t*>(&frame.data()->x);
+	const uint8_t* plane0 = planes.data();
+	const uint8_t* plane1 = plane0 + words;
+	const uint8_t* plane2 = plane1 + words;
+	const uint8_t* plane3 = plane2 + words;
+	for (size_t i = 0; i < words; i++)
+	{
+		uint32_t delta = plane0[i] | (plane1[i] << 8) | (plane2[i] << 16) | (static_cast<uint32_t>(plane3[i]) << 24);
+		uint32_t word = delta ^ previous[i];
+		previous[i] = word;
+		memcpy(bits + i, &word, 4);
+	}
+	frameIndex = header.frameIndex;
+	return true;
+}
+
+uint64_t SnapshotReader::FrameIndex() const
+{
+	return frameIndex;
+}
@@ -0,0 +1,155 @@
+/*
+Title: Vector Mathematics
+File Name: ThreadPool.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/ThreadPool.h"
+
+#include "../header/Trace.h"
+
+ThreadPool::ThreadPool(unsigned threads)
+	: loopWorkers(0), body(nullptr), count(0), grain(1), next(0), busy(0), generation(0), stopping(false)
+{
+	if (threads == 0)
+	{
+		threads = std::thread::hardware_concurrency();
+	}
+	for (unsigned i = 1; i < threads; i++)
+	{
+		workers.emplace_back(&ThreadPool::WorkerLoop, this, 0ull);
+	}
+	loopWorkers = static_cast<unsigned>(workers.size());
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+unsigned ThreadPool::Size() const
+{
+	return loopWorkers + 1;
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body)
+{
+	if (grain == 0)
+	{
+		grain = 1;
+	}
+	TraceScope trace("ParallelFor", "pool", "count", count);
+	// Not worth waking anyone for a single chunk.
+	if (loopWorkers == 0 || count <= grain)
+	{
+		for (size_t begin = 0; begin < count; begin += grain)
+		{
+			TraceScope trace("chunk", "pool", "begin", begin);
+			body(begin, count - begin < grain ? count : begin + grain);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->body = &body;
+		this->count = count;
+		this->grain = grain;
+		next.store(0, std::memory_order_relaxed);
+		busy = loopWorkers;
+		generation++;
+	}
+	wake.notify_all();
+	RunChunks();
+
+	// Workers that arrive late find no chunks left, but must still check in before body goes out of scope.
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return busy == 0; });
+	this->body = nullptr;
+}
+
+// Claims chunks until there are none left.
+void ThreadPool::RunChunks()
+{
+	for (;;)
+	{
+		size_t chunk = next.fetch_add(1, std::memory_order_relaxed);
+		size_t begin = chunk * grain;
+		if (begin >= count)
+		{
+			return;
+		}
+		TraceScope trace("chunk", "pool", "begin", begin);
+		(*body)(begin, count - begin < grain ? count : begin + grain);
+	}
+}
+
+void ThreadPool::Post(std::function<void()> job)
+{
+	// Notify under the lock: the job may let its owner finish and destroy the pool as soon as the lock is released.
+	std::lock_guard<std::mutex> lock(mutex);
+	jobs.push_back(std::move(job));
+	if (workers.empty())
+	{
+		workers.emplace_back(&ThreadPool::WorkerLoop, this, generation);
+	}
+	wake.notify_one();
+}
+
+// seen is the generation when the worker was started, read by the thread starting it: read here instead,
+//  a worker still starting up could miss a loop that is counting on it.
+void ThreadPool::WorkerLoop(unsigned long long seen)
+{
+	SetTraceThreadName("pool worker");
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;)
+	{
+		wake.wait(lock, [&] { return stopping || generation != seen || !jobs.empty(); });
+		if (!jobs.empty())
+		{
+			std::function<void()> job = std::move(jobs.front());
+			jobs.pop_front();
+			lock.unlock();
+			{
+				TraceScope trace("job", "pool");
+				job();
+			}
+			lock.lock();
+			continue;
+		}
+		if (stopping)
+		{
+			return;
+		}
+		seen = generation;
+		lock.unlock();
+		RunChunks();
+		lock.lock();
+		if (--busy == 0)
+		{
+			done.notify_one();
+		}
+	}
+}
@@ -0,0 +1,231 @@
+/*
+Title: Vector Mathematics
+File Name: Trace.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/Trace.h"
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> traceRecording(false);
+
+namespace
+{
+	struct TraceEvent
+	{
+		const char* name;
+		const char* category;
+		const char* argName;
+		unsigned long long argValue;
+		unsigned long long start;
+		unsigned long long duration;
+	};
+
+	const size_t TRACE_BLOCK_EVENTS = 1024;
+
+	// Events are appended by the owning thread and published by the release store to used,
+	//  so the exporter can read every event below used without a lock.
+	struct TraceBlock
+	{
+		TraceEvent events[TRACE_BLOCK_EVENTS];
+		std::atomic<size_t> used;
+		std::atomic<TraceBlock*> next;
+
+		TraceBlock()
+			: used(0), next(nullptr)
+		{
+		}
+	};
+
+	// One per thread that has recorded. Kept after the thread exits so its events can still be exported.
+	struct TraceBuffer
+	{
+		TraceBlock* head;
+		TraceBlock* tail;
+		unsigned tid;
+		std::atomic<const char*> threadName;
+	};
+
+	struct TraceRegistry
+	{
+		std::mutex mutex;
+		std::vector<TraceBuffer*> buffers;
+		std::chrono::steady_clock::time_point origin;
+	};
+
+	// Never destroyed, so threads still running during static destruction can record safely.
+	TraceRegistry& Registry()
+	{
+		static TraceRegistry* registry = []
+		{
+			TraceRegistry* r = new TraceRegistry();
+			r->origin = std::chrono::steady_clock::now();
+			return r;
+		}();
+		return *registry;
+	}
+
+	thread_local TraceBuffer* threadBuffer = nullptr;
+	thread_local const char* threadName = nullptr;
+
+	TraceBuffer* ThreadBuffer()
+	{
+		if (threadBuffer == nullptr)
+		{
+			TraceBuffer* buffer = new TraceBuffer();
+			buffer->head = buffer->tail = new TraceBlock();
+			buffer->threadName.store(threadName, std::memory_order_relaxed);
+			TraceRegistry& registry = Registry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			buffer->tid = static_cast<unsigned>(registry.buffers.size());
+			registry.buffers.push_back(buffer);
+			threadBuffer = buffer;
+		}
+		return threadBuffer;
+	}
+
+	// Names and categories are string literals in practice, but quote them properly anyway.
+	void WriteJsonString(FILE* out, const char* s)
+	{
+		fputc('"', out);
+		for (; *s != '\0'; s++)
+		{
+			unsigned char c = static_cast<unsigned char>(*s);
+			if (c == '"' || c == '\\')
+			{
+				fputc('\\', out);
+				fputc(c, out);
+			}
+			else if (c < 0x20)
+			{
+				fprintf(out, "\\u%04x", c);
+			}
+			else
+			{
+				fputc(c, out);
+			}
+		}
+		fputc('"', out);
+	}
+}
+
+void StartTrace()
+{
+	Registry();
+	traceRecording.store(true, std::memory_order_relaxed);
+}
+
+void StopTrace()
+{
+	traceRecording.store(false, std::memory_order_relaxed);
+}
+
+void ClearTrace()
+{
+	TraceRegistry& registry = Registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for (TraceBuffer* buffer : registry.buffers)
+	{
+		for (TraceBlock* block = buffer->head; block != nullptr; block = block->next.load(std::memory_order_relaxed))
+		{
+			block->used.store(0, std::memory_order_relaxed);
+		}
+		buffer->tail = buffer->head;
+	}
+}
+
+void SetTraceThreadName(const char* name)
+{
+	threadName = name;
+	if (threadBuffer != nullptr)
+	{
+		threadBuffer->threadName.store(name, std::memory_order_relaxed);
+	}
+}
+
+unsigned long long TraceNanoseconds()
+{
+	return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - Registry().origin).count());
+}
+
+void RecordTraceEvent(const char* name, const char* category, unsigned long long start, unsigned long long duration, const char* argName, unsigned long long argValue)
+{
+	TraceBuffer* buffer = ThreadBuffer();
+	TraceBlock* block = buffer->tail;
+	size_t used = block->used.load(std::memory_order_relaxed);
+	if (used == TRACE_BLOCK_EVENTS)
+	{
+		// Blocks left over from before a ClearTrace are reused before new ones are made.
+		TraceBlock* next = block->next.load(std::memory_order_relaxed);
+		if (next == nullptr)
+		{
+			next = new TraceBlock();
+			block->next.store(next, std::memory_order_release);
+		}
+		buffer->tail = block = next;
+		used = 0;
+	}
+	block->events[used] = TraceEvent{name, category, argName, argValue, start, duration};
+	block->used.store(used + 1, std::memory_order_release);
+}
+
+bool WriteChromeTrace(FILE* out)
+{
+	TraceRegistry& registry = Registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+	bool first = true;
+	for (TraceBuffer* buffer : registry.buffers)
+	{
+		const char* name = buffer->threadName.load(std::memory_order_relaxed);
+		if (name != nullptr)
+		{
+			fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",", buffer->tid);
+			WriteJsonString(out, name);
+			fprintf(out, "}}");
+			first = false;
+		}
+		for (TraceBlock* block = buffer->head; block != nullptr; block = block->next.load(std::memory_order_acquire))
+		{
+			size_t used = block->used.load(std::memory_order_acquire);
+			for (size_t i = 0; i < used; i++)
+			{
+				const TraceEvent& e = block->events[i];
+				fprintf(out, "%s\n{\"name\":", first ? "" : ",");
+				WriteJsonString(out, e.name);
+				fprintf(out, ",\"cat\":");
+				WriteJsonString(out, e.category);
+				fprintf(out, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03llu,\"dur\":%llu.%03llu",
+					buffer->tid, e.start / 1000, e.start % 1000, e.duration / 1000, e.duration % 1000);
+				if (e.argName != nullptr)
+				{
+					fprintf(out, ",\"args\":{");
+					WriteJsonString(out, e.argName);
+					fprintf(out, ":%llu}", e.argValue);
+				}
+				fputc('}', out);
+				first = false;
+			}
+		}
+	}
+	fprintf(out, "\n]}\n");
+	return !ferror(out);
+}
@@ -19,94 +19,113 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "../header/Vector2D.h"
+#include "../header/Probes.h"
 
 Vector2D::Vector2D()
 	: x(0), y(0)
 {
+	VECTOR_PROBE("Vector2D::Vector2D()");
 }
 
 Vector2D::Vector2D(float x, float y)
 	: x(x), y(y)
 {
+	VECTOR_PROBE("Vector2D::Vector2D(float, float)");
 }
 
 Vector2D operator-(Vector2D v)
 {
+	VECTOR_PROBE("operator-(Vector2D)");
 	return Vector2D(-v.x, -v.y);
 }
 
 Vector2D operator+(Vector2D l, Vector2D r)
 {
+	VECTOR_PROBE("operator+(Vector2D, Vector2D)");
 	return Vector2D(l.x + r.x, l.y + r.y);
 }
 
 Vector2D operator-(Vector2D l, Vector2D r)
 {
+	VECTOR_PROBE("operator-(Vector2D, Vector2D)");
 	return l + (-r);
 }
 
 Vector2D operator*(float s, Vector2D v)
 {
+	VECTOR_PROBE("operator*(float, Vector2D)");
 	return Vector2D(s * v.x, s * v.y);
 }
 
 Vector2D operator*(Vector2D v, float s)
 {
+	VECTOR_PROBE("operator*(Vector2D, float)");
 	return s * v;
 }
 
 Vector2D operator/(Vector2D v, float s)
 {
+	VECTOR_PROBE("operator/(Vector2D, float)");
 	return (1.0f/s) * v;
 }
 
 bool operator==(Vector2D l, Vector2D r)
 {
+	VECTOR_PROBE("operator==(Vector2D, Vector2D)");
 	return ((l.x == r.x) && (l.y == r.y));
 }
 
 bool operator!=(Vector2D l, Vector2D r)
 {
+	VECTOR_PROBE("operator!=(Vector2D, Vector2D)");
 	return !(l == r);
 }
 
 float Dot(Vector2D l, Vector2D r)
 {
+	VECTOR_PROBE("Dot(Vector2D, Vector2D)");
 	return l.x * r.x + l.y * r.y;
 }
 
 Vector2D Project(Vector2D a, Vector2D b)
 {
+	VECTOR_PROBE("Project(Vector2D, Vector2D)");
 	return  (Dot(a, b) / Dot(b, b)) * b;
 }
 
 Vector2D Reject(Vector2D a, Vector2D b)
 {
+	VECTOR_PROBE("Reject(Vector2D, Vector2D)");
 	return a - Project(a, b);
 }
 
 float Magnitude(Vector2D v)
 {
+	VECTOR_PROBE("Magnitude(Vector2D)");
 	return sqrtf(Dot(v, v));
 }
 
 float MagInverse(Vector2D v)
 {
+	VECTOR_PROBE("MagInverse(Vector2D)");
 	return 1.0f / Magnitude(v);
 }
 
 float MagFastInv(Vector2D v)
 {
+	VECTOR_PROBE("MagFastInv(Vector2D)");
 	return FastInvSqrt(Dot(v, v));
 }
 
 float MagSquared(Vector2D v)
 {
+	VECTOR_PROBE("MagSquared(Vector2D)");
 	return Dot(v, v);
 }
 
 std::ostream& operator<<(std::ostream& os, Vector2D v)
 {
+	VECTOR_PROBE("operator<<(std::ostream&, Vector2D)");
 	os << "(" << v.x << ", " << v.y << ")";
 	return os;
 }
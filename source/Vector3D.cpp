@@ -19,74 +19,89 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "../header/Vector3D.h"
+#include "../header/Probes.h"
 
 Vector3D::Vector3D()
 	: x(0), y(0), z(0)
 {
+	VECTOR_PROBE("Vector3D::Vector3D()");
 }
 
 Vector3D::Vector3D(float x, float y, float z)
 	: x(x), y(y), z(z)
 {
+	VECTOR_PROBE("Vector3D::Vector3D(float, float, float)");
 }
 
 Vector3D operator-(Vector3D v)
 {
+	VECTOR_PROBE("operator-(Vector3D)");
 	return Vector3D(-v.x, -v.y, -v.z);
 }
 
 Vector3D operator+(Vector3D l, Vector3D r)
 {
+	VECTOR_PROBE("operator+(Vector3D, Vector3D)");
 	return Vector3D(l.x + r.x, l.y + r.y, l.z + r.z);
 }
 
 Vector3D operator-(Vector3D l, Vector3D r)
 {
+	VECTOR_PROBE("operator-(Vector3D, Vector3D)");
 	return l + (-r);
 }
 
 Vector3D operator*(float s, Vector3D v)
 {
+	VECTOR_PROBE("operator*(float, Vector3D)");
 	return Vector3D(s * v.x, s * v.y, s * v.z);
 }
 
 Vector3D operator*(Vector3D v, float s)
 {
+	VECTOR_PROBE("operator*(Vector3D, float)");
 	return s * v;
 }
 
 Vector3D operator/(Vector3D v, float s)
 {
+	VECTOR_PROBE("operator/(Vector3D, float)");
 	return (1.0f/s) * v;
 }
 
 bool operator==(Vector3D l, Vector3D r)
 {
+	VECTOR_PROBE("operator==(Vector3D, Vector3D)");
 	return ((l.x == r.x) && (l.y == r.y) && (l.z == r.z));
 }
 
 bool operator!=(Vector3D l, Vector3D r)
 {
+	VECTOR_PROBE("operator!=(Vector3D, Vector3D)");
 	return !(l == r);
 }
 
 float Dot(Vector3D l, Vector3D r)
 {
+	VECTOR_PROBE("Dot(Vector3D, Vector3D)");
 	return l.x * r.x + l.y * r.y + l.z * r.z;
 }
 
 Vector3D Project(Vector3D a, Vector3D b)
 {
+	VECTOR_PROBE("Project(Vector3D, Vector3D)");
 	return (Dot(a, b) / Dot(b, b)) * b;
 }
 
 Vector3D Reject(Vector3D a, Vector3D b)
 {
+	VECTOR_PROBE("Reject(Vector3D, Vector3D)");
 	return a - Project(a, b);
 }
 
 Vector3D Cross(Vector3D a, Vector3D b)
 {
+	VECTOR_PROBE("Cross(Vector3D, Vector3D)");
 	return Vector3D(a.y * b.z - a.z * b.y,
 					a.z * b.x - a.x * b.z,
 					a.x * b.y - a.y * b.x);
@@ -94,26 +109,31 @@ Vector3D Cross(Vector3D a, Vector3D b)
 
 float Magnitude(Vector3D v)
 {
+	VECTOR_PROBE("Magnitude(Vector3D)");
 	return sqrtf(Dot(v, v));
 }
 
 float MagInverse(Vector3D v)
 {
+	VECTOR_PROBE("MagInverse(Vector3D)");
 	return 1.0f / Magnitude(v);
 }
 
 float MagSquared(Vector3D v)
 {
+	VECTOR_PROBE("MagSquared(Vector3D)");
 	return Dot(v, v);
 }
 
 float ScalarTriple(Vector3D a, Vector3D b, Vector3D c)
 {
+	VECTOR_PROBE("ScalarTriple(Vector3D, Vector3D, Vector3D)");
 	return Dot(Cross(a, b), c);
 }
 
 std::ostream& operator<<(std::ostream& os, Vector3D v)
 {
+	VECTOR_PROBE("operator<<(std::ostream&, Vector3D)");
 	os << "(" << v.x << ", " << v.y << ", " << v.z << ")";
 	return os;
 }
@@ -19,89 +19,107 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "../header/Vector4D.h"
+#include "../header/Probes.h"
 
 Vector4D::Vector4D()
 	: x(0), y(0), z(0), w(0)
 {
+	VECTOR_PROBE("Vector4D::Vector4D()");
 }
 
 Vector4D::Vector4D(float x, float y, float z, float w)
 	: x(x), y(y), z(z), w(w)
 {
+	VECTOR_PROBE("Vector4D::Vector4D(float, float, float, float)");
 }
 
 Vector4D operator-(Vector4D v)
 {
+	VECTOR_PROBE("operator-(Vector4D)");
 	return Vector4D(-v.x, -v.y, -v.z, -v.w);
 }
 
 Vector4D operator+(Vector4D l, Vector4D r)
 {
+	VECTOR_PROBE("operator+(Vector4D, Vector4D)");
 	return Vector4D(l.x + r.x, l.y + r.y, l.z + r.z, l.w + r.w);
 }
 
 Vector4D operator-(Vector4D l, Vector4D r)
 {
+	VECTOR_PROBE("operator-(Vector4D, Vector4D)");
 	return l + (-r);
 }
 
 Vector4D operator*(float s, Vector4D v)
 {
+	VECTOR_PROBE("operator*(float, Vector4D)");
 	return Vector4D(s * v.x, s * v.y, s * v.z, s * v.w);
 }
 
 Vector4D operator*(Vector4D v, float s)
 {
+	VECTOR_PROBE("operator*(Vector4D, float)");
 	return s * v;
 }
 
 Vector4D operator/(Vector4D v, float s)
 {
+	VECTOR_PROBE("operator/(Vector4D, float)");
 	return (1.0f/s) * v;
 }
 
 bool operator==(Vector4D l, Vector4D r)
 {
+	VECTOR_PROBE("operator==(Vector4D, Vector4D)");
 	return ((l.x == r.x) && (l.y == r.y) && (l.z == r.z) && (l.w == r.w));
 }
 
 bool operator!=(Vector4D l, Vector4D r)
 {
+	VECTOR_PROBE("operator!=(Vector4D, Vector4D)");
 	return !(l == r);
 }
 
 float Dot(Vector4D l, Vector4D r)
 {
+	VECTOR_PROBE("Dot(Vector4D, Vector4D)");
 	return l.x * r.x + l.y * r.y + l.z * r.z + l.w * r.w;
 }
 
 Vector4D Project(Vector4D a, Vector4D b)
 {
+	VECTOR_PROBE("Project(Vector4D, Vector4D)");
 	return (Dot(a, b) / Dot(b, b)) * b;
 }
 
 Vector4D Reject(Vector4D a, Vector4D b)
 {
+	VECTOR_PROBE("Reject(Vector4D, Vector4D)");
 	return a - Project(a, b);
 }
 
 float Magnitude(Vector4D v)
 {
+	VECTOR_PROBE("Magnitude(Vector4D)");
 	return sqrtf(Dot(v, v));
 }
 
 float MagInverse(Vector4D v)
 {
+	VECTOR_PROBE("MagInverse(Vector4D)");
 	return 1.0f / Magnitude(v);
 }
 
 float MagSquared(Vector4D v)
 {
+	VECTOR_PROBE("MagSquared(Vector4D)");
 	return Dot(v, v);
 }
 
 std::ostream & operator<<(std::ostream& os, Vector4D v)
 {
+	VECTOR_PROBE("operator<<(std::ostream&, Vector4D)");
 	os << "(" << v.x << ", " << v.y << ", " << v.z << ", " << v.w << ")";
 	return os;
 }
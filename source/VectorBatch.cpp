@@ -0,0 +1,194 @@
+/*
+Title: Vector Mathematics
+File Name: VectorBatch.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/VectorBatch.h"
+
+void NormalizeBatch(const Vector2D* in, Vector2D* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector2D v = in[i];
+		float inv = 1.0f / sqrtf(v.x * v.x + v.y * v.y);
+		out[i].x = v.x * inv;
+		out[i].y = v.y * inv;
+	}
+}
+
+void NormalizeBatch(const Vector3D* in, Vector3D* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector3D v = in[i];
+		float inv = 1.0f / sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+		out[i].x = v.x * inv;
+		out[i].y = v.y * inv;
+		out[i].z = v.z * inv;
+	}
+}
+
+void NormalizeBatch(const Vector4D* in, Vector4D* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector4D v = in[i];
+		float inv = 1.0f / sqrtf(v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w);
+		out[i].x = v.x * inv;
+		out[i].y = v.y * inv;
+		out[i].z = v.z * inv;
+		out[i].w = v.w * inv;
+	}
+}
+
+void DotBatch(const Vector2D* a, const Vector2D* b, float* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = a[i].x * b[i].x + a[i].y * b[i].y;
+	}
+}
+
+void DotBatch(const Vector3D* a, const Vector3D* b, float* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = a[i].x * b[i].x + a[i].y * b[i].y + a[i].z * b[i].z;
+	}
+}
+
+void DotBatch(const Vector4D* a, const Vector4D* b, float* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = a[i].x * b[i].x + a[i].y * b[i].y + a[i].z * b[i].z + a[i].w * b[i].w;
+	}
+}
+
+void CrossBatch(const Vector3D* a, const Vector3D* b, Vector3D* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector3D l = a[i], r = b[i];
+		out[i].x = l.y * r.z - l.z * r.y;
+		out[i].y = l.z * r.x - l.x * r.z;
+		out[i].z = l.x * r.y - l.y * r.x;
+	}
+}
+
+void MagnitudeBatch(const Vector2D* in, float* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = sqrtf(in[i].x * in[i].x + in[i].y * in[i].y);
+	}
+}
+
+void MagnitudeBatch(const Vector3D* in, float* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = sqrtf(in[i].x * in[i].x + in[i].y * in[i].y + in[i].z * in[i].z);
+	}
+}
+
+void MagnitudeBatch(const Vector4D* in, float* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = sqrtf(in[i].x * in[i].x + in[i].y * in[i].y + in[i].z * in[i].z + in[i].w * in[i].w);
+	}
+}
+
+void ProjectBatch(const Vector2D* a, const Vector2D* b, Vector2D* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector2D l = a[i], r = b[i];
+		float s = (l.x * r.x + l.y * r.y) / (r.x * r.x + r.y * r.y);
+		out[i].x = s * r.x;
+		out[i].y = s * r.y;
+	}
+}
+
+void ProjectBatch(const Vector3D* a, const Vector3D* b, Vector3D* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector3D l = a[i], r = b[i];
+		float s = (l.x * r.x + l.y * r.y + l.z * r.z) / (r.x * r.x + r.y * r.y + r.z * r.z);
+		out[i].x = s * r.x;
+		out[i].y = s * r.y;
+		out[i].z = s * r.z;
+	}
+}
+
+void ProjectBatch(const Vector4D* a, const Vector4D* b, Vector4D* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector4D l = a[i], r = b[i];
+		float s = (l.x * r.x + l.y * r.y + l.z * r.z + l.w * r.w) / (r.x * r.x + r.y * r.y + r.z * r.z + r.w * r.w);
+		out[i].x = s * r.x;
+		out[i].y = s * r.y;
+		out[i].z = s * r.z;
+		out[i].w = s * r.w;
+	}
+}
+
+void TransformBatch(const Vector2D* in, Vector2D* out, size_t count, const float* matrix, Vector2D t)
+{
+	const float m00 = matrix[0], m01 = matrix[1];
+	const float m10 = matrix[2], m11 = matrix[3];
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector2D v = in[i];
+		out[i].x = m00 * v.x + m01 * v.y + t.x;
+		out[i].y = m10 * v.x + m11 * v.y + t.y;
+	}
+}
+
+void TransformBatch(const Vector3D* in, Vector3D* out, size_t count, const float* matrix, Vector3D t)
+{
+	const float m00 = matrix[0], m01 = matrix[1], m02 = matrix[2];
+	const float m10 = matrix[3], m11 = matrix[4], m12 = matrix[5];
+	const float m20 = matrix[6], m21 = matrix[7], m22 = matrix[8];
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector3D v = in[i];
+		out[i].x = m00 * v.x + m01 * v.y + m02 * v.z + t.x;
+		out[i].y = m10 * v.x + m11 * v.y + m12 * v.z + t.y;
+		out[i].z = m20 * v.x + m21 * v.y + m22 * v.z + t.z;
+	}
+}
+
+void TransformBatch(const Vector4D* in, Vector4D* out, size_t count, const float* matrix, Vector4D t)
+{
+	const float m00 = matrix[0], m01 = matrix[1], m02 = matrix[2], m03 = matrix[3];
+	const float m10 = matrix[4], m11 = matrix[5], m12 = matrix[6], m13 = matrix[7];
+	const float m20 = matrix[8], m21 = matrix[9], m22 = matrix[10], m23 = matrix[11];
+	const float m30 = matrix[12], m31 = matrix[13], m32 = matrix[14], m33 = matrix[15];
+	for (size_t i = 0; i < count; i++)
+	{
+		Vector4D v = in[i];
+		out[i].x = m00 * v.x + m01 * v.y + m02 * v.z + m03 * v.w + t.x;
+		out[i].y = m10 * v.x + m11 * v.y + m12 * v.z + m13 * v.w + t.y;
+		out[i].z = m20 * v.x + m21 * v.y + m22 * v.z + m23 * v.w + t.z;
+		out[i].w = m30 * v.x + m31 * v.y + m32 * v.z + m33 * v.w + t.w;
+	}
+}
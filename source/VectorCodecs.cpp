@@ -0,0 +1,249 @@
+/*
+Title: Vector Mathematics
+File Name: VectorCodecs.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/VectorCodecs.h"
+
+#include <math.h>
+#include <string.h>
+
+// The per-element helpers all live in this file, so the compiler can inline them into the batch
+//  loops. Like the half conversions, they compute both sides of every choice and pick one with a
+//  mask, since a ?: around float arithmetic leaves a branch in the loop. The position loops and the
+//  32- and 16-bit normal loops then vectorize; the 24-bit normal loops do not, as their 3-byte
+//  codes have no vector load or store.
+
+static inline uint32_t FloatBits(float f)
+{
+	uint32_t bits;
+	memcpy(&bits, &f, 4);
+	return bits;
+}
+
+static inline float BitsFloat(uint32_t bits)
+{
+	float f;
+	memcpy(&f, &bits, 4);
+	return f;
+}
+
+// a where condition holds, b elsewhere.
+static inline float Select(bool condition, float a, float b)
+{
+	uint32_t mask = 0u - static_cast<uint32_t>(condition);
+	return BitsFloat((FloatBits(a) & mask) | (FloatBits(b) & ~mask));
+}
+
+// Clamps to [0, max] and truncates. NaN fails both comparisons and becomes 0, so the cast never
+//  sees a value it cannot represent. The cast goes through int32_t, which SSE2 converts directly.
+static inline uint32_t ClampToCode(float q, float max)
+{
+	q = q > 0.0f ? q : 0.0f;
+	q = q < max ? q : max;
+	return static_cast<uint32_t>(static_cast<int32_t>(q));
+}
+
+Bounds3D ComputeBounds(const Vector3D* v, size_t count)
+{
+	Bounds3D b;
+	if (count == 0)
+	{
+		return b;
+	}
+	b.min = b.max = v[0];
+	for (size_t i = 1; i < count; i++)
+	{
+		b.min.x = v[i].x < b.min.x ? v[i].x : b.min.x;
+		b.min.y = v[i].y < b.min.y ? v[i].y : b.min.y;
+		b.min.z = v[i].z < b.min.z ? v[i].z : b.min.z;
+		b.max.x = v[i].x > b.max.x ? v[i].x : b.max.x;
+		b.max.y = v[i].y > b.max.y ? v[i].y : b.max.y;
+		b.max.z = v[i].z > b.max.z ? v[i].z : b.max.z;
+	}
+	return b;
+}
+
+// Maps [min, max] onto [0, 65535]. A flat axis maps everything to 0.
+static float QuantizeScale(float min, float max)
+{
+	return max > min ? 65535.0f / (max - min) : 0.0f;
+}
+
+static uint16_t Quantize16(float value, float min, float scale)
+{
+	return static_cast<uint16_t>(ClampToCode((value - min) * scale + 0.5f, 65535.0f));
+}
+
+void EncodePositions16(const Vector3D* in, size_t count, Bounds3D bounds, QuantizedPosition* out)
+{
+	float sx = QuantizeScale(bounds.min.x, bounds.max.x);
+	float sy = QuantizeScale(bounds.min.y, bounds.max.y);
+	float sz = QuantizeScale(bounds.min.z, bounds.max.z);
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i].x = Quantize16(in[i].x, bounds.min.x, sx);
+		out[i].y = Quantize16(in[i].y, bounds.min.y, sy);
+		out[i].z = Quantize16(in[i].z, bounds.min.z, sz);
+	}
+}
+
+void DecodePositions16(const QuantizedPosition* in, size_t count, Bounds3D bounds, Vector3D* out)
+{
+	Vector3D step = (1.0f / 65535.0f) * (bounds.max - bounds.min);
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i].x = bounds.min.x + in[i].x * step.x;
+		out[i].y = bounds.min.y + in[i].y * step.y;
+		out[i].z = bounds.min.z + in[i].z * step.z;
+	}
+}
+
+// Float's own rounding when decoding, a couple of ulps of the largest coordinate on an axis.
+static float RoundingError(float min, float max)
+{
+	float m = fabsf(min) > fabsf(max) ? fabsf(min) : fabsf(max);
+	return m * (1.0f / 4194304.0f);
+}
+
+Vector3D PositionError16(Bounds3D bounds)
+{
+	Vector3D step = (0.5f / 65535.0f) * (bounds.max - bounds.min);
+	return Vector3D(step.x + RoundingError(bounds.min.x, bounds.max.x),
+					step.y + RoundingError(bounds.min.y, bounds.max.y),
+					step.z + RoundingError(bounds.min.z, bounds.max.z));
+}
+
+static inline float SignNotZero(float f)
+{
+	return Select(f >= 0.0f, 1.0f, -1.0f);
+}
+
+uint32_t EncodeOctahedral(Vector3D n, int bits)
+{
+	// Project onto the octahedron.
+	float l1 = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+	float invL1 = Select(l1 > 0.0f, 1.0f / l1, 0.0f);
+	float u = n.x * invL1;
+	float v = n.y * invL1;
+
+	// Fold the lower half of the octahedron out over the corners of the square.
+	bool lower = n.z < 0.0f;
+	float fu = (1.0f - fabsf(v)) * SignNotZero(u);
+	float fv = (1.0f - fabsf(u)) * SignNotZero(v);
+	u = Select(lower, fu, u);
+	v = Select(lower, fv, v);
+
+	// [-1, 1] -> [0, 2^bits - 1]. A NaN component encodes as the -1 edge.
+	float maxCode = static_cast<float>((1u << bits) - 1);
+	uint32_t qu = ClampToCode((u * 0.5f + 0.5f) * maxCode + 0.5f, maxCode);
+	uint32_t qv = ClampToCode((v * 0.5f + 0.5f) * maxCode + 0.5f, maxCode);
+	return (qu << bits) | qv;
+}
+
+// Writes the fields rather than returning a Vector3D, whose constructor is not inline, so the batch
+//  loops below vectorize.
+static inline void DecodeOctahedralTo(uint32_t code, int bits, Vector3D& out)
+{
+	uint32_t mask = (1u << bits) - 1;
+	float scale = 2.0f / static_cast<float>(mask);
+	float u = static_cast<float>((code >> bits) & mask) * scale - 1.0f;
+	float v = static_cast<float>(code & mask) * scale - 1.0f;
+
+	// Unfold: points outside the diamond |u| + |v| <= 1 came from the lower half.
+	float z = 1.0f - fabsf(u) - fabsf(v);
+	bool lower = z < 0.0f;
+	float fu = (1.0f - fabsf(v)) * SignNotZero(u);
+	float fv = (1.0f - fabsf(u)) * SignNotZero(v);
+	u = Select(lower, fu, u);
+	v = Select(lower, fv, v);
+
+	// Normalize inline rather than calling MagInverse. The sqrtf only vectorizes without math errno,
+	//  which CMakeLists.txt turns off for this file.
+	float inv = 1.0f / sqrtf(u * u + v * v + z * z);
+	out.x = u * inv;
+	out.y = v * inv;
+	out.z = z * inv;
+}
+
+Vector3D DecodeOctahedral(uint32_t code, int bits)
+{
+	Vector3D n;
+	DecodeOctahedralTo(code, bits, n);
+	return n;
+}
+
+float OctahedralMaxError(int bits)
+{
+	// Each coordinate is off by at most half a step, h = 1 / (2^bits - 1). That moves the point on the
+	//  octahedron by at most sqrt(6) h, and normalizing the point, which is at least 1/sqrt(3) from the
+	//  origin, turns that into an angle of at most sqrt(18) h.
+	return 4.2426407f / static_cast<float>((1u << bits) - 1);
+}
+
+void EncodeNormals32(const Vector3D* in, size_t count, uint32_t* out)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = EncodeOctahedral(in[i], 16);
+	}
+}
+
+void DecodeNormals32(const uint32_t* in, size_t count, Vector3D* out)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		DecodeOctahedralTo(in[i], 16, out[i]);
+	}
+}
+
+void EncodeNormals24(const Vector3D* in, size_t count, uint8_t* out)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		uint32_t code = EncodeOctahedral(in[i], 12);
+		out[3 * i + 0] = static_cast<uint8_t>(code);
+		out[3 * i + 1] = static_cast<uint8_t>(code >> 8);
+		out[3 * i + 2] = static_cast<uint8_t>(code >> 16);
+	}
+}
+
+void DecodeNormals24(const uint8_t* in, size_t count, Vector3D* out)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		uint32_t code = in[3 * i] | (in[3 * i + 1] << 8) | (in[3 * i + 2] << 16);
+		DecodeOctahedralTo(code, 12, out[i]);
+	}
+}
+
+void EncodeNormals16(const Vector3D* in, size_t count, uint16_t* out)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = static_cast<uint16_t>(EncodeOctahedral(in[i], 8));
+	}
+}
+
+void DecodeNormals16(const uint16_t* in, size_t count, Vector3D* out)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		DecodeOctahedralTo(in[i], 8, out[i]);
+	}
+}
@@ -0,0 +1,300 @@
+/*
+Title: Vector Mathematics
+File Name: VectorFile.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/VectorFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static const char VECTOR_FILE_MAGIC[4] = { 'V', 'E', 'C', 'F' };
+
+static uint64_t RoundUp(uint64_t n, uint64_t alignment)
+{
+	return (n + alignment - 1) / alignment * alignment;
+}
+
+// Four independent multiply-xor lanes over 8-byte words, so the multiplies can overlap.
+// Data can be fed in pieces as long as every piece but the last is a multiple of 32 bytes.
+struct ChecksumState
+{
+	uint64_t lanes[4];
+	uint64_t size;
+
+	ChecksumState()
+		: size(0)
+	{
+		lanes[0] = 0xcbf29ce484222325ULL;
+		lanes[1] = 0x84222325cbf29ce4ULL;
+		lanes[2] = 0x9ce484222325cbf2ULL;
+		lanes[3] = 0x2325cbf29ce48422ULL;
+	}
+
+	void Update(const void* data, size_t n)
+	{
+		const uint64_t prime = 0x100000001b3ULL;
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		size_t words = n / 8;
+		size_t i = 0;
+		for (; i + 4 <= words; i += 4)
+		{
+			for (int lane = 0; lane < 4; lane++)
+			{
+				uint64_t w;
+				memcpy(&w, bytes + (i + lane) * 8, 8);
+				lanes[lane] = (lanes[lane] ^ w) * prime;
+			}
+		}
+		for (; i < words; i++)
+		{
+			uint64_t w;
+			memcpy(&w, bytes + i * 8, 8);
+			lanes[0] = (lanes[0] ^ w) * prime;
+		}
+		for (size_t b = words * 8; b < n; b++)
+		{
+			lanes[1] = (lanes[1] ^ bytes[b]) * prime;
+		}
+		size += n;
+	}
+
+	uint64_t Final() const
+	{
+		const uint64_t prime = 0x100000001b3ULL;
+		uint64_t h = size;
+		for (int lane = 0; lane < 4; lane++)
+		{
+			h = (h ^ lanes[lane]) * prime;
+			h ^= h >> 29;
+		}
+		return h;
+	}
+};
+
+uint64_t VectorFileChecksum(const void* data, size_t size)
+{
+	ChecksumState state;
+	state.Update(data, size);
+	return state.Final();
+}
+
+VectorFileHeader MakeVectorFileHeader(int dimension, size_t count, VectorLayout layout)
+{
+	VectorFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, VECTOR_FILE_MAGIC, 4);
+	header.version = VECTOR_FILE_VERSION;
+	header.headerSize = sizeof(VectorFileHeader);
+	header.dimension = static_cast<uint8_t>(dimension);
+	header.elementType = static_cast<uint8_t>(VectorElementType::Float32);
+	header.layout = static_cast<uint8_t>(layout);
+	header.alignment = VECTOR_FILE_ALIGNMENT;
+	header.count = count;
+	header.dataOffset = RoundUp(sizeof(VectorFileHeader), VECTOR_FILE_ALIGNMENT);
+	if (layout == VectorLayout::AoS)
+	{
+		header.dataSize = count * dimension * sizeof(float);
+	}
+	else
+	{
+		header.planeStride = RoundUp(count * sizeof(float), VECTOR_FILE_ALIGNMENT);
+		header.dataSize = header.planeStride * dimension;
+	}
+	return header;
+}
+
+bool ValidVectorFileHeader(const VectorFileHeader& h, uint64_t fileSize)
+{
+	bool valid = memcmp(h.magic, VECTOR_FILE_MAGIC, 4) == 0 &&
+		h.version == VECTOR_FILE_VERSION &&
+		h.headerSize == sizeof(VectorFileHeader) &&
+		h.dimension >= 2 && h.dimension <= 4 &&
+		h.elementType == static_cast<uint8_t>(VectorElementType::Float32) &&
+		h.layout <= static_cast<uint8_t>(VectorLayout::SoA) &&
+		h.dataOffset % sizeof(float) == 0 &&
+		h.dataOffset <= fileSize &&
+		h.dataSize <= fileSize - h.dataOffset;
+	// The sizes are compared by division: count and planeStride come from the file, and multiplying them could wrap.
+	if (valid && h.layout == static_cast<uint8_t>(VectorLayout::AoS))
+	{
+		valid = h.count <= h.dataSize / (h.dimension * sizeof(float));
+	}
+	else if (valid)
+	{
+		valid = h.count <= h.planeStride / sizeof(float) &&
+			h.planeStride % sizeof(float) == 0 &&
+			h.planeStride <= h.dataSize / h.dimension;
+	}
+	return valid;
+}
+
+// Writes count vectors of the given dimension, stored AoS in components, to path.
+// The data is streamed out in chunks, so writing never needs a second copy of the array.
+static bool WriteVectorFile(const char* path, const float* components, int dimension, size_t count, VectorLayout layout)
+{
+	VectorFileHeader header = MakeVectorFileHeader(dimension, count, layout);
+
+	FILE* f = fopen(path, "wb");
+	if (!f)
+	{
+		return false;
+	}
+
+	// The header is written twice: once to reserve its space, and again once the checksum is known.
+	unsigned char padding[VECTOR_FILE_ALIGNMENT] = {};
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	size_t padSize = static_cast<size_t>(header.dataOffset - sizeof(header));
+	ok = ok && (padSize == 0 || fwrite(padding, 1, padSize, f) == padSize);
+
+	ChecksumState checksum;
+	if (layout == VectorLayout::AoS)
+	{
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(components);
+		const size_t chunk = 1 << 20;
+		for (size_t offset = 0; ok && offset < header.dataSize; offset += chunk)
+		{
+			size_t n = static_cast<size_t>(header.dataSize - offset) < chunk ? static_cast<size_t>(header.dataSize - offset) : chunk;
+			checksum.Update(bytes + offset, n);
+			ok = fwrite(bytes + offset, 1, n, f) == n;
+		}
+	}
+	else
+	{
+		// Transpose one plane at a time through a small buffer.
+		// The last chunk of each plane carries the zero padding up to planeStride.
+		const size_t chunk = 1 << 18;
+		std::vector<float> buffer(chunk);
+		size_t planeFloats = static_cast<size_t>(header.planeStride / sizeof(float));
+		for (int c = 0; ok && c < dimension; c++)
+		{
+			for (size_t start = 0; ok && start < planeFloats; start += chunk)
+			{
+				size_t n = planeFloats - start < chunk ? planeFloats - start : chunk;
+				for (size_t i = 0; i < n; i++)
+				{
+					buffer[i] = (start + i < count) ? components[(start + i) * dimension + c] : 0.0f;
+				}
+				checksum.Update(buffer.data(), n * sizeof(float));
+				ok = fwrite(buffer.data(), sizeof(float), n, f) == n;
+			}
+		}
+	}
+
+	header.checksum = checksum.Final();
+	ok = ok && fseek(f, 0, SEEK_SET) == 0;
+	ok = ok && fwrite(&header, sizeof(header), 1, f) == 1;
+	ok = (fclose(f) == 0) && ok;
+	return ok;
+}
+
+bool WriteVectorFile(const char* path, const Vector2D* v, size_t count, VectorLayout layout)
+{
+	return WriteVectorFile(path, &v->x, 2, count, layout);
+}
+
+bool WriteVectorFile(const char* path, const Vector3D* v, size_t count, VectorLayout layout)
+{
+	return WriteVectorFile(path, &v->x, 3, count, layout);
+}
+
+bool WriteVectorFile(const char* path, const Vector4D* v, size_t count, VectorLayout layout)
+{
+	return WriteVectorFile(path, &v->x, 4, count, layout);
+}
+
+VectorFile::VectorFile()
+	: header(nullptr)
+{
+	memset(&view, 0, sizeof(view));
+}
+
+bool VectorFile::Open(const char* path, bool verifyChecksum)
+{
+	Close();
+	if (!file.Open(path) || file.size < sizeof(VectorFileHeader))
+	{
+		Close();
+		return false;
+	}
+
+	const VectorFileHeader* h = reinterpret_cast<const VectorFileHeader*>(file.data);
+	bool valid = ValidVectorFileHeader(*h, file.size);
+	if (valid && verifyChecksum)
+	{
+		valid = VectorFileChecksum(file.data + h->dataOffset, static_cast<size_t>(h->dataSize)) == h->checksum;
+	}
+	if (!valid)
+	{
+		Close();
+		return false;
+	}
+
+	header = h;
+	const float* base = reinterpret_cast<const float*>(file.data + h->dataOffset);
+	view.count = static_cast<size_t>(h->count);
+	view.dimension = h->dimension;
+	for (int c = 0; c < h->dimension; c++)
+	{
+		if (h->layout == static_cast<uint8_t>(VectorLayout::AoS))
+		{
+			view.components[c] = base + c;
+		}
+		else
+		{
+			view.components[c] = base + c * (h->planeStride / sizeof(float));
+		}
+	}
+	view.stride = (h->layout == static_cast<uint8_t>(VectorLayout::AoS)) ? h->dimension : 1;
+	return true;
+}
+
+void VectorFile::Close()
+{
+	file.Close();
+	header = nullptr;
+	memset(&view, 0, sizeof(view));
+}
+
+const Vector2D* AsVector2D(const VectorArrayView& view)
+{
+	if (view.dimension != 2 || view.stride != 2)
+	{
+		return nullptr;
+	}
+	return reinterpret_cast<const Vector2D*>(view.components[0]);
+}
+
+const Vector3D* AsVector3D(const VectorArrayView& view)
+{
+	if (view.dimension != 3 || view.stride != 3)
+	{
+		return nullptr;
+	}
+	return reinterpret_cast<const Vector3D*>(view.components[0]);
+}
+
+const Vector4D* AsVector4D(const VectorArrayView& view)
+{
+	if (view.dimension != 4 || view.stride != 4)
+	{
+		return nullptr;
+	}
+	return reinterpret_cast<const Vector4D*>(view.components[0]);
+}
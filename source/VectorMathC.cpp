@@ -0,0 +1,202 @@
+/*
+Title: Vector Mathematics
+File Name: VectorMathC.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/VectorMathC.h"
+
+#include "../header/VectorBatch.h"
+
+// Vectors per gather/scatter block when an array is not tightly packed. Small enough to stay in L1.
+static const size_t BLOCK = 256;
+
+template <typename T>
+static const T& At(const float* base, size_t stride, size_t i)
+{
+	return *reinterpret_cast<const T*>(reinterpret_cast<const char*>(base) + i * stride);
+}
+
+template <typename T>
+static T& At(float* base, size_t stride, size_t i)
+{
+	return *reinterpret_cast<T*>(reinterpret_cast<char*>(base) + i * stride);
+}
+
+// Returns the n elements starting at start, either in place or copied into block.
+template <typename T>
+static const T* Gather(const float* in, size_t stride, size_t start, size_t n, T* block)
+{
+	if (stride == sizeof(T))
+	{
+		return reinterpret_cast<const T*>(in) + start;
+	}
+	for (size_t i = 0; i < n; i++)
+	{
+		block[i] = At<T>(in, stride, start + i);
+	}
+	return block;
+}
+
+// Where a kernel should write the n elements starting at start: in place, or into block to be scattered.
+template <typename T>
+static T* Target(float* out, size_t stride, size_t start, T* block)
+{
+	return stride == sizeof(T) ? reinterpret_cast<T*>(out) + start : block;
+}
+
+template <typename T>
+static void Scatter(const T* block, float* out, size_t stride, size_t start, size_t n)
+{
+	if (stride == sizeof(T))
+	{
+		return;
+	}
+	for (size_t i = 0; i < n; i++)
+	{
+		At<T>(out, stride, start + i) = block[i];
+	}
+}
+
+// Runs kernel(in, out, n) over strided arrays, a block at a time.
+template <typename In, typename Out, typename Kernel>
+static void Unary(const float* in, size_t inStride, float* out, size_t outStride, size_t count, Kernel kernel)
+{
+	if (inStride == sizeof(In) && outStride == sizeof(Out))
+	{
+		kernel(reinterpret_cast<const In*>(in), reinterpret_cast<Out*>(out), count);
+		return;
+	}
+	In inBlock[BLOCK];
+	Out outBlock[BLOCK];
+	for (size_t start = 0; start < count; start += BLOCK)
+	{
+		size_t n = count - start < BLOCK ? count - start : BLOCK;
+		Out* target = Target(out, outStride, start, outBlock);
+		kernel(Gather(in, inStride, start, n, inBlock), target, n);
+		Scatter(target, out, outStride, start, n);
+	}
+}
+
+// Runs kernel(a, b, out, n) over strided arrays, a block at a time.
+template <typename In, typename Out, typename Kernel>
+static void Binary(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count, Kernel kernel)
+{
+	if (aStride == sizeof(In) && bStride == sizeof(In) && outStride == sizeof(Out))
+	{
+		kernel(reinterpret_cast<const In*>(a), reinterpret_cast<const In*>(b), reinterpret_cast<Out*>(out), count);
+		return;
+	}
+	In aBlock[BLOCK];
+	In bBlock[BLOCK];
+	Out outBlock[BLOCK];
+	for (size_t start = 0; start < count; start += BLOCK)
+	{
+		size_t n = count - start < BLOCK ? count - start : BLOCK;
+		Out* target = Target(out, outStride, start, outBlock);
+		kernel(Gather(a, aStride, start, n, aBlock), Gather(b, bStride, start, n, bBlock), target, n);
+		Scatter(target, out, outStride, start, n);
+	}
+}
+
+int vmAbiVersion(void)
+{
+	return VECTOR_MATH_ABI_VERSION;
+}
+
+void vmNormalize2D(const float* in, size_t inStride, float* out, size_t outStride, size_t count)
+{
+	Unary<Vector2D, Vector2D>(in, inStride, out, outStride, count, [](const Vector2D* i, Vector2D* o, size_t n) { NormalizeBatch(i, o, n); });
+}
+
+void vmNormalize3D(const float* in, size_t inStride, float* out, size_t outStride, size_t count)
+{
+	Unary<Vector3D, Vector3D>(in, inStride, out, outStride, count, [](const Vector3D* i, Vector3D* o, size_t n) { NormalizeBatch(i, o, n); });
+}
+
+void vmNormalize4D(const float* in, size_t inStride, float* out, size_t outStride, size_t count)
+{
+	Unary<Vector4D, Vector4D>(in, inStride, out, outStride, count, [](const Vector4D* i, Vector4D* o, size_t n) { NormalizeBatch(i, o, n); });
+}
+
+void vmMagnitude2D(const float* in, size_t inStride, float* out, size_t outStride, size_t count)
+{
+	Unary<Vector2D, float>(in, inStride, out, outStride, count, [](const Vector2D* i, float* o, size_t n) { MagnitudeBatch(i, o, n); });
+}
+
+void vmMagnitude3D(const float* in, size_t inStride, float* out, size_t outStride, size_t count)
+{
+	Unary<Vector3D, float>(in, inStride, out, outStride, count, [](const Vector3D* i, float* o, size_t n) { MagnitudeBatch(i, o, n); });
+}
+
+void vmMagnitude4D(const float* in, size_t inStride, float* out, size_t outStride, size_t count)
+{
+	Unary<Vector4D, float>(in, inStride, out, outStride, count, [](const Vector4D* i, float* o, size_t n) { MagnitudeBatch(i, o, n); });
+}
+
+void vmDot2D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count)
+{
+	Binary<Vector2D, float>(a, aStride, b, bStride, out, outStride, count, [](const Vector2D* l, const Vector2D* r, float* o, size_t n) { DotBatch(l, r, o, n); });
+}
+
+void vmDot3D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count)
+{
+	Binary<Vector3D, float>(a, aStride, b, bStride, out, outStride, count, [](const Vector3D* l, const Vector3D* r, float* o, size_t n) { DotBatch(l, r, o, n); });
+}
+
+void vmDot4D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count)
+{
+	Binary<Vector4D, float>(a, aStride, b, bStride, out, outStride, count, [](const Vector4D* l, const Vector4D* r, float* o, size_t n) { DotBatch(l, r, o, n); });
+}
+
+void vmCross3D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count)
+{
+	Binary<Vector3D, Vector3D>(a, aStride, b, bStride, out, outStride, count, [](const Vector3D* l, const Vector3D* r, Vector3D* o, size_t n) { CrossBatch(l, r, o, n); });
+}
+
+void vmProject2D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count)
+{
+	Binary<Vector2D, Vector2D>(a, aStride, b, bStride, out, outStride, count, [](const Vector2D* l, const Vector2D* r, Vector2D* o, size_t n) { ProjectBatch(l, r, o, n); });
+}
+
+void vmProject3D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count)
+{
+	Binary<Vector3D, Vector3D>(a, aStride, b, bStride, out, outStride, count, [](const Vector3D* l, const Vector3D* r, Vector3D* o, size_t n) { ProjectBatch(l, r, o, n); });
+}
+
+void vmProject4D(const float* a, size_t aStride, const float* b, size_t bStride, float* out, size_t outStride, size_t count)
+{
+	Binary<Vector4D, Vector4D>(a, aStride, b, bStride, out, outStride, count, [](const Vector4D* l, const Vector4D* r, Vector4D* o, size_t n) { ProjectBatch(l, r, o, n); });
+}
+
+void vmTransform2D(const float* in, size_t inStride, float* out, size_t outStride, size_t count, const float* matrix, const float* translation)
+{
+	Vector2D t = translation ? Vector2D(translation[0], translation[1]) : Vector2D(0, 0);
+	Unary<Vector2D, Vector2D>(in, inStride, out, outStride, count, [&](const Vector2D* i, Vector2D* o, size_t n) { TransformBatch(i, o, n, matrix, t); });
+}
+
+void vmTransform3D(const float* in, size_t inStride, float* out, size_t outStride, size_t count, const float* matrix, const float* translation)
+{
+	Vector3D t = translation ? Vector3D(translation[0], translation[1], translation[2]) : Vector3D(0, 0, 0);
+	Unary<Vector3D, Vector3D>(in, inStride, out, outStride, count, [&](const Vector3D* i, Vector3D* o, size_t n) { TransformBatch(i, o, n, matrix, t); });
+}
+
+void vmTransform4D(const float* in, size_t inStride, float* out, size_t outStride, size_t count, const float* matrix, const float* translation)
+{
+	Vector4D t = translation ? Vector4D(translation[0], translation[1], translation[2], translation[3]) : Vector4D(0, 0, 0, 0);
+	Unary<Vector4D, Vector4D>(in, inStride, out, outStride, count, [&](const Vector4D* i, Vector4D* o, size_t n) { TransformBatch(i, o, n, matrix, t); });
+}
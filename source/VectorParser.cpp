@@ -0,0 +1,272 @@
+/*
+Title: Vector Mathematics
+File Name: VectorParser.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/VectorParser.h"
+
+#include <charconv>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Finding line ends is the one part of parsing that touches every byte, so it is left to memchr,
+//  which the C library implements with SIMD compares many bytes at a time.
+static const char* FindLineEnd(const char* p, const char* end)
+{
+	const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+	return newline ? newline : end;
+}
+
+static bool IsBlank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static bool IsBlankLine(const char* p, const char* end)
+{
+	while (p < end && IsBlank(*p))
+	{
+		p++;
+	}
+	return p == end;
+}
+
+// Parses one line into dimension floats. Returns false if the line is malformed.
+static bool ParseLine(const char* p, const char* end, float* components, int dimension)
+{
+	while (p < end && IsBlank(*p))
+	{
+		p++;
+	}
+	bool parenthesized = (p < end && *p == '(');
+	if (parenthesized)
+	{
+		p++;
+	}
+
+	for (int c = 0; c < dimension; c++)
+	{
+		// Components are separated by a comma, whitespace, or both.
+		while (p < end && (IsBlank(*p) || (c > 0 && *p == ',')))
+		{
+			p++;
+		}
+		// from_chars does not accept a leading '+', but operator<< never writes one anyway.
+		if (p < end && *p == '+')
+		{
+			p++;
+		}
+		std::from_chars_result result = std::from_chars(p, end, components[c]);
+		if (result.ec != std::errc())
+		{
+			return false;
+		}
+		p = result.ptr;
+	}
+
+	while (p < end && IsBlank(*p))
+	{
+		p++;
+	}
+	if (parenthesized)
+	{
+		if (p == end || *p != ')')
+		{
+			return false;
+		}
+		p++;
+		while (p < end && IsBlank(*p))
+		{
+			p++;
+		}
+	}
+	return p == end;
+}
+
+size_t CountVectorLines(const char* text, size_t size)
+{
+	size_t count = 0;
+	const char* end = text + size;
+	for (const char* p = text; p < end;)
+	{
+		const char* lineEnd = FindLineEnd(p, end);
+		if (!IsBlankLine(p, lineEnd))
+		{
+			count++;
+		}
+		p = lineEnd + 1;
+	}
+	return count;
+}
+
+// Parses [text, text + size) into out, which is an AoS array of dimension floats per vector.
+// firstLine is the line number of the first line in text, for error reporting.
+static ParseResult ParseChunk(const char* text, size_t size, float* out, size_t capacity, int dimension, size_t firstLine)
+{
+	ParseResult result = { true, 0, 0 };
+	const char* end = text + size;
+	size_t line = firstLine;
+	for (const char* p = text; p < end; line++)
+	{
+		const char* lineEnd = FindLineEnd(p, end);
+		if (!IsBlankLine(p, lineEnd))
+		{
+			if (result.count == capacity || !ParseLine(p, lineEnd, out + result.count * dimension, dimension))
+			{
+				result.ok = false;
+				result.errorLine = line;
+				return result;
+			}
+			result.count++;
+		}
+		p = lineEnd + 1;
+	}
+	return result;
+}
+
+static ParseResult ParseParallel(const char* text, size_t size, float* out, size_t capacity, int dimension, unsigned threads)
+{
+	if (threads == 0)
+	{
+		threads = std::thread::hardware_concurrency();
+	}
+	// Below a few megabytes, starting threads costs more than it saves.
+	const size_t minChunk = 1 << 22;
+	if (threads > size / minChunk)
+	{
+		threads = static_cast<unsigned>(size / minChunk);
+	}
+	if (threads <= 1)
+	{
+		return ParseChunk(text, size, out, capacity, dimension, 1);
+	}
+
+	// Split into roughly equal chunks, moving each boundary forward to the next line start.
+	std::vector<size_t> bounds(threads + 1);
+	bounds[0] = 0;
+	bounds[threads] = size;
+	for (unsigned t = 1; t < threads; t++)
+	{
+		size_t b = size / threads * t;
+		if (b < bounds[t - 1])
+		{
+			b = bounds[t - 1];
+		}
+		const char* newline = static_cast<const char*>(memchr(text + b, '\n', size - b));
+		bounds[t] = newline ? (newline - text) + 1 : size;
+	}
+
+	// First pass: count vectors and lines per chunk, so every chunk knows where its output
+	//  and its line numbers start without any thread having to wait on another.
+	std::vector<size_t> vectors(threads), lines(threads);
+	std::vector<std::thread> workers;
+	for (unsigned t = 0; t < threads; t++)
+	{
+		workers.emplace_back([&, t]
+		{
+			const char* end = text + bounds[t + 1];
+			size_t v = 0, l = 0;
+			for (const char* p = text + bounds[t]; p < end; l++)
+			{
+				const char* lineEnd = FindLineEnd(p, end);
+				if (!IsBlankLine(p, lineEnd))
+				{
+					v++;
+				}
+				p = lineEnd + 1;
+			}
+			vectors[t] = v;
+			lines[t] = l;
+		});
+	}
+	for (std::thread& w : workers)
+	{
+		w.join();
+	}
+	workers.clear();
+
+	std::vector<size_t> firstVector(threads), firstLine(threads);
+	size_t totalVectors = 0, totalLines = 0;
+	for (unsigned t = 0; t < threads; t++)
+	{
+		firstVector[t] = totalVectors;
+		firstLine[t] = totalLines + 1;
+		totalVectors += vectors[t];
+		totalLines += lines[t];
+	}
+
+	// Second pass: parse every chunk straight into its slice of the output.
+	std::vector<ParseResult> results(threads);
+	for (unsigned t = 0; t < threads; t++)
+	{
+		workers.emplace_back([&, t]
+		{
+			size_t room = capacity > firstVector[t] ? capacity - firstVector[t] : 0;
+			results[t] = ParseChunk(text + bounds[t], bounds[t + 1] - bounds[t], out + firstVector[t] * dimension,
+				room < vectors[t] ? room : vectors[t], dimension, firstLine[t]);
+		});
+	}
+	for (std::thread& w : workers)
+	{
+		w.join();
+	}
+
+	ParseResult result = { true, 0, 0 };
+	for (unsigned t = 0; t < threads; t++)
+	{
+		result.count += results[t].count;
+		if (!results[t].ok)
+		{
+			result.ok = false;
+			result.errorLine = results[t].errorLine;
+			break;
+		}
+	}
+	return result;
+}
+
+ParseResult ParseVectors(const char* text, size_t size, Vector2D* out, size_t capacity)
+{
+	return ParseChunk(text, size, &out->x, capacity, 2, 1);
+}
+
+ParseResult ParseVectors(const char* text, size_t size, Vector3D* out, size_t capacity)
+{
+	return ParseChunk(text, size, &out->x, capacity, 3, 1);
+}
+
+ParseResult ParseVectors(const char* text, size_t size, Vector4D* out, size_t capacity)
+{
+	return ParseChunk(text, size, &out->x, capacity, 4, 1);
+}
+
+ParseResult ParseVectorsParallel(const char* text, size_t size, Vector2D* out, size_t capacity, unsigned threads)
+{
+	return ParseParallel(text, size, &out->x, capacity, 2, threads);
+}
+
+ParseResult ParseVectorsParallel(const char* text, size_t size, Vector3D* out, size_t capacity, unsigned threads)
+{
+	return ParseParallel(text, size, &out->x, capacity, 3, threads);
+}
+
+ParseResult ParseVectorsParallel(const char* text, size_t size, Vector4D* out, size_t capacity, unsigned threads)
+{
+	return ParseParallel(text, size, &out->x, capacity, 4, threads);
+}
@@ -0,0 +1,716 @@
+/*
+Title: Vector Mathematics
+File Name: VectorService.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/VectorService.h"
+
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "../header/VectorBatch.h"
+
+void PrintServiceStats(FILE* out, const ServiceStats& stats)
+{
+	fprintf(out, "uptime          %.3f s\n", stats.uptimeNanoseconds * 1e-9);
+	fprintf(out, "clients         %llu\n", static_cast<unsigned long long>(stats.clients));
+	fprintf(out, "requests        %llu\n", static_cast<unsigned long long>(stats.requests));
+	fprintf(out, "vectors         %llu\n", static_cast<unsigned long long>(stats.vectors));
+	fprintf(out, "errors          %llu\n", static_cast<unsigned long long>(stats.errors));
+	fprintf(out, "batches         %llu\n", static_cast<unsigned long long>(stats.batches));
+	if (stats.requests > 0)
+	{
+		fprintf(out, "requests/batch  %.2f\n", stats.batches ? static_cast<double>(stats.requests) / stats.batches : 0.0);
+		fprintf(out, "mean latency    %.3f us\n", stats.totalLatencyNanoseconds * 1e-3 / stats.requests);
+		fprintf(out, "max latency     %.3f us\n", stats.maxLatencyNanoseconds * 1e-3);
+	}
+	if (stats.uptimeNanoseconds > 0)
+	{
+		fprintf(out, "throughput      %.3f Mvectors/s\n", stats.vectors * 1e3 / stats.uptimeNanoseconds);
+	}
+}
+
+#ifdef __linux__
+
+static uint64_t NowNanoseconds()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Vectors per unit of work handed to a thread; requests larger than this are split, smaller ones are grouped.
+static const size_t GRAIN = 1 << 16;
+
+// Messages read from one client per poll, so one busy client cannot starve the others.
+static const int MAX_READS_PER_POLL = 256;
+
+static const size_t MAX_CLIENTS = 1024;
+
+struct ServiceClient
+{
+	int socket;
+	char* shared;
+	size_t sharedSize;
+};
+
+struct PendingRequest
+{
+	size_t client;
+	ServiceRequest request;
+	ServiceStatus status;
+	uint64_t received;
+};
+
+// Checks a request against the client's memory, so kernels never touch anything outside it.
+static ServiceStatus Validate(const ServiceClient& client, const ServiceRequest& r)
+{
+	bool reads = r.op >= ServiceOp::Normalize && r.op <= ServiceOp::Transform;
+	if (r.op == ServiceOp::Stats)
+	{
+		return ServiceStatus::Ok;
+	}
+	if (!reads || r.dimension < 2 || r.dimension > 4 || (r.op == ServiceOp::Cross && r.dimension != 3))
+	{
+		return ServiceStatus::BadRequest;
+	}
+	if (!client.shared)
+	{
+		return ServiceStatus::NotAttached;
+	}
+
+	bool binary = r.op == ServiceOp::Dot || r.op == ServiceOp::Cross || r.op == ServiceOp::Project;
+	bool scalarOut = r.op == ServiceOp::Magnitude || r.op == ServiceOp::Dot;
+	uint64_t vectorBytes = r.dimension * sizeof(float);
+	uint64_t limit = client.sharedSize;
+	if (r.count > limit / vectorBytes)
+	{
+		return ServiceStatus::OutOfRange;
+	}
+	uint64_t inBytes = r.count * vectorBytes;
+	uint64_t outBytes = scalarOut ? r.count * sizeof(float) : inBytes;
+	bool ok = r.a % 4 == 0 && r.a <= limit && inBytes <= limit - r.a;
+	ok = ok && r.out % 4 == 0 && r.out <= limit && outBytes <= limit - r.out;
+	ok = ok && (!binary || (r.b % 4 == 0 && r.b <= limit && inBytes <= limit - r.b));
+	return ok ? ServiceStatus::Ok : ServiceStatus::OutOfRange;
+}
+
+// Runs vectors [begin, end) of a validated request.
+template <typename V>
+static void RunKernel(const ServiceRequest& r, char* base, size_t begin, size_t end)
+{
+	const V* a = reinterpret_cast<const V*>(base + r.a) + begin;
+	const V* b = reinterpret_cast<const V*>(base + r.b) + begin;
+	float* scalars = reinterpret_cast<float*>(base + r.out) + begin;
+	V* out = reinterpret_cast<V*>(base + r.out) + begin;
+	size_t n = end - begin;
+	switch (r.op)
+	{
+	case ServiceOp::Normalize:
+		NormalizeBatch(a, out, n);
+		break;
+	case ServiceOp::Magnitude:
+		MagnitudeBatch(a, scalars, n);
+		break;
+	case ServiceOp::Dot:
+		DotBatch(a, b, scalars, n);
+		break;
+	case ServiceOp::Cross:
+		if constexpr (std::is_same<V, Vector3D>::value)
+		{
+			CrossBatch(a, b, out, n);
+		}
+		break;
+	case ServiceOp::Project:
+		ProjectBatch(a, b, out, n);
+		break;
+	case ServiceOp::Transform:
+	{
+		V t;
+		float* components = &t.x;
+		for (size_t c = 0; c < sizeof(V) / sizeof(float); c++)
+		{
+			components[c] = r.translation[c];
+		}
+		TransformBatch(a, out, n, r.matrix, t);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+static void RunKernel(const ServiceRequest& r, char* base, size_t begin, size_t end)
+{
+	switch (r.dimension)
+	{
+	case 2:
+		RunKernel<Vector2D>(r, base, begin, end);
+		break;
+	case 3:
+		RunKernel<Vector3D>(r, base, begin, end);
+		break;
+	default:
+		RunKernel<Vector4D>(r, base, begin, end);
+		break;
+	}
+}
+
+class VectorServer
+{
+public:
+	VectorServer(const VectorServiceOptions& options, ThreadPool& pool)
+		: options(options), pool(pool), listener(-1), pendingVectors(0)
+	{
+		memset(&stats, 0, sizeof(stats));
+		started = NowNanoseconds();
+	}
+
+	~VectorServer()
+	{
+		for (size_t i = 0; i < clients.size(); i++)
+		{
+			Disconnect(i);
+		}
+		if (listener >= 0)
+		{
+			close(listener);
+			unlink(options.socketPath);
+		}
+	}
+
+	bool Listen()
+	{
+		sockaddr_un address;
+		memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		if (strlen(options.socketPath) >= sizeof(address.sun_path))
+		{
+			fprintf(stderr, "socket path is too long: %s\n", options.socketPath);
+			return false;
+		}
+		strcpy(address.sun_path, options.socketPath);
+
+		// SEQPACKET keeps message boundaries, so every recv is exactly one request.
+		listener = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+		if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 64) != 0)
+		{
+			fprintf(stderr, "could not listen on %s: %s\n", options.socketPath, strerror(errno));
+			if (listener >= 0)
+			{
+				close(listener);
+				listener = -1;
+			}
+			return false;
+		}
+		return true;
+	}
+
+	void Run(const std::atomic<bool>& stop)
+	{
+		std::vector<pollfd> fds;
+		while (!stop.load())
+		{
+			fds.clear();
+			fds.push_back(pollfd{ listener, POLLIN, 0 });
+			for (const ServiceClient& c : clients)
+			{
+				fds.push_back(pollfd{ c.socket, static_cast<short>(c.socket >= 0 ? POLLIN : 0), 0 });
+			}
+
+			// Sleep until the oldest pending request's window closes; otherwise wake now and then to check stop.
+			timespec timeout = { 0, 200 * 1000 * 1000 };
+			if (!pending.empty())
+			{
+				uint64_t deadline = pending.front().received + options.windowMicroseconds * 1000ULL;
+				uint64_t now = NowNanoseconds();
+				uint64_t wait = deadline > now ? deadline - now : 0;
+				timeout.tv_sec = static_cast<time_t>(wait / 1000000000ULL);
+				timeout.tv_nsec = static_cast<long>(wait % 1000000000ULL);
+			}
+			int ready = ppoll(fds.data(), fds.size(), &timeout, nullptr);
+			if (ready < 0 && errno != EINTR)
+			{
+				fprintf(stderr, "poll failed: %s\n", strerror(errno));
+				return;
+			}
+
+			if (ready > 0)
+			{
+				if (fds[0].revents & POLLIN)
+				{
+					Accept();
+				}
+				for (size_t i = 1; i < fds.size(); i++)
+				{
+					if (fds[i].revents)
+					{
+						Read(i - 1);
+					}
+				}
+			}
+
+			if (!pending.empty() && (pendingVectors >= options.batchVectors ||
+				NowNanoseconds() >= pending.front().received + options.windowMicroseconds * 1000ULL))
+			{
+				Dispatch();
+			}
+		}
+	}
+
+	ServiceStats Stats() const
+	{
+		ServiceStats s = stats;
+		s.uptimeNanoseconds = NowNanoseconds() - started;
+		s.clients = 0;
+		for (const ServiceClient& c : clients)
+		{
+			s.clients += c.socket >= 0 ? 1 : 0;
+		}
+		return s;
+	}
+
+private:
+	const VectorServiceOptions& options;
+	ThreadPool& pool;
+	int listener;
+	uint64_t started;
+	ServiceStats stats;
+	// Slots of disconnected clients are reused, so indices in pending stay valid.
+	std::vector<ServiceClient> clients;
+	std::vector<PendingRequest> pending;
+	size_t pendingVectors;
+
+	void Accept()
+	{
+		int s = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+		if (s < 0)
+		{
+			return;
+		}
+		// A client that stops reading its replies is dropped rather than allowed to stall everyone else.
+		timeval timeout = { 1, 0 };
+		setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+		ServiceClient client = { s, nullptr, 0 };
+		for (ServiceClient& c : clients)
+		{
+			if (c.socket < 0)
+			{
+				c = client;
+				return;
+			}
+		}
+		if (clients.size() == MAX_CLIENTS)
+		{
+			close(s);
+			return;
+		}
+		clients.push_back(client);
+	}
+
+	void Disconnect(size_t index)
+	{
+		ServiceClient& c = clients[index];
+		if (c.socket < 0)
+		{
+			return;
+		}
+		// Requests still waiting would otherwise run on memory that is about to be unmapped.
+		size_t kept = 0;
+		for (size_t i = 0; i < pending.size(); i++)
+		{
+			if (pending[i].client != index)
+			{
+				pending[kept++] = pending[i];
+			}
+			else if (pending[i].status == ServiceStatus::Ok)
+			{
+				pendingVectors -= static_cast<size_t>(pending[i].request.count);
+			}
+		}
+		pending.resize(kept);
+		if (c.shared)
+		{
+			munmap(c.shared, c.sharedSize);
+		}
+		close(c.socket);
+		c = ServiceClient{ -1, nullptr, 0 };
+	}
+
+	// Maps the memory file received with an Attach request.
+	// The file must be sealed against shrinking, or the client could truncate it mid-request and crash the server.
+	bool Attach(ServiceClient& c, int fd)
+	{
+		struct stat st;
+		int seals = fcntl(fd, F_GET_SEALS);
+		if (c.shared || seals < 0 || !(seals & F_SEAL_SHRINK) || fstat(fd, &st) != 0 || st.st_size <= 0)
+		{
+			return false;
+		}
+		void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (p == MAP_FAILED)
+		{
+			return false;
+		}
+		c.shared = static_cast<char*>(p);
+		c.sharedSize = static_cast<size_t>(st.st_size);
+		return true;
+	}
+
+	void Read(size_t index)
+	{
+		for (int n = 0; n < MAX_READS_PER_POLL && clients[index].socket >= 0; n++)
+		{
+			ServiceRequest request;
+			alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+			iovec io = { &request, sizeof(request) };
+			msghdr message;
+			memset(&message, 0, sizeof(message));
+			message.msg_iov = &io;
+			message.msg_iovlen = 1;
+			message.msg_control = control;
+			message.msg_controllen = sizeof(control);
+
+			ssize_t got = recvmsg(clients[index].socket, &message, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+			if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+			{
+				return;
+			}
+			int fd = -1;
+			cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+			if (got > 0 && cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+			{
+				memcpy(&fd, CMSG_DATA(cmsg), sizeof(fd));
+			}
+			if (got != static_cast<ssize_t>(sizeof(request)))
+			{
+				if (fd >= 0)
+				{
+					close(fd);
+				}
+				Disconnect(index);
+				return;
+			}
+
+			PendingRequest p = { index, request, ServiceStatus::Ok, NowNanoseconds() };
+			if (request.op == ServiceOp::Attach)
+			{
+				p.status = fd >= 0 && Attach(clients[index], fd) ? ServiceStatus::Ok : ServiceStatus::BadRequest;
+			}
+			else
+			{
+				p.status = Validate(clients[index], request);
+			}
+			if (fd >= 0)
+			{
+				close(fd);
+			}
+			if (p.status == ServiceStatus::Ok && request.op != ServiceOp::Attach && request.op != ServiceOp::Stats)
+			{
+				pendingVectors += static_cast<size_t>(request.count);
+			}
+			// Everything, even failures, goes through pending so replies keep the order of requests.
+			pending.push_back(p);
+		}
+	}
+
+	// Runs every pending request as one parallel dispatch, then replies to each.
+	void Dispatch()
+	{
+		// Work items of roughly GRAIN vectors each: big requests are split, small ones grouped.
+		struct Segment
+		{
+			size_t request;
+			size_t begin;
+			size_t end;
+		};
+		std::vector<Segment> segments;
+		std::vector<size_t> items;
+		size_t itemVectors = 0;
+		for (size_t r = 0; r < pending.size(); r++)
+		{
+			const PendingRequest& p = pending[r];
+			if (p.status != ServiceStatus::Ok || p.request.op == ServiceOp::Attach || p.request.op == ServiceOp::Stats)
+			{
+				continue;
+			}
+			size_t count = static_cast<size_t>(p.request.count);
+			for (size_t begin = 0; begin < count; begin += GRAIN)
+			{
+				if (itemVectors == 0)
+				{
+					items.push_back(segments.size());
+				}
+				size_t end = count - begin < GRAIN ? count : begin + GRAIN;
+				segments.push_back(Segment{ r, begin, end });
+				itemVectors += end - begin;
+				if (itemVectors >= GRAIN)
+				{
+					itemVectors = 0;
+				}
+			}
+		}
+		items.push_back(segments.size());
+
+		if (!segments.empty())
+		{
+			pool.ParallelFor(items.size() - 1, 1, [&](size_t first, size_t last)
+			{
+				for (size_t item = first; item < last; item++)
+				{
+					for (size_t s = items[item]; s < items[item + 1]; s++)
+					{
+						const PendingRequest& p = pending[segments[s].request];
+						RunKernel(p.request, clients[p.client].shared, segments[s].begin, segments[s].end);
+					}
+				}
+			});
+			stats.batches++;
+		}
+
+		std::vector<PendingRequest> done;
+		done.swap(pending);
+		pendingVectors = 0;
+		for (const PendingRequest& p : done)
+		{
+			if (clients[p.client].socket < 0)
+			{
+				continue;
+			}
+			ServiceReply reply;
+			memset(&reply, 0, sizeof(reply));
+			reply.id = p.request.id;
+			reply.status = p.status;
+			if (p.request.op != ServiceOp::Attach)
+			{
+				uint64_t latency = NowNanoseconds() - p.received;
+				stats.requests++;
+				stats.errors += p.status == ServiceStatus::Ok ? 0 : 1;
+				stats.vectors += p.status == ServiceStatus::Ok && p.request.op != ServiceOp::Stats ? p.request.count : 0;
+				stats.totalLatencyNanoseconds += latency;
+				stats.maxLatencyNanoseconds = latency > stats.maxLatencyNanoseconds ? latency : stats.maxLatencyNanoseconds;
+			}
+			if (p.request.op == ServiceOp::Stats)
+			{
+				reply.stats = Stats();
+			}
+			if (send(clients[p.client].socket, &reply, sizeof(reply), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(reply)))
+			{
+				Disconnect(p.client);
+			}
+		}
+	}
+};
+
+bool RunVectorService(const VectorServiceOptions& options, ThreadPool& pool, const std::atomic<bool>& stop, ServiceStats& finalStats)
+{
+	VectorServer server(options, pool);
+	if (!server.Listen())
+	{
+		return false;
+	}
+	server.Run(stop);
+	finalStats = server.Stats();
+	return true;
+}
+
+VectorServiceClient::VectorServiceClient()
+	: socket(-1), shared(nullptr), sharedSize(0)
+{
+}
+
+VectorServiceClient::~VectorServiceClient()
+{
+	Close();
+}
+
+bool VectorServiceClient::Connect(const char* socketPath, size_t sharedBytes)
+{
+	Close();
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (strlen(socketPath) >= sizeof(address.sun_path) || sharedBytes == 0)
+	{
+		return false;
+	}
+	strcpy(address.sun_path, socketPath);
+	socket = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (socket < 0 || connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	// The size is sealed so the server can trust it for as long as it keeps the mapping.
+	int fd = memfd_create("vector-service", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	bool ok = fd >= 0 && ftruncate(fd, static_cast<off_t>(sharedBytes)) == 0 &&
+		fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == 0;
+	void* p = ok ? mmap(nullptr, sharedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+	if (p == MAP_FAILED)
+	{
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		Close();
+		return false;
+	}
+	shared = static_cast<char*>(p);
+	sharedSize = sharedBytes;
+
+	ServiceRequest request;
+	memset(&request, 0, sizeof(request));
+	request.op = ServiceOp::Attach;
+	alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+	memset(control, 0, sizeof(control));
+	iovec io = { &request, sizeof(request) };
+	msghdr message;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &io;
+	message.msg_iovlen = 1;
+	message.msg_control = control;
+	message.msg_controllen = sizeof(control);
+	cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(cmsg), &fd, sizeof(fd));
+	ok = sendmsg(socket, &message, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(request));
+	close(fd);
+
+	ServiceReply reply;
+	if (!ok || !Receive(reply) || reply.status != ServiceStatus::Ok)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void VectorServiceClient::Close()
+{
+	if (shared)
+	{
+		munmap(shared, sharedSize);
+		shared = nullptr;
+		sharedSize = 0;
+	}
+	if (socket >= 0)
+	{
+		close(socket);
+		socket = -1;
+	}
+}
+
+bool VectorServiceClient::Submit(const ServiceRequest& request)
+{
+	return socket >= 0 && send(socket, &request, sizeof(request), MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(request));
+}
+
+bool VectorServiceClient::Receive(ServiceReply& reply)
+{
+	for (;;)
+	{
+		ssize_t got = socket >= 0 ? recv(socket, &reply, sizeof(reply), 0) : -1;
+		if (got < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		return got == static_cast<ssize_t>(sizeof(reply));
+	}
+}
+
+#else
+
+bool RunVectorService(const VectorServiceOptions&, ThreadPool&, const std::atomic<bool>&, ServiceStats&)
+{
+	fprintf(stderr, "the vector service is only available on Linux\n");
+	return false;
+}
+
+VectorServiceClient::VectorServiceClient()
+	: socket(-1), shared(nullptr), sharedSize(0)
+{
+}
+
+VectorServiceClient::~VectorServiceClient()
+{
+}
+
+bool VectorServiceClient::Connect(const char*, size_t)
+{
+	return false;
+}
+
+void VectorServiceClient::Close()
+{
+}
+
+bool VectorServiceClient::Submit(const ServiceRequest&)
+{
+	return false;
+}
+
+bool VectorServiceClient::Receive(ServiceReply&)
+{
+	return false;
+}
+
+#endif
+
+char* VectorServiceClient::Shared() const
+{
+	return shared;
+}
+
+size_t VectorServiceClient::SharedSize() const
+{
+	return sharedSize;
+}
+
+bool VectorServiceClient::Call(const ServiceRequest& request, ServiceReply& reply)
+{
+	return Submit(request) && Receive(reply);
+}
+
+bool VectorServiceClient::QueryStats(ServiceStats& stats)
+{
+	ServiceRequest request;
+	memset(&request, 0, sizeof(request));
+	request.op = ServiceOp::Stats;
+	ServiceReply reply;
+	if (!Call(request, reply) || reply.status != ServiceStatus::Ok)
+	{
+		return false;
+	}
+	stats = reply.stats;
+	return true;
+}
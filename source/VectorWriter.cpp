@@ -0,0 +1,312 @@
+/*
+Title: Vector Mathematics
+File Name: VectorWriter.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/VectorWriter.h"
+
+#include <charconv>
+#include <cstring>
+
+// Precision is clamped so that any component fits in MAX_NUMBER_TEXT. General never needs more than
+//  17 digits, the most even a double needs to read back exactly. Fixed at 45 digits already shows the
+//  smallest float denormal.
+static const int MAX_GENERAL_PRECISION = 17;
+static const int MAX_FIXED_PRECISION = 45;
+// Sign, 39 integer digits of FLT_MAX, point, and MAX_FIXED_PRECISION digits.
+static const size_t MAX_NUMBER_TEXT = 1 + 39 + 1 + MAX_FIXED_PRECISION;
+
+// Half the room reserved for one vector: four components of MAX_NUMBER_TEXT plus the punctuation
+//  come to well under twice this.
+static const size_t MAX_VECTOR_TEXT = 256;
+static_assert(4 * MAX_NUMBER_TEXT + 9 <= MAX_VECTOR_TEXT * 2, "a vector must fit in the room reserved for it");
+
+static int ClampPrecision(NumberFormat format, int precision)
+{
+	int most = format == NumberFormat::Fixed ? MAX_FIXED_PRECISION : MAX_GENERAL_PRECISION;
+	return precision < 0 ? 0 : precision > most ? most : precision;
+}
+
+VectorWriter::VectorWriter(FILE* out, size_t bufferSize, bool background)
+	: out(out), format(NumberFormat::Shortest), precision(6),
+	bufferSize(bufferSize < MAX_VECTOR_TEXT * 4 ? MAX_VECTOR_TEXT * 4 : bufferSize),
+	used(0), failed(false), background(background), pendingSize(0), hasPending(false), stopping(false)
+{
+	buffer.resize(this->bufferSize);
+	if (background)
+	{
+		pending.resize(this->bufferSize);
+		worker = std::thread(&VectorWriter::WorkerLoop, this);
+	}
+}
+
+VectorWriter::~VectorWriter()
+{
+	Flush();
+	if (background)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		cv.notify_all();
+		worker.join();
+	}
+}
+
+void VectorWriter::SetFormat(NumberFormat format, int precision)
+{
+	this->format = format;
+	this->precision = ClampPrecision(format, precision);
+}
+
+static char* FormatNumber(char* first, char* last, float value, NumberFormat format, int precision)
+{
+	std::to_chars_result result;
+	switch (format)
+	{
+	case NumberFormat::General:
+		result = std::to_chars(first, last, value, std::chars_format::general, precision);
+		break;
+	case NumberFormat::Fixed:
+		result = std::to_chars(first, last, value, std::chars_format::fixed, precision);
+		break;
+	default:
+		result = std::to_chars(first, last, value);
+		break;
+	}
+	if (result.ec != std::errc())
+	{
+		// Only happens for huge values in Fixed format; fall back to something that always fits.
+		result = std::to_chars(first, last, value);
+	}
+	return result.ptr;
+}
+
+// Formats one vector and its newline at p, which must have MAX_VECTOR_TEXT * 2 bytes before end.
+// precision must already be clamped, so that every component fits.
+static char* FormatVector(char* p, char* end, const float* components, int dimension, NumberFormat format, int precision)
+{
+	*p++ = '(';
+	for (int c = 0; c < dimension; c++)
+	{
+		if (c > 0)
+		{
+			*p++ = ',';
+			*p++ = ' ';
+		}
+		p = FormatNumber(p, end, components[c], format, precision);
+	}
+	*p++ = ')';
+	*p++ = '\n';
+	return p;
+}
+
+void VectorWriter::WriteVector(const float* components, int dimension)
+{
+	Reserve(MAX_VECTOR_TEXT * 2);
+	char* p = buffer.data() + used;
+	p = FormatVector(p, buffer.data() + bufferSize, components, dimension, format, precision);
+	used = p - buffer.data();
+}
+
+template <typename V>
+static void AppendVectors(std::vector<char>& text, const V* v, size_t count, int dimension, NumberFormat format, int precision)
+{
+	size_t used = text.size();
+	precision = ClampPrecision(format, precision);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (text.size() - used < MAX_VECTOR_TEXT * 2)
+		{
+			text.resize(text.size() + (count - i) * MAX_VECTOR_TEXT / 4 + MAX_VECTOR_TEXT * 2);
+		}
+		char* p = text.data() + used;
+		used = FormatVector(p, text.data() + text.size(), &v[i].x, dimension, format, precision) - text.data();
+	}
+	text.resize(used);
+}
+
+void AppendVectorText(std::vector<char>& text, const Vector2D* v, size_t count, NumberFormat format, int precision)
+{
+	AppendVectors(text, v, count, 2, format, precision);
+}
+
+void AppendVectorText(std::vector<char>& text, const Vector3D* v, size_t count, NumberFormat format, int precision)
+{
+	AppendVectors(text, v, count, 3, format, precision);
+}
+
+void AppendVectorText(std::vector<char>& text, const Vector4D* v, size_t count, NumberFormat format, int precision)
+{
+	AppendVectors(text, v, count, 4, format, precision);
+}
+
+void VectorWriter::Write(Vector2D v)
+{
+	WriteVector(&v.x, 2);
+}
+
+void VectorWriter::Write(Vector3D v)
+{
+	WriteVector(&v.x, 3);
+}
+
+void VectorWriter::Write(Vector4D v)
+{
+	WriteVector(&v.x, 4);
+}
+
+void VectorWriter::Write(const Vector2D* v, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		WriteVector(&v[i].x, 2);
+	}
+}
+
+void VectorWriter::Write(const Vector3D* v, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		WriteVector(&v[i].x, 3);
+	}
+}
+
+void VectorWriter::Write(const Vector4D* v, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		WriteVector(&v[i].x, 4);
+	}
+}
+
+void VectorWriter::WriteText(const char* text, size_t length)
+{
+	while (length > 0)
+	{
+		if (used == bufferSize)
+		{
+			Submit();
+		}
+		size_t n = bufferSize - used < length ? bufferSize - used : length;
+		memcpy(buffer.data() + used, text, n);
+		used += n;
+		text += n;
+		length -= n;
+	}
+}
+
+void VectorWriter::WriteText(const char* text)
+{
+	WriteText(text, strlen(text));
+}
+
+void VectorWriter::WriteScalar(float s)
+{
+	Reserve(MAX_VECTOR_TEXT);
+	char* p = FormatNumber(buffer.data() + used, buffer.data() + bufferSize, s, format, precision);
+	*p++ = '\n';
+	used = p - buffer.data();
+}
+
+void VectorWriter::Reserve(size_t bytes)
+{
+	if (bufferSize - used < bytes)
+	{
+		Submit();
+	}
+}
+
+// Hands the current buffer to the output, either directly or through the worker thread.
+void VectorWriter::Submit()
+{
+	if (used == 0)
+	{
+		return;
+	}
+	if (!background)
+	{
+		if (!failed && fwrite(buffer.data(), 1, used, out) != used)
+		{
+			failed = true;
+		}
+		used = 0;
+		return;
+	}
+
+	// Wait for the previous block to finish, then swap buffers so formatting can carry on
+	//  while the worker writes this one.
+	std::unique_lock<std::mutex> lock(mutex);
+	cv.wait(lock, [this] { return !hasPending; });
+	buffer.swap(pending);
+	pendingSize = used;
+	hasPending = true;
+	used = 0;
+	lock.unlock();
+	cv.notify_all();
+}
+
+void VectorWriter::WaitForWorker()
+{
+	if (background)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, [this] { return !hasPending; });
+	}
+}
+
+void VectorWriter::WorkerLoop()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;)
+	{
+		cv.wait(lock, [this] { return hasPending || stopping; });
+		if (!hasPending)
+		{
+			return;
+		}
+
+		// Write without holding the lock; the formatting thread never touches pending meanwhile.
+		lock.unlock();
+		bool ok = fwrite(pending.data(), 1, pendingSize, out) == pendingSize;
+		lock.lock();
+		if (!ok)
+		{
+			failed = true;
+		}
+		hasPending = false;
+		cv.notify_all();
+	}
+}
+
+bool VectorWriter::Flush()
+{
+	Submit();
+	WaitForWorker();
+	if (fflush(out) != 0)
+	{
+		failed = true;
+	}
+	return Good();
+}
+
+bool VectorWriter::Good() const
+{
+	return !failed;
+}
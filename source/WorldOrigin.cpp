@@ -0,0 +1,82 @@
+/*
+Title: Vector Mathematics
+File Name: WorldOrigin.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "../header/WorldOrigin.h"
+
+Vector3D ToLocal(DVector3D world, DVector3D origin)
+{
+	return ToFloat(world - origin);
+}
+
+DVector3D ToWorld(Vector3D local, DVector3D origin)
+{
+	return ToDouble(local) + origin;
+}
+
+// The loops are written out component by component so the compiler can vectorize the
+//  subtraction and the double-to-float conversion.
+void ToLocalBatch(const DVector3D* world, size_t count, DVector3D origin, Vector3D* out)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i].x = static_cast<float>(world[i].x - origin.x);
+		out[i].y = static_cast<float>(world[i].y - origin.y);
+		out[i].z = static_cast<float>(world[i].z - origin.z);
+	}
+}
+
+void ToWorldBatch(const Vector3D* local, size_t count, DVector3D origin, DVector3D* out)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i].x = local[i].x + origin.x;
+		out[i].y = local[i].y + origin.y;
+		out[i].z = local[i].z + origin.z;
+	}
+}
+
+void RebaseBatch(Vector3D* local, size_t count, Vector3D shift)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		local[i].x -= shift.x;
+		local[i].y -= shift.y;
+		local[i].z -= shift.z;
+	}
+}
+
+WorldOrigin::WorldOrigin(double rebaseDistance)
+	: rebaseDistance(rebaseDistance)
+{
+}
+
+bool WorldOrigin::Update(DVector3D focus, Vector3D& shift)
+{
+	DVector3D offset = focus - origin;
+	if (MagSquared(offset) <= rebaseDistance * rebaseDistance)
+	{
+		return false;
+	}
+
+	DVector3D newOrigin(floor(focus.x + 0.5), floor(focus.y + 0.5), floor(focus.z + 0.5));
+	shift = ToFloat(newOrigin - origin);
+	origin = newOrigin;
+	return true;
+}
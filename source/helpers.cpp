@@ -19,9 +19,11 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "../header/helpers.h"
+#include "../header/Probes.h"
 
 float FastInvSqrt(float x)
 {
+	VECTOR_PROBE("FastInvSqrt(float)");
 	// Code taken from Quake III Arena, public domain
 
 	// This code is a great bit of history and trivia in the games industry.
@@ -48,11 +50,13 @@ float FastInvSqrt(float x)
 // Returns a random real number in the interval [min, max] (inclusive on both ends)
 float randFloat(float min, float max)
 {
+	VECTOR_PROBE("randFloat(float, float)");
 	return min + (((float)rand()) / ((float)RAND_MAX)) * (max - min);
 }
 
 // Returns a random integer in the range { min, ..., max } (inclusive on both ends)
 int randInt(int min, int max)
 {
+	VECTOR_PROBE("randInt(int, int)");
 	return min + (rand() % (max - min + 1));
 }
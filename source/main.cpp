@@ -34,6 +34,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // This tutorial explains the basics of what a vector is and what operations we can use on vectors.
 // In the next tutorial, we will discuss the lengths of vectors, and ways to "multiply" vectors, as well as geometric considerations.
 
+#include "../header/CommandLine.h"
 #include "../header/helpers.h"
 #include "../header/Vector2D.h"
 #include "../header/Vector3D.h"
@@ -43,8 +44,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <cstdlib>
 #include <ctime>
 
-int main()
+int main(int argc, char* argv[])
 {
+	// Given any arguments, the program is a batch processor instead; see CommandLine.h.
+	// Without them it runs the tutorial below.
+	if (argc > 1)
+	{
+		return RunCommandLine(argc, argv);
+	}
+
 	// Required for the random functions in helpers to work.
 	srand(static_cast<unsigned>(time(0)));
 
@@ -0,0 +1,135 @@
+/*
+Title: Vector Mathematics
+File Name: SnapshotCodecTest.cpp
+Copyright © 2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "../header/SnapshotCodec.h"
+
+// Regression checks for SnapshotReader: a good stream decodes exactly, and truncated or forged
+//  frames return false instead of crashing or allocating without bound.
+
+static int failures = 0;
+
+static void Check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		fprintf(stderr, "FAILED: %s\n", what);
+		failures++;
+	}
+}
+
+static void PutVarint(std::vector<uint8_t>& out, uint64_t v)
+{
+	while (v >= 0x80)
+	{
+		out.push_back(static_cast<uint8_t>(v | 0x80));
+		v >>= 7;
+	}
+	out.push_back(static_cast<uint8_t>(v));
+}
+
+// A keyframe header claiming count vectors, followed by a single zero run of runLength bytes.
+static FILE* ForgedFrame(uint64_t count, uint64_t runLength)
+{
+	std::vector<uint8_t> encoded;
+	encoded.push_back(0);
+	PutVarint(encoded, runLength);
+
+	SnapshotFrameHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "VSNP", 4);
+	header.flags = SNAPSHOT_KEYFRAME;
+	header.count = count;
+	header.encodedSize = encoded.size();
+
+	FILE* f = tmpfile();
+	fwrite(&header, sizeof(header), 1, f);
+	fwrite(encoded.data(), 1, encoded.size(), f);
+	rewind(f);
+	return f;
+}
+
+static bool ReadsFrame(FILE* f)
+{
+	SnapshotReader reader(f);
+	std::vector<Vector3D> frame;
+	bool ok = reader.ReadFrame(frame);
+	fclose(f);
+	return ok;
+}
+
+int main()
+{
+	std::vector<Vector3D> vectors(1000);
+	for (size_t i = 0; i < vectors.size(); i++)
+	{
+		vectors[i] = Vector3D(i * 0.5f, -1.0f, i * 0.25f);
+	}
+
+	// Three frames, the later two deltas, read back exactly.
+	FILE* f = tmpfile();
+	SnapshotWriter writer(f, 64);
+	for (int frame = 0; frame < 3; frame++)
+	{
+		vectors[frame].y += 1.0f;
+		Check(writer.WriteFrame(vectors.data(), vectors.size()), "write frame");
+	}
+	long size = ftell(f);
+	rewind(f);
+	SnapshotReader reader(f);
+	std::vector<Vector3D> frame;
+	for (int i = 0; i < 3; i++)
+	{
+		Check(reader.ReadFrame(frame), "read frame");
+	}
+	Check(frame.size() == vectors.size() && memcmp(frame.data(), vectors.data(), vectors.size() * sizeof(Vector3D)) == 0, "frames round trip");
+	Check(!reader.ReadFrame(frame), "end of stream");
+
+	// The same stream cut short in the last frame's data.
+	rewind(f);
+	std::vector<uint8_t> bytes(static_cast<size_t>(size));
+	Check(fread(bytes.data(), 1, bytes.size(), f) == bytes.size(), "read stream back");
+	fclose(f);
+	FILE* truncated = tmpfile();
+	fwrite(bytes.data(), 1, bytes.size() - 3, truncated);
+	rewind(truncated);
+	SnapshotReader truncatedReader(truncated);
+	Check(truncatedReader.ReadFrame(frame) && truncatedReader.ReadFrame(frame), "frames before the cut");
+	Check(!truncatedReader.ReadFrame(frame), "truncated frame");
+	fclose(truncated);
+
+	// A few bytes claiming 2^38 vectors, all zero.
+	Check(!ReadsFrame(ForgedFrame(uint64_t(1) << 38, (uint64_t(1) << 38) * 12)), "forged huge count");
+	// A small count with a zero run far longer than its planes.
+	Check(!ReadsFrame(ForgedFrame(10, uint64_t(1) << 60)), "forged zero run");
+	// A count just over the limit.
+	Check(!ReadsFrame(ForgedFrame(SNAPSHOT_MAX_VECTORS + 1, (SNAPSHOT_MAX_VECTORS + 1) * 12)), "count over the limit");
+	// A well-formed forged frame within the limit still decodes.
+	Check(ReadsFrame(ForgedFrame(10, 120)), "small zero frame");
+
+	if (failures == 0)
+	{
+		printf("snapshot codec: all checks passed\n");
+	}
+	return failures == 0 ? 0 : 1;
+}